@@ -0,0 +1,768 @@
+// This file is part of ArboristBench.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file bench.cc
+
+   @brief Standalone driver timing the core's training and prediction
+   entries over synthetic data, free of any interpreter.
+
+   @author Mark Seligman
+ */
+
+#include "rowrank.h"
+#include "predblock.h"
+#include "context.h"
+#include "train.h"
+#include "predict.h"
+#include "forest.h"
+#include "leaf.h"
+#include "trainstat.h"
+#include "forestfile.h"
+#include "forestcode.h"
+#include "scorer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+   @brief Shape and training parameters, as read from the command line.
+ */
+class BenchSpec {
+ public:
+  unsigned int nRow;
+  unsigned int nPredNum;
+  unsigned int nPredFac;
+  unsigned int card; // Cardinality of each factor predictor.
+  unsigned int nTree;
+  unsigned int ctgWidth; // Cardinality of the categorical response.
+  unsigned int reps; // Repetitions of each timed phase.
+  unsigned int trainBlock;
+  unsigned int seed;
+  bool treeConcurrent;
+  bool rle; // Numeric prediction values run-length encoded.
+  bool chunkCheck; // Retrains serially to check divided restaging.
+  unsigned int binMax; // Histogram splitting of the regression job iff positive.
+  unsigned int levels; // Tree depth limit iff positive.
+  std::string spillDir; // Spill-file directory iff nonempty.
+  std::string modelPath; // Binary image prefix iff nonempty.
+  std::string codePath; // Generated source prefix iff nonempty.
+
+  BenchSpec() : nRow(10000), nPredNum(16), nPredFac(0), card(8), nTree(100), ctgWidth(2), reps(3), trainBlock(20), seed(17), treeConcurrent(false), rle(false), chunkCheck(false), binMax(0), levels(0) {}
+
+  bool Parse(int argc, char *argv[]);
+
+  inline unsigned int NPred() const {
+    return nPredNum + nPredFac;
+  }
+};
+
+
+/**
+   @brief Reads command-line options of the form "--name value".
+
+   @return true iff all options recognized.
+ */
+bool BenchSpec::Parse(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    std::string opt(argv[i]);
+    if (opt == "--concurrent") {
+      treeConcurrent = true;
+      continue;
+    }
+    if (opt == "--rle") {
+      rle = true;
+      continue;
+    }
+    if (opt == "--chunkcheck") {
+      chunkCheck = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+      return false;
+    if (opt == "--spill") {
+      spillDir = argv[++i];
+      continue;
+    }
+    if (opt == "--model") {
+      modelPath = argv[++i];
+      continue;
+    }
+    if (opt == "--codegen") {
+      codePath = argv[++i];
+      continue;
+    }
+    unsigned int val = std::strtoul(argv[++i], 0, 10);
+    if (opt == "--rows")
+      nRow = val;
+    else if (opt == "--num")
+      nPredNum = val;
+    else if (opt == "--fac")
+      nPredFac = val;
+    else if (opt == "--card")
+      card = val;
+    else if (opt == "--trees")
+      nTree = val;
+    else if (opt == "--ctg")
+      ctgWidth = val;
+    else if (opt == "--reps")
+      reps = val;
+    else if (opt == "--block")
+      trainBlock = val;
+    else if (opt == "--seed")
+      seed = val;
+    else if (opt == "--bins")
+      binMax = val;
+    else if (opt == "--levels")
+      levels = val;
+    else
+      return false;
+  }
+
+  return nRow > 0 && NPred() > 0 && nTree > 0 && ctgWidth > 1 && reps > 0 && trainBlock > 0 && (nPredFac == 0 || card > 1);
+}
+
+
+/**
+   @brief Synthetic observations, in both the column-major layout used by
+   presorting and the row-major layout used by prediction.
+ */
+class BenchData {
+ public:
+  const BenchSpec &spec;
+  std::vector<double> xNum; // Column-major:  nRow x nPredNum.
+  std::vector<unsigned int> xFac; // Column-major:  nRow x nPredFac.
+  std::vector<double> xNumT; // Row-major.
+  std::vector<unsigned int> xFacT; // Row-major.
+  std::vector<unsigned int> feCard;
+  std::vector<double> y;
+  std::vector<unsigned int> row2Rank;
+  std::vector<unsigned int> yCtg;
+  std::vector<double> yProxy;
+  std::vector<double> valNum; // Run-length encoding of 'xNum', if requested.
+  std::vector<unsigned int> rowStart;
+  std::vector<unsigned int> runLength;
+  std::vector<unsigned int> predStart;
+  std::vector<unsigned int> valFac; // Run-length encoding of 'xFac', if requested.
+  std::vector<unsigned int> rowStartFac;
+  std::vector<unsigned int> runLengthFac;
+  std::vector<unsigned int> predStartFac;
+
+  BenchData(const BenchSpec &_spec);
+  void Encode();
+};
+
+
+/**
+   @brief Draws a frame whose response depends on a few leading numerical
+   predictors and, if present, on the first factor.
+ */
+BenchData::BenchData(const BenchSpec &_spec) : spec(_spec), xNum(std::vector<double>(spec.nRow * spec.nPredNum)), xFac(std::vector<unsigned int>(spec.nRow * spec.nPredFac)), xNumT(std::vector<double>(spec.nRow * spec.nPredNum)), xFacT(std::vector<unsigned int>(spec.nRow * spec.nPredFac)), feCard(std::vector<unsigned int>(spec.nPredFac, spec.card)), y(std::vector<double>(spec.nRow)), row2Rank(std::vector<unsigned int>(spec.nRow)), yCtg(std::vector<unsigned int>(spec.nRow)), yProxy(std::vector<double>(spec.nRow)) {
+  std::mt19937 gen(spec.seed);
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  std::normal_distribution<double> noise(0.0, 0.1);
+  std::uniform_int_distribution<unsigned int> level(0, spec.card - 1);
+
+  unsigned int nRow = spec.nRow;
+  for (unsigned int predIdx = 0; predIdx < spec.nPredNum; predIdx++) {
+    for (unsigned int row = 0; row < nRow; row++) {
+      double val = unif(gen);
+      xNum[predIdx * nRow + row] = val;
+      xNumT[row * spec.nPredNum + predIdx] = val;
+    }
+  }
+  for (unsigned int facIdx = 0; facIdx < spec.nPredFac; facIdx++) {
+    for (unsigned int row = 0; row < nRow; row++) {
+      unsigned int val = level(gen);
+      xFac[facIdx * nRow + row] = val;
+      xFacT[row * spec.nPredFac + facIdx] = val;
+    }
+  }
+
+  unsigned int nSignal = std::min(spec.nPredNum, 3u);
+  for (unsigned int row = 0; row < nRow; row++) {
+    double sum = noise(gen);
+    for (unsigned int predIdx = 0; predIdx < nSignal; predIdx++) {
+      sum += (predIdx + 1) * xNum[predIdx * nRow + row];
+    }
+    if (spec.nPredFac > 0) {
+      sum += double(xFac[row]) / spec.card;
+    }
+    y[row] = sum;
+  }
+
+  // Response ranks:  ties resolve to the lowest position, as in the
+  // R bridge.
+  std::vector<double> ySorted(y);
+  std::sort(ySorted.begin(), ySorted.end());
+  for (unsigned int row = 0; row < nRow; row++) {
+    row2Rank[row] = std::lower_bound(ySorted.begin(), ySorted.end(), y[row]) - ySorted.begin();
+  }
+
+  // Categorical response bins the regression response by quantile.
+  // Proxy is jittered class frequency, after the R bridge.
+  std::vector<unsigned int> ctgCount(spec.ctgWidth);
+  for (unsigned int row = 0; row < nRow; row++) {
+    yCtg[row] = std::min((row2Rank[row] * spec.ctgWidth) / nRow, spec.ctgWidth - 1);
+    ctgCount[yCtg[row]]++;
+  }
+  double recipLen = 1.0 / nRow;
+  for (unsigned int row = 0; row < nRow; row++) {
+    yProxy[row] = 1.0 / (ctgCount[yCtg[row]] * spec.ctgWidth) + (unif(gen) - 0.5) * 0.5 * (recipLen * recipLen);
+  }
+}
+
+
+/**
+   @brief Run-length encodes a single column.
+
+   @return void, with output vectors extended.
+ */
+template<typename valType> void EncodeColumn(const valType col[], unsigned int nRow, std::vector<valType> &val, std::vector<unsigned int> &rowStart, std::vector<unsigned int> &runLength, std::vector<unsigned int> &predStart) {
+  predStart.push_back(val.size());
+  for (unsigned int row = 0; row < nRow; row++) {
+    if (row > 0 && col[row] == col[row - 1]) {
+      runLength.back()++;
+    }
+    else {
+      val.push_back(col[row]);
+      rowStart.push_back(row);
+      runLength.push_back(1);
+    }
+  }
+}
+
+
+/**
+   @brief Run-length encodes the predictors by column, as the bridges
+   present sparse frames for prediction.
+
+   @return void.
+ */
+void BenchData::Encode() {
+  unsigned int nRow = spec.nRow;
+  for (unsigned int predIdx = 0; predIdx < spec.nPredNum; predIdx++) {
+    EncodeColumn(&xNum[predIdx * nRow], nRow, valNum, rowStart, runLength, predStart);
+  }
+  for (unsigned int facIdx = 0; facIdx < spec.nPredFac; facIdx++) {
+    EncodeColumn(&xFac[facIdx * nRow], nRow, valFac, rowStartFac, runLengthFac, predStartFac);
+  }
+}
+
+
+/**
+   @brief Presorted predictor ranks, as produced by the front end's
+   PreSort calls.
+ */
+class BenchRank {
+ public:
+  std::vector<unsigned int> row;
+  std::vector<unsigned int> rank;
+  std::vector<unsigned int> runLength;
+  std::vector<unsigned int> numOff;
+  std::vector<double> numVal;
+
+  BenchRank(const BenchData &data);
+};
+
+
+BenchRank::BenchRank(const BenchData &data) : numOff(std::vector<unsigned int>(data.spec.nPredNum)) {
+  const BenchSpec &spec = data.spec;
+  if (spec.nPredNum > 0) {
+    RowRank::PreSortNum(&data.xNum[0], spec.nPredNum, spec.nRow, row, rank, runLength, numOff, numVal);
+  }
+  if (spec.nPredFac > 0) {
+    RowRank::PreSortFac(&data.xFac[0], spec.nPredFac, spec.nRow, row, rank, runLength);
+  }
+}
+
+
+/**
+   @brief Trained forest and leaf vectors, as returned to the front end.
+ */
+class BenchForest {
+ public:
+  std::vector<unsigned int> origin;
+  std::vector<unsigned int> facOrigin;
+  std::vector<double> predInfo;
+  std::vector<ForestNode> forestNode;
+  std::vector<unsigned int> facSplit;
+  std::vector<unsigned int> leafOrigin;
+  std::vector<LeafNode> leafNode;
+  std::vector<BagLeaf> bagLeaf;
+  std::vector<unsigned int> bagBits;
+  std::vector<double> weight; // Classification only.
+
+  BenchForest(const BenchSpec &spec) : origin(std::vector<unsigned int>(spec.nTree)), facOrigin(std::vector<unsigned int>(spec.nTree)), predInfo(std::vector<double>(spec.NPred())), leafOrigin(std::vector<unsigned int>(spec.nTree)) {}
+};
+
+
+/**
+   @brief Builds a training context using the R front end's defaults.
+
+   @param ctgWidth is the response cardinality, zero for regression.
+
+   @return void, with output context vectors.
+ */
+TrainContext *BenchContext(const BenchSpec &spec, unsigned int ctgWidth, std::vector<double> &sampleWeight, std::vector<double> &splitQuant, std::vector<double> &predProb, std::vector<double> &regMono) {
+  unsigned int nPred = spec.NPred();
+  unsigned int predFixed = nPred >= 16 ? 0 : (ctgWidth == 0 ? std::max(nPred / 3, 1u) : (unsigned int) std::floor(std::sqrt(double(nPred))));
+  double prob = predFixed != 0 ? 0.0 : (ctgWidth == 0 ? 0.4 : std::ceil(std::sqrt(double(nPred))) / nPred);
+
+  sampleWeight.assign(spec.nRow, 1.0);
+  splitQuant.assign(nPred, 0.5);
+  predProb.assign(nPred, prob);
+  regMono.assign(nPred, 0.0);
+  return new TrainContext(nPred, spec.nTree, spec.nRow, sampleWeight, true, spec.seed, spec.trainBlock, ctgWidth == 0 ? 3 : 2, 0.01, spec.levels, ctgWidth, predFixed, &splitQuant[0], &predProb[0], false, ctgWidth == 0 ? &regMono[0] : 0, spec.treeConcurrent, ctgWidth == 0 ? spec.binMax : 0, spec.spillDir);
+}
+
+
+/**
+   @brief Accumulates wall-clock times for a named phase.
+ */
+class BenchTimer {
+  const std::string name;
+  std::vector<double> sample; // Elapsed seconds, by repetition.
+  std::chrono::steady_clock::time_point start;
+ public:
+  BenchTimer(const std::string &_name) : name(_name) {}
+
+  inline void Start() {
+    start = std::chrono::steady_clock::now();
+  }
+
+  inline void Stop() {
+    sample.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+
+  void Report() const;
+};
+
+
+/**
+   @brief Prints minimum and mean times, in milliseconds.
+ */
+void BenchTimer::Report() const {
+  double tMin = *std::min_element(sample.begin(), sample.end());
+  double tMean = std::accumulate(sample.begin(), sample.end(), 0.0) / sample.size();
+  std::cout << name;
+  for (size_t i = name.size(); i < 24; i++)
+    std::cout << ' ';
+  std::cout << "min " << tMin * 1.0e3 << " ms\tmean " << tMean * 1.0e3 << " ms" << std::endl;
+}
+
+
+/**
+   @brief Prints the level loop's phase breakdown, summed over repetitions.
+ */
+void StatReport(const std::string &name, const TrainStat &stat) {
+  double tTot = std::accumulate(stat.phaseTime.begin(), stat.phaseTime.end(), 0.0);
+  std::cout << name << " phases:" << std::endl;
+  for (unsigned int phase = 0; phase < TrainStat::phaseCount; phase++) {
+    std::string phaseName(TrainStat::phaseName[phase]);
+    std::cout << "  " << phaseName;
+    for (size_t i = phaseName.size(); i < 22; i++)
+      std::cout << ' ';
+    std::cout << stat.phaseTime[phase] * 1.0e3 << " ms\t" << (tTot > 0.0 ? 100.0 * stat.phaseTime[phase] / tTot : 0.0) << " %\tcalls " << stat.phaseCalls[phase] << std::endl;
+  }
+  const std::vector<LevelCount> &levels = stat.Levels();
+  for (unsigned int level = 0; level < levels.size(); level++) {
+    const LevelCount &lc = levels[level];
+    std::cout << "  level " << level << ":\tsplitCoord " << lc.splitCoord << "\trestaged " << lc.restaged << "\tdense " << lc.cellDense << "\tsparse " << lc.cellSparse << "\tnodeRel " << lc.nodeRel << "\tchunked " << lc.chunked << std::endl;
+  }
+}
+
+
+/**
+   @brief Writes both forests as binary images, maps them back and checks
+   that prediction from the images reproduces prediction from memory.
+
+   @return true iff images round trip and predictions agree.
+ */
+bool ModelCheck(const BenchSpec &spec, const BenchData &data, const BenchForest &reg, const BenchForest &ctg, double *numT, unsigned int *facT, const std::vector<double> &yPred, const std::vector<unsigned int> &yPredCtg, const std::vector<double> &prob, BenchTimer &tLoad) {
+  const std::string pathReg = spec.modelPath + ".reg";
+  const std::string pathCtg = spec.modelPath + ".ctg";
+  const std::vector<double> none;
+  if (!ForestFile::Write(pathReg, reg.forestNode, reg.origin, reg.facSplit, reg.facOrigin, reg.leafOrigin, reg.leafNode, reg.bagLeaf, reg.bagBits, data.y, none, spec.nRow, 0) || !ForestFile::Write(pathCtg, ctg.forestNode, ctg.origin, ctg.facSplit, ctg.facOrigin, ctg.leafOrigin, ctg.leafNode, ctg.bagLeaf, ctg.bagBits, none, ctg.weight, spec.nRow, spec.ctgWidth)) {
+    return false;
+  }
+
+  tLoad.Start();
+  ForestFile *fileReg = ForestFile::Load(pathReg);
+  ForestFile *fileCtg = ForestFile::Load(pathCtg);
+  tLoad.Stop();
+  if (fileReg == 0 || fileCtg == 0) {
+    delete fileReg;
+    delete fileCtg;
+    return false;
+  }
+
+  const std::vector<double> valNum;
+  const std::vector<unsigned int> rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac;
+  std::vector<double> yPredFile(spec.nRow);
+  Predict::Regression(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, numT, facT, spec.nPredNum, spec.nPredFac, fileReg->Nodes(), fileReg->Origin(), fileReg->NTree(), fileReg->FacSplit(), fileReg->Count(ForestFile::facSplitSec), fileReg->FacOrigin(), fileReg->NTree(), fileReg->LeafOrigin(), fileReg->Leaves(), fileReg->Count(ForestFile::leafNodeSec), 0, fileReg->YTrain(), yPredFile);
+
+  std::vector<unsigned int> yPredCtgFile(spec.nRow);
+  std::vector<unsigned int> census(spec.nRow * spec.ctgWidth);
+  std::vector<double> probFile(spec.nRow * spec.ctgWidth);
+  std::vector<double> misPred;
+  const std::vector<unsigned int> yTest;
+  Predict::Classification(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, numT, facT, spec.nPredNum, spec.nPredFac, fileCtg->Nodes(), fileCtg->Origin(), fileCtg->NTree(), fileCtg->FacSplit(), fileCtg->Count(ForestFile::facSplitSec), fileCtg->FacOrigin(), fileCtg->NTree(), fileCtg->LeafOrigin(), fileCtg->Leaves(), fileCtg->Count(ForestFile::leafNodeSec), 0, fileCtg->RowTrain(), fileCtg->Weight(), fileCtg->CtgWidth(), yPredCtgFile, &census[0], yTest, 0, misPred, &probFile[0]);
+
+  delete fileReg;
+  delete fileCtg;
+
+  return yPredFile == yPred && yPredCtgFile == yPredCtg && probFile == prob;
+}
+
+
+/**
+   @brief Retrains the regression forest on a single thread, so that no
+   restaging cell is divided, and checks that the forest trained with
+   divided cells is reproduced.
+
+   @param stat holds the counters of the multithreaded run.
+
+   @return true iff some cell was divided and the forests agree.
+ */
+bool ChunkCheck(const BenchSpec &spec, const BenchData &data, const PMTrain *pmTrain, const RowRank *rowRank, const BenchForest &reg, const TrainStat &stat) {
+  unsigned int chunked = 0;
+  for (auto lc : stat.Levels())
+    chunked += lc.chunked;
+  if (chunked == 0)
+    return false;
+
+#ifdef _OPENMP
+  int nThread = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  std::vector<double> sampleWeight, splitQuant, predProb, regMono;
+  TrainContext *ctxSerial = BenchContext(spec, 0, sampleWeight, splitQuant, predProb, regMono);
+  BenchForest serial(spec);
+  Train::Regression(*ctxSerial, pmTrain, rowRank, data.y, data.row2Rank, serial.origin, serial.facOrigin, serial.predInfo, serial.forestNode, serial.facSplit, serial.leafOrigin, serial.leafNode, serial.bagLeaf, serial.bagBits);
+  delete ctxSerial;
+#ifdef _OPENMP
+  omp_set_num_threads(nThread);
+#endif
+
+  if (serial.origin != reg.origin || serial.forestNode.size() != reg.forestNode.size() || serial.leafNode.size() != reg.leafNode.size())
+    return false;
+  for (size_t nodeIdx = 0; nodeIdx < reg.forestNode.size(); nodeIdx++) {
+    unsigned int pred, bump, predSerial, bumpSerial;
+    double num, numSerial;
+    reg.forestNode[nodeIdx].Ref(pred, bump, num);
+    serial.forestNode[nodeIdx].Ref(predSerial, bumpSerial, numSerial);
+    if (pred != predSerial || bump != bumpSerial || num != numSerial)
+      return false;
+  }
+  for (size_t leafIdx = 0; leafIdx < reg.leafNode.size(); leafIdx++) {
+    if (reg.leafNode[leafIdx].GetScore() != serial.leafNode[leafIdx].GetScore())
+      return false;
+  }
+
+  return true;
+}
+
+
+/**
+   @brief Scores each row singly through persistent scorers, checking
+   agreement with block prediction.
+
+   @return true iff predictions agree.
+ */
+bool RowCheck(const BenchSpec &spec, BenchForest &reg, BenchForest &ctg, const double *numT, const unsigned int *facT, const std::vector<double> &yPred, const std::vector<unsigned int> &yPredCtg, const std::vector<double> &prob, BenchTimer &tRow) {
+  Scorer scorerReg(&reg.forestNode[0], &reg.origin[0], spec.nTree, reg.facSplit.data(), reg.facSplit.size(), &reg.facOrigin[0], spec.nTree, reg.leafOrigin, &reg.leafNode[0], reg.leafNode.size(), spec.nPredNum);
+  Scorer scorerCtg(&ctg.forestNode[0], &ctg.origin[0], spec.nTree, ctg.facSplit.data(), ctg.facSplit.size(), &ctg.facOrigin[0], spec.nTree, ctg.leafOrigin, &ctg.leafNode[0], ctg.leafNode.size(), spec.nPredNum, spec.ctgWidth, &ctg.weight[0]);
+
+  std::vector<double> yPredRow(spec.nRow);
+  std::vector<unsigned int> yPredCtgRow(spec.nRow);
+  std::vector<double> probRow(spec.nRow * spec.ctgWidth);
+  std::vector<double> votes(spec.ctgWidth);
+  tRow.Start();
+  for (unsigned int row = 0; row < spec.nRow; row++) {
+    const double *rowNum = numT == 0 ? 0 : numT + row * spec.nPredNum;
+    const unsigned int *rowFac = facT == 0 ? 0 : facT + row * spec.nPredFac;
+    yPredRow[row] = scorerReg.Regression(rowNum, rowFac);
+    yPredCtgRow[row] = scorerCtg.Classification(rowNum, rowFac, &votes[0], &probRow[row * spec.ctgWidth]);
+  }
+  tRow.Stop();
+
+  return yPredRow == yPred && yPredCtgRow == yPredCtg && probRow == prob;
+}
+
+
+/**
+   @brief Streams the transposed observations a block at a time.
+ */
+class BenchSource : public PredictSource {
+  const double *numT;
+  const unsigned int *facT;
+  const unsigned int nPredNum;
+  const unsigned int nPredFac;
+  const unsigned int nRow;
+  unsigned int rowNext;
+ public:
+  BenchSource(const double *_numT, const unsigned int *_facT, unsigned int _nPredNum, unsigned int _nPredFac, unsigned int _nRow) : numT(_numT), facT(_facT), nPredNum(_nPredNum), nPredFac(_nPredFac), nRow(_nRow), rowNext(0) {}
+
+  unsigned int Fill(double blockNumT[], unsigned int blockFacT[], unsigned int rowMax) {
+    unsigned int blockRows = std::min(rowMax, nRow - rowNext);
+    if (nPredNum > 0)
+      std::copy(numT + rowNext * nPredNum, numT + (rowNext + blockRows) * nPredNum, blockNumT);
+    if (nPredFac > 0)
+      std::copy(facT + rowNext * nPredFac, facT + (rowNext + blockRows) * nPredFac, blockFacT);
+    rowNext += blockRows;
+    return blockRows;
+  }
+};
+
+
+/**
+   @brief Gathers streamed predictions into whole-frame vectors.
+ */
+class BenchSink : public PredictSink {
+  const unsigned int ctgWidth;
+  const unsigned int qCount;
+ public:
+  std::vector<double> yPred;
+  std::vector<double> qPred;
+  std::vector<unsigned int> yPredCtg;
+  std::vector<unsigned int> census;
+  std::vector<double> prob;
+
+  BenchSink(unsigned int _ctgWidth, unsigned int _qCount) : ctgWidth(_ctgWidth), qCount(_qCount) {}
+
+  void Regression(unsigned int /* rowStart */, unsigned int nRow, const double blockPred[], const double blockQuant[]) {
+    yPred.insert(yPred.end(), blockPred, blockPred + nRow);
+    if (blockQuant != 0)
+      qPred.insert(qPred.end(), blockQuant, blockQuant + nRow * qCount);
+  }
+
+  void Classification(unsigned int /* rowStart */, unsigned int nRow, const unsigned int blockPred[], const unsigned int blockCensus[], const double blockProb[]) {
+    yPredCtg.insert(yPredCtg.end(), blockPred, blockPred + nRow);
+    census.insert(census.end(), blockCensus, blockCensus + nRow * ctgWidth);
+    if (blockProb != 0)
+      prob.insert(prob.end(), blockProb, blockProb + nRow * ctgWidth);
+  }
+};
+
+
+/**
+   @brief Predicts through the streaming entries, checking agreement
+   with whole-frame prediction.
+
+   @return true iff predictions agree.
+ */
+bool StreamCheck(const BenchSpec &spec, BenchForest &reg, BenchForest &ctg, const std::vector<double> &y, const double *numT, const unsigned int *facT, const std::vector<double> &yPred, const std::vector<double> &quantVec, const std::vector<double> &qPred, const std::vector<unsigned int> &yPredCtg, const std::vector<unsigned int> &census, const std::vector<double> &prob, BenchTimer &tStream) {
+  BenchSink sinkReg(spec.ctgWidth, 0), sinkQuant(spec.ctgWidth, quantVec.size()), sinkCtg(spec.ctgWidth, 0);
+  BenchSource sourceReg(numT, facT, spec.nPredNum, spec.nPredFac, spec.nRow), sourceQuant(numT, facT, spec.nPredNum, spec.nPredFac, spec.nRow), sourceCtg(numT, facT, spec.nPredNum, spec.nPredFac, spec.nRow);
+
+  tStream.Start();
+  unsigned int rowReg = Predict::Regression(&sourceReg, &sinkReg, spec.nPredNum, spec.nPredFac, &reg.forestNode[0], &reg.origin[0], spec.nTree, reg.facSplit.data(), reg.facSplit.size(), &reg.facOrigin[0], spec.nTree, reg.leafOrigin, &reg.leafNode[0], reg.leafNode.size(), y);
+  unsigned int rowCtg = Predict::Classification(&sourceCtg, &sinkCtg, spec.nPredNum, spec.nPredFac, &ctg.forestNode[0], &ctg.origin[0], spec.nTree, ctg.facSplit.data(), ctg.facSplit.size(), &ctg.facOrigin[0], spec.nTree, ctg.leafOrigin, &ctg.leafNode[0], ctg.leafNode.size(), spec.nRow, &ctg.weight[0], spec.ctgWidth, true);
+  tStream.Stop();
+  unsigned int rowQuant = Predict::Quantiles(&sourceQuant, &sinkQuant, spec.nPredNum, spec.nPredFac, &reg.forestNode[0], &reg.origin[0], spec.nTree, reg.facSplit.data(), reg.facSplit.size(), &reg.facOrigin[0], spec.nTree, reg.leafOrigin, &reg.leafNode[0], reg.leafNode.size(), &reg.bagLeaf[0], reg.bagLeaf.size(), &reg.bagBits[0], y, quantVec, 5000);
+
+  return rowReg == spec.nRow && rowCtg == spec.nRow && rowQuant == spec.nRow && sinkReg.yPred == yPred && sinkQuant.yPred == yPred && sinkQuant.qPred == qPred && sinkCtg.yPredCtg == yPredCtg && sinkCtg.census == census && sinkCtg.prob == prob;
+}
+
+
+/**
+   @brief Compiles a generated forest source into a shared library and
+   loads it.  The compiler is named by ARBORIST_CXX, defaulting to 'c++'.
+
+   @return loaded scorer, or null if compilation or loading fails.
+ */
+ScoreLib *CodeBuild(const std::string &pathSrc) {
+  const char *cxx = std::getenv("ARBORIST_CXX");
+  const std::string pathLib = pathSrc.substr(0, pathSrc.size() - 3) + ".so";
+  const std::string cmd = std::string(cxx == 0 ? "c++" : cxx) + " -O2 -shared -fPIC -o " + pathLib + " " + pathSrc;
+  if (std::system(cmd.c_str()) != 0)
+    return 0;
+
+  return ScoreLib::Load(pathLib);
+}
+
+
+/**
+   @brief Emits both forests as C++ source, compiles and loads them, then
+   checks that the compiled scorers reproduce prediction row by row.
+
+   @return true iff the scorers build and predictions agree.
+ */
+bool CodeCheck(const BenchSpec &spec, const BenchForest &reg, const BenchForest &ctg, const double *numT, const unsigned int *facT, const std::vector<double> &yPred, const std::vector<unsigned int> &yPredCtg, BenchTimer &tScore) {
+  const std::string pathReg = spec.codePath + ".reg.cc";
+  const std::string pathCtg = spec.codePath + ".ctg.cc";
+  if (!ForestCode::Write(pathReg, reg.forestNode, reg.origin, reg.facSplit, reg.facOrigin, reg.leafOrigin, reg.leafNode, spec.nPredNum, spec.nPredFac, 0) || !ForestCode::Write(pathCtg, ctg.forestNode, ctg.origin, ctg.facSplit, ctg.facOrigin, ctg.leafOrigin, ctg.leafNode, spec.nPredNum, spec.nPredFac, spec.ctgWidth)) {
+    return false;
+  }
+
+  ScoreLib *libReg = CodeBuild(pathReg);
+  ScoreLib *libCtg = CodeBuild(pathCtg);
+  if (libReg == 0 || libCtg == 0 || libReg->CtgWidth() != 0 || libCtg->CtgWidth() != spec.ctgWidth) {
+    delete libReg;
+    delete libCtg;
+    return false;
+  }
+
+  std::vector<double> yPredCode(spec.nRow);
+  std::vector<unsigned int> yPredCtgCode(spec.nRow);
+  std::vector<double> votes(spec.ctgWidth);
+  tScore.Start();
+  for (unsigned int row = 0; row < spec.nRow; row++) {
+    const double *rowNum = numT == 0 ? 0 : numT + row * spec.nPredNum;
+    const unsigned int *rowFac = facT == 0 ? 0 : facT + row * spec.nPredFac;
+    yPredCode[row] = libReg->Regression(rowNum, rowFac);
+    yPredCtgCode[row] = libCtg->Classification(rowNum, rowFac, &votes[0]);
+  }
+  tScore.Stop();
+
+  delete libReg;
+  delete libCtg;
+
+  return yPredCode == yPred && yPredCtgCode == yPredCtg;
+}
+
+
+int main(int argc, char *argv[]) {
+  BenchSpec spec;
+  if (!spec.Parse(argc, argv)) {
+    std::cerr << "Usage:  " << argv[0] << " [--rows n] [--num p] [--fac q] [--card k] [--trees t] [--ctg w] [--reps r] [--block b] [--seed s] [--bins m] [--levels d] [--spill dir] [--model path] [--codegen path] [--concurrent] [--rle] [--chunkcheck]" << std::endl;
+    return 1;
+  }
+  std::cout << "rows " << spec.nRow << ", numeric " << spec.nPredNum << ", factor " << spec.nPredFac << " (card " << spec.card << "), trees " << spec.nTree << ", categories " << spec.ctgWidth << std::endl;
+
+  BenchData data(spec);
+  unsigned int nRow = spec.nRow;
+  const double autoCompress = 0.25;
+  if (spec.rle)
+    data.Encode();
+  const std::vector<double> &valNum = data.valNum; // Dense blocks iff empty.
+  const std::vector<unsigned int> &rowStart = data.rowStart, &runLength = data.runLength, &predStart = data.predStart;
+  const std::vector<unsigned int> &valFac = data.valFac, &rowStartFac = data.rowStartFac, &runLengthFac = data.runLengthFac, &predStartFac = data.predStartFac;
+  double *numT = spec.nPredNum > 0 ? &data.xNumT[0] : 0;
+  unsigned int *facT = spec.nPredFac > 0 ? &data.xFacT[0] : 0;
+
+  TrainStat statReg, statCtg;
+  BenchTimer tLoad("load model"), tPresort("presort"), tTrainReg("train regression"), tPredReg("predict regression"), tQuant("predict quantiles"), tTrainCtg("train classification"), tPredCtg("predict classification"), tScore("score compiled"), tRow("score single rows"), tStream("predict streamed");
+  for (unsigned int rep = 0; rep < spec.reps; rep++) {
+    // Both jobs train over a single, shared RowRank.
+    tPresort.Start();
+    BenchRank rr(data);
+    PMTrain pmTrain(data.feCard, spec.nPredNum + spec.nPredFac, nRow);
+    RowRank rowRank(&pmTrain, &rr.row[0], &rr.rank[0], rr.numOff.data(), rr.numVal.data(), &rr.runLength[0], rr.runLength.size(), autoCompress, spec.binMax, spec.spillDir);
+    tPresort.Stop();
+
+    std::vector<double> sampleWeight, splitQuant, predProb, regMono;
+    TrainContext *ctxReg = BenchContext(spec, 0, sampleWeight, splitQuant, predProb, regMono);
+    BenchForest reg(spec);
+    tTrainReg.Start();
+    Train::Regression(*ctxReg, &pmTrain, &rowRank, data.y, data.row2Rank, reg.origin, reg.facOrigin, reg.predInfo, reg.forestNode, reg.facSplit, reg.leafOrigin, reg.leafNode, reg.bagLeaf, reg.bagBits);
+    tTrainReg.Stop();
+    statReg.Accum(ctxReg->Stat());
+    if (spec.chunkCheck && !ChunkCheck(spec, data, &pmTrain, &rowRank, reg, ctxReg->Stat())) {
+      std::cerr << "Divided restaging does not reproduce the serial forest" << std::endl;
+      delete ctxReg;
+      return 7;
+    }
+    delete ctxReg;
+
+    std::vector<double> yPred(nRow);
+    tPredReg.Start();
+    Predict::Regression(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, numT, facT, spec.nPredNum, spec.nPredFac, &reg.forestNode[0], &reg.origin[0], spec.nTree, reg.facSplit.data(), reg.facSplit.size(), &reg.facOrigin[0], spec.nTree, reg.leafOrigin, &reg.leafNode[0], reg.leafNode.size(), 0, data.y, yPred);
+    tPredReg.Stop();
+
+    std::vector<double> quantVec { 0.25, 0.5, 0.75 };
+    std::vector<double> qPred(nRow * quantVec.size());
+    tQuant.Start();
+    Predict::Quantiles(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, numT, facT, spec.nPredNum, spec.nPredFac, &reg.forestNode[0], &reg.origin[0], spec.nTree, reg.facSplit.data(), reg.facSplit.size(), &reg.facOrigin[0], spec.nTree, reg.leafOrigin, &reg.leafNode[0], reg.leafNode.size(), &reg.bagLeaf[0], reg.bagLeaf.size(), &reg.bagBits[0], data.y, yPred, quantVec, 5000, qPred, false);
+    tQuant.Stop();
+
+    TrainContext *ctxCtg = BenchContext(spec, spec.ctgWidth, sampleWeight, splitQuant, predProb, regMono);
+    BenchForest ctg(spec);
+    tTrainCtg.Start();
+    Train::Classification(*ctxCtg, &pmTrain, &rowRank, data.yCtg, spec.ctgWidth, data.yProxy, ctg.origin, ctg.facOrigin, ctg.predInfo, ctg.forestNode, ctg.facSplit, ctg.leafOrigin, ctg.leafNode, ctg.bagLeaf, ctg.bagBits, ctg.weight);
+    tTrainCtg.Stop();
+    statCtg.Accum(ctxCtg->Stat());
+    delete ctxCtg;
+
+    std::vector<unsigned int> yPredCtg(nRow);
+    std::vector<unsigned int> census(nRow * spec.ctgWidth);
+    std::vector<double> prob(nRow * spec.ctgWidth);
+    std::vector<double> misPred;
+    const std::vector<unsigned int> yTest;
+    tPredCtg.Start();
+    Predict::Classification(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, numT, facT, spec.nPredNum, spec.nPredFac, &ctg.forestNode[0], &ctg.origin[0], spec.nTree, ctg.facSplit.data(), ctg.facSplit.size(), &ctg.facOrigin[0], spec.nTree, ctg.leafOrigin, &ctg.leafNode[0], ctg.leafNode.size(), 0, nRow, &ctg.weight[0], spec.ctgWidth, yPredCtg, &census[0], yTest, 0, misPred, &prob[0]);
+    tPredCtg.Stop();
+
+    if (!spec.modelPath.empty() && !ModelCheck(spec, data, reg, ctg, numT, facT, yPred, yPredCtg, prob, tLoad)) {
+      std::cerr << "Model image does not reproduce predictions" << std::endl;
+      return 3;
+    }
+
+    if (!RowCheck(spec, reg, ctg, numT, facT, yPred, yPredCtg, prob, tRow)) {
+      std::cerr << "Single-row scoring does not reproduce predictions" << std::endl;
+      return 5;
+    }
+
+    if (!StreamCheck(spec, reg, ctg, data.y, numT, facT, yPred, quantVec, qPred, yPredCtg, census, prob, tStream)) {
+      std::cerr << "Streamed prediction does not reproduce predictions" << std::endl;
+      return 6;
+    }
+
+    if (!spec.codePath.empty() && !CodeCheck(spec, reg, ctg, numT, facT, yPred, yPredCtg, tScore)) {
+      std::cerr << "Generated scorers do not reproduce predictions" << std::endl;
+      return 4;
+    }
+
+    // Sanity:  training-set fit should beat the constant predictor.
+    if (rep == 0) {
+      double yMean = std::accumulate(data.y.begin(), data.y.end(), 0.0) / nRow;
+      double sse = 0.0, sst = 0.0;
+      unsigned int missed = 0;
+      for (unsigned int row = 0; row < nRow; row++) {
+        sse += (yPred[row] - data.y[row]) * (yPred[row] - data.y[row]);
+        sst += (yMean - data.y[row]) * (yMean - data.y[row]);
+        missed += yPredCtg[row] != data.yCtg[row];
+      }
+      std::cout << "fit:  rsq " << 1.0 - sse / sst << ", misclassified " << double(missed) / nRow << std::endl;
+      if (!(sse < sst) || missed * spec.ctgWidth >= nRow * (spec.ctgWidth - 1)) {
+        std::cerr << "Fit no better than constant predictor" << std::endl;
+        return 2;
+      }
+    }
+  }
+
+  tPresort.Report();
+  tTrainReg.Report();
+  tPredReg.Report();
+  tQuant.Report();
+  tTrainCtg.Report();
+  tPredCtg.Report();
+  tRow.Report();
+  tStream.Report();
+  if (!spec.modelPath.empty())
+    tLoad.Report();
+  if (!spec.codePath.empty())
+    tScore.Report();
+  StatReport("train regression", statReg);
+  StatReport("train classification", statCtg);
+
+  return 0;
+}
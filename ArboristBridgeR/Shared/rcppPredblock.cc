@@ -115,7 +115,7 @@ RcppExport SEXP RcppPredBlockFrame(SEXP sX, SEXP sNumElt, SEXP sFacElt, SEXP sLe
       _["blockNum"] = xNum,
       _["nPredNum"] = nPredNum,
       _["blockNumRLE"] = R_NilValue, // For now.
-      _["blockFacRLE"] = R_NilValue, // For now.
+      _["blockFacRLE"] = nPredFac > 0 ? RcppPredblock::FacRLE(xFac) : R_NilValue,
       _["blockFac"] = xFac,
       _["nPredFac"] = nPredFac,
       _["nRow"] = nRow,
@@ -128,6 +128,53 @@ RcppExport SEXP RcppPredBlockFrame(SEXP sX, SEXP sNumElt, SEXP sFacElt, SEXP sLe
 }
 
 
+/**
+   @brief Run-length encodes the factor block, column by column, for
+   prediction.  The dense block is retained, as presorting consumes it.
+
+   @param xFac is the (zero-based, remapped) factor block.
+
+   @return BlockFacRLE, if encoding is no larger than the dense block,
+   else null.
+ */
+SEXP RcppPredblock::FacRLE(const IntegerMatrix &xFac) {
+  unsigned int nRow = xFac.nrow();
+  unsigned int nCol = xFac.ncol();
+  size_t runCount = 0;
+  for (unsigned int col = 0; col < nCol; col++) {
+    for (unsigned int row = 0; row < nRow; row++) {
+      if (row == 0 || xFac(row, col) != xFac(row - 1, col))
+        runCount++;
+    }
+  }
+  // Each run occupies four words, each cell one.
+  if (4 * runCount > size_t(nRow) * nCol)
+    return R_NilValue;
+
+  std::vector<unsigned int> valFac, rowStart, runLength, predStart;
+  for (unsigned int col = 0; col < nCol; col++) {
+    predStart.push_back(valFac.size());
+    for (unsigned int row = 0; row < nRow; row++) {
+      if (row == 0 || xFac(row, col) != xFac(row - 1, col)) {
+        valFac.push_back(xFac(row, col));
+        rowStart.push_back(row);
+        runLength.push_back(0);
+      }
+      runLength.back()++;
+    }
+  }
+
+  List blockFacRLE = List::create(
+	  _["valFac"] = valFac,
+	  _["rowStart"] = rowStart,
+	  _["runLength"] = runLength,
+	  _["predStart"] = predStart);
+  blockFacRLE.attr("class") = "BlockFacRLE";
+
+  return blockFacRLE;
+}
+
+
 void RcppPredblock::FactorRemap(IntegerMatrix &xFac, List &levelTest, List &levelTrain) {
   for (int col = 0; col < xFac.ncol(); col++) {
     CharacterVector colTest(as<CharacterVector>(levelTest[col]));
@@ -353,9 +400,11 @@ void RcppPredblock::SparseIJ(NumericVector &eltsNZ, IntegerVector &i, IntegerVec
 
 
 /**
-   @brief Unwraps field values useful for prediction.
+   @brief Unwraps field values useful for prediction.  Run-length encoded
+   blocks, when present, are preferred to their dense counterparts, which
+   are then left empty.
  */
-void RcppPredblock::Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_nPredNum, unsigned int &_nPredFac, NumericMatrix &_blockNum, IntegerMatrix &_blockFac, std::vector<double> &_valNum, std::vector<unsigned int> &_rowStart, std::vector<unsigned int> &_runLength, std::vector<unsigned int> &_predStart) {
+void RcppPredblock::Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_nPredNum, unsigned int &_nPredFac, NumericMatrix &_blockNum, IntegerMatrix &_blockFac, std::vector<double> &_valNum, std::vector<unsigned int> &_rowStart, std::vector<unsigned int> &_runLength, std::vector<unsigned int> &_predStart, std::vector<unsigned int> &_valFac, std::vector<unsigned int> &_rowStartFac, std::vector<unsigned int> &_runLengthFac, std::vector<unsigned int> &_predStartFac) {
   List predBlock(sPredBlock);
   if (!predBlock.inherits("PredBlock"))
     stop("Expecting PredBlock");
@@ -375,7 +424,11 @@ void RcppPredblock::Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_
   }
 
   if (!Rf_isNull(predBlock["blockFacRLE"])) {
-    stop("Sparse factors:  NYI");
+    List blockFacRLE((SEXP) predBlock["blockFacRLE"]);
+    _valFac = as<std::vector<unsigned int> >((SEXP) blockFacRLE["valFac"]);
+    _rowStartFac = as<std::vector<unsigned int> >((SEXP) blockFacRLE["rowStart"]);
+    _runLengthFac = as<std::vector<unsigned int> >((SEXP) blockFacRLE["runLength"]);
+    _predStartFac = as<std::vector<unsigned int> >((SEXP) blockFacRLE["predStart"]);
   }
   else {
     _blockFac = as<IntegerMatrix>((SEXP) predBlock["blockFac"]);
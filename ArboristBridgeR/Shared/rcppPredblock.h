@@ -37,7 +37,8 @@ class RcppPredblock {
   static void SparseJP(NumericVector &eltsNZ, IntegerVector &j, IntegerVector &p, unsigned int nRow, std::vector<double> &valNum, std::vector<unsigned int> &rowStart, std::vector<unsigned int> &runLength);
   static void SparseIJ(NumericVector &eltsNZ, IntegerVector &i, IntegerVector &j, unsigned int nRow, std::vector<double> &valNum, std::vector<unsigned int> &rowStart, std::vector<unsigned int> &runLength);
   static void Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_nPredNum, unsigned int &_nPredFac, NumericMatrix &_blockNum, IntegerMatrix &_blockFac);
-  static void Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_nPredNum, unsigned int &_nPredFac, NumericMatrix &_blockNum, IntegerMatrix &_blockFac, std::vector<double> &_valNum, std::vector<unsigned int> &_rowStart, std::vector<unsigned int> &_runLength, std::vector<unsigned int> &_predBlock);
+  static void Unwrap(SEXP sPredBlock, unsigned int &_nRow, unsigned int &_nPredNum, unsigned int &_nPredFac, NumericMatrix &_blockNum, IntegerMatrix &_blockFac, std::vector<double> &_valNum, std::vector<unsigned int> &_rowStart, std::vector<unsigned int> &_runLength, std::vector<unsigned int> &_predBlock, std::vector<unsigned int> &_valFac, std::vector<unsigned int> &_rowStartFac, std::vector<unsigned int> &_runLengthFac, std::vector<unsigned int> &_predStartFac);
+  static SEXP FacRLE(const IntegerMatrix &xFac);
   static void SignatureUnwrap(SEXP sSignature, IntegerVector &_predMap, List &_level);
   static void FactorRemap(IntegerMatrix &xFac, List &level, List &levelTrain);
 };
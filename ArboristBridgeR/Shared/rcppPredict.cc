@@ -79,7 +79,11 @@ RcppExport SEXP RcppPredictReg(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP s
   std::vector<unsigned int> rowStart;
   std::vector<unsigned int> runLength;
   std::vector<unsigned int> predStart;
-  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart);
+  std::vector<unsigned int> valFac;
+  std::vector<unsigned int> rowStartFac;
+  std::vector<unsigned int> runLengthFac;
+  std::vector<unsigned int> predStartFac;
+  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac);
 
   unsigned int *origin, *facOrig, *facSplit;
   ForestNode *forestNode;
@@ -97,7 +101,7 @@ RcppExport SEXP RcppPredictReg(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP s
   RcppLeaf::UnwrapReg(sLeaf, yTrain, leafOrigin, leafNode, leafCount, bagLeaf, bagLeafTot, bagBits, validate);
 
   std::vector<double> yPred(nRow);
-  Predict::Regression(valNum, rowStart, runLength, predStart, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, nPredFac > 0 ? (unsigned int *) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagBits, yTrain, yPred);
+  Predict::Regression(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, (valFac.size() == 0 && nPredFac > 0) ? (unsigned int *) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagBits, yTrain, yPred);
 
   List prediction;
   if (Rf_isNull(sYTest)) { // Prediction
@@ -150,7 +154,11 @@ RcppExport SEXP RcppPredictCtg(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP s
   std::vector<unsigned int> rowStart;
   std::vector<unsigned int> runLength;
   std::vector<unsigned int> predStart;
-  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart);
+  std::vector<unsigned int> valFac;
+  std::vector<unsigned int> rowStartFac;
+  std::vector<unsigned int> runLengthFac;
+  std::vector<unsigned int> predStartFac;
+  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac);
     
   unsigned int *origin, *facOrig, *facSplit;
   ForestNode *forestNode;
@@ -214,7 +222,7 @@ RcppExport SEXP RcppPredictCtg(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP s
   std::vector<unsigned int> censusCore(nRow * ctgWidth);
   std::vector<unsigned int> yPred(nRow);
   NumericVector probCore = doProb ? NumericVector(nRow * ctgWidth) : NumericVector(0);
-  Predict::Classification(valNum, rowStart, runLength, predStart, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, nPredFac > 0 ? (unsigned int*) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagBits, rowTrain, weight, ctgWidth, yPred, &censusCore[0], testCore, test ? &confCore[0] : 0, misPredCore, doProb ? probCore.begin() : 0);
+  Predict::Classification(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, (valFac.size() == 0 && nPredFac > 0) ? (unsigned int*) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagBits, rowTrain, weight, ctgWidth, yPred, &censusCore[0], testCore, test ? &confCore[0] : 0, misPredCore, doProb ? probCore.begin() : 0);
 
   List predBlock(sPredBlock);
   IntegerMatrix census = transpose(IntegerMatrix(ctgWidth, nRow, &censusCore[0]));
@@ -355,7 +363,11 @@ RcppExport SEXP RcppPredictQuant(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP
   std::vector<unsigned int> rowStart;
   std::vector<unsigned int> runLength;
   std::vector<unsigned int> predStart;
-  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart);
+  std::vector<unsigned int> valFac;
+  std::vector<unsigned int> rowStartFac;
+  std::vector<unsigned int> runLengthFac;
+  std::vector<unsigned int> predStartFac;
+  RcppPredblock::Unwrap(sPredBlock, nRow, nPredNum, nPredFac, blockNum, blockFac, valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac);
     
   unsigned int *origin, *facOrig, *facSplit;
   ForestNode *forestNode;
@@ -378,7 +390,7 @@ RcppExport SEXP RcppPredictQuant(SEXP sPredBlock, SEXP sForest, SEXP sLeaf, SEXP
   std::vector<double> yPred(nRow);
   std::vector<double> quantVecCore(as<std::vector<double> >(sQuantVec));
   std::vector<double> qPredCore(nRow * quantVecCore.size());
-  Predict::Quantiles(valNum, rowStart, runLength, predStart, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, nPredFac > 0 ? (unsigned int*) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagLeaf, bagLeafTot, bagBits, yTrain, yPred, quantVecCore, as<unsigned int>(sQBin), qPredCore, validate);
+  Predict::Quantiles(valNum, rowStart, runLength, predStart, valFac, rowStartFac, runLengthFac, predStartFac, (valNum.size() == 0 && nPredNum > 0) ? transpose(blockNum).begin() : 0, (valFac.size() == 0 && nPredFac > 0) ? (unsigned int*) transpose(blockFac).begin() : 0, nPredNum, nPredFac, forestNode, origin, nTree, facSplit, facLen, facOrig, nFac, leafOrigin, leafNode, leafCount, bagLeaf, bagLeafTot, bagBits, yTrain, yPred, quantVecCore, as<unsigned int>(sQBin), qPredCore, validate);
   
   NumericMatrix qPred(transpose(NumericMatrix(quantVecCore.size(), nRow, qPredCore.begin())));
   List prediction;
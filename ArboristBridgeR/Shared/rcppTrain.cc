@@ -30,6 +30,8 @@ using namespace Rcpp;
 #include "rcppForest.h"
 #include "rcppLeaf.h"
 #include "train.h"
+#include "context.h"
+#include "trainstat.h"
 #include "forest.h"
 #include "leaf.h"
 
@@ -37,6 +39,61 @@ using namespace Rcpp;
 //using namespace std;
 
 
+/**
+   @brief Draws a seed for the core's generator from R's session stream,
+   so that 'set.seed' continues to govern reproducibility.
+
+   @return seed value.
+ */
+unsigned int RcppSeed() {
+  RNGScope scope;
+  return static_cast<unsigned int>(R::unif_rand() * 4294967295.0);
+}
+
+
+/**
+   @brief Wraps the core's level-loop instrumentation.
+
+   @param trainStat holds the job's accumulated timings and counters.
+
+   @return list of per-phase times and per-level census.
+ */
+List RcppTrainStat(const TrainStat &trainStat) {
+  CharacterVector phase(TrainStat::phaseCount);
+  for (unsigned int i = 0; i < TrainStat::phaseCount; i++) {
+    phase[i] = TrainStat::phaseName[i];
+  }
+  NumericVector seconds(trainStat.phaseTime.begin(), trainStat.phaseTime.end());
+  NumericVector calls(trainStat.phaseCalls.begin(), trainStat.phaseCalls.end());
+  seconds.attr("names") = phase;
+  calls.attr("names") = phase;
+
+  const std::vector<LevelCount> &levels = trainStat.Levels();
+  unsigned int nLevel = levels.size();
+  NumericVector splitCoord(nLevel), restaged(nLevel), cellDense(nLevel), cellSparse(nLevel), nodeRel(nLevel), chunked(nLevel);
+  for (unsigned int level = 0; level < nLevel; level++) {
+    splitCoord[level] = levels[level].splitCoord;
+    restaged[level] = levels[level].restaged;
+    cellDense[level] = levels[level].cellDense;
+    cellSparse[level] = levels[level].cellSparse;
+    nodeRel[level] = levels[level].nodeRel;
+    chunked[level] = levels[level].chunked;
+  }
+
+  return List::create(
+      _["seconds"] = seconds,
+      _["calls"] = calls,
+      _["levels"] = DataFrame::create(
+          _["splitCoord"] = splitCoord,
+          _["restaged"] = restaged,
+          _["cellDense"] = cellDense,
+          _["cellSparse"] = cellSparse,
+          _["nodeRel"] = nodeRel,
+          _["chunked"] = chunked)
+  );
+}
+
+
 /**
    @brief R-language interface to response caching.
 
@@ -82,9 +139,11 @@ void RcppProxyCtg(IntegerVector y, NumericVector classWeight, std::vector<double
 
    @param sTotLevels is an upper bound on the number of levels to construct for each tree.
 
+   @param sTreeConcurrent is true iff the trees of a block train concurrently.
+
    @return Wrapped length of forest vector, with output parameters.
  */
-RcppExport SEXP RcppTrainCtg(SEXP sPredBlock, SEXP sRowRank, SEXP sYOneBased, SEXP sNTree, SEXP sNSamp, SEXP sSampleWeight, SEXP sWithRepl, SEXP sTrainBlock, SEXP sMinNode, SEXP sMinRatio, SEXP sTotLevels, SEXP sPredFixed, SEXP sSplitQuant, SEXP sProbVec, SEXP sAutoCompress, SEXP sThinLeaves, SEXP sClassWeight) {
+RcppExport SEXP RcppTrainCtg(SEXP sPredBlock, SEXP sRowRank, SEXP sYOneBased, SEXP sNTree, SEXP sNSamp, SEXP sSampleWeight, SEXP sWithRepl, SEXP sTrainBlock, SEXP sMinNode, SEXP sMinRatio, SEXP sTotLevels, SEXP sPredFixed, SEXP sSplitQuant, SEXP sProbVec, SEXP sAutoCompress, SEXP sThinLeaves, SEXP sClassWeight, SEXP sTreeConcurrent) {
   List predBlock(sPredBlock);
   if (!predBlock.inherits("PredBlock"))
     stop("Expecting PredBlock");
@@ -111,7 +170,7 @@ RcppExport SEXP RcppTrainCtg(SEXP sPredBlock, SEXP sRowRank, SEXP sYOneBased, SE
   NumericVector predProb = NumericVector(sProbVec)[predMap];
   NumericVector splitQuant = NumericVector(sSplitQuant)[predMap];
 
-  Train::Init(nPred, nTree, as<unsigned int>(sNSamp), sampleWeight, as<bool>(sWithRepl), as<unsigned int>(sTrainBlock), as<unsigned int>(sMinNode), as<double>(sMinRatio), as<unsigned int>(sTotLevels), ctgWidth, as<unsigned int>(sPredFixed), splitQuant.begin(), predProb.begin(), as<bool>(sThinLeaves));
+  TrainContext trainCtx(nPred, nTree, as<unsigned int>(sNSamp), sampleWeight, as<bool>(sWithRepl), RcppSeed(), as<unsigned int>(sTrainBlock), as<unsigned int>(sMinNode), as<double>(sMinRatio), as<unsigned int>(sTotLevels), ctgWidth, as<unsigned int>(sPredFixed), splitQuant.begin(), predProb.begin(), as<bool>(sThinLeaves), 0, as<bool>(sTreeConcurrent));
 
   std::vector<unsigned int> facCard(as<std::vector<unsigned int> >(predBlock["facCard"]));
   std::vector<unsigned int> origin(nTree);
@@ -130,20 +189,33 @@ RcppExport SEXP RcppTrainCtg(SEXP sPredBlock, SEXP sRowRank, SEXP sYOneBased, SE
   unsigned int *feNumOff, *feRow, *feRank, *feRLE, rleLength;
   RcppRowrank::Unwrap(sRowRank, feNumOff, feNumVal, feRow, feRank, feRLE, rleLength);
 
-  Train::Classification(feRow, feRank, feNumOff, feNumVal, feRLE, rleLength, as<std::vector<unsigned int> >(y), ctgWidth, proxy, origin, facOrig, predInfo, facCard, forestNode, facSplit, leafOrigin, leafNode, as<double>(sAutoCompress), bagLeaf, bagBits, weight);
+  Train::Classification(trainCtx, feRow, feRank, feNumOff, feNumVal, feRLE, rleLength, as<std::vector<unsigned int> >(y), ctgWidth, proxy, origin, facOrig, predInfo, facCard, forestNode, facSplit, leafOrigin, leafNode, as<double>(sAutoCompress), bagLeaf, bagBits, weight);
 
   RcppRowrank::Clear();
   
   NumericVector infoOut(predInfo.begin(), predInfo.end());
-  return List::create(
+  List trainOut = List::create(
       _["forest"] = RcppForest::Wrap(origin, facOrig, facSplit, forestNode),
       _["leaf"] = RcppLeaf::WrapCtg(leafOrigin, leafNode, bagLeaf, bagBits, weight, yOneBased.length(), CharacterVector(yOneBased.attr("levels"))),
       _["predInfo"] = infoOut[predMap] // Maps back from core order.
   );
+  trainOut.attr("trainStat") = RcppTrainStat(trainCtx.Stat());
+
+  return trainOut;
 }
 
 
-RcppExport SEXP RcppTrainReg(SEXP sPredBlock, SEXP sRowRank, SEXP sY, SEXP sNTree, SEXP sNSamp, SEXP sSampleWeight, SEXP sWithRepl, SEXP sTrainBlock, SEXP sMinNode, SEXP sMinRatio, SEXP sTotLevels, SEXP sPredFixed, SEXP sSplitQuant, SEXP sProbVec, SEXP sAutoCompress, SEXP sThinLeaves, SEXP sRegMono) {
+/**
+   @brief Constructs regression forest.
+
+   @param sTreeConcurrent is true iff the trees of a block train concurrently.
+
+   @param sBinMax, if positive, is the maximal number of histogram bins per
+   numeric predictor.
+
+   @return Wrapped length of forest vector, with output parameters.
+ */
+RcppExport SEXP RcppTrainReg(SEXP sPredBlock, SEXP sRowRank, SEXP sY, SEXP sNTree, SEXP sNSamp, SEXP sSampleWeight, SEXP sWithRepl, SEXP sTrainBlock, SEXP sMinNode, SEXP sMinRatio, SEXP sTotLevels, SEXP sPredFixed, SEXP sSplitQuant, SEXP sProbVec, SEXP sAutoCompress, SEXP sThinLeaves, SEXP sRegMono, SEXP sTreeConcurrent, SEXP sBinMax) {
   List predBlock(sPredBlock);
   if (!predBlock.inherits("PredBlock"))
     stop("Expecting PredBlock");
@@ -162,7 +234,7 @@ RcppExport SEXP RcppTrainReg(SEXP sPredBlock, SEXP sRowRank, SEXP sY, SEXP sNTre
   NumericVector regMono = NumericVector(sRegMono)[predMap];
   NumericVector splitQuant = NumericVector(sSplitQuant)[predMap];
   
-  Train::Init(nPred, nTree, as<unsigned int>(sNSamp), sampleWeight, as<bool>(sWithRepl), as<unsigned int>(sTrainBlock), as<unsigned int>(sMinNode), as<double>(sMinRatio), as<unsigned int>(sTotLevels), 0, as<unsigned int>(sPredFixed), splitQuant.begin(), predProb.begin(), as<bool>(sThinLeaves), regMono.begin());
+  TrainContext trainCtx(nPred, nTree, as<unsigned int>(sNSamp), sampleWeight, as<bool>(sWithRepl), RcppSeed(), as<unsigned int>(sTrainBlock), as<unsigned int>(sMinNode), as<double>(sMinRatio), as<unsigned int>(sTotLevels), 0, as<unsigned int>(sPredFixed), splitQuant.begin(), predProb.begin(), as<bool>(sThinLeaves), regMono.begin(), as<bool>(sTreeConcurrent), as<unsigned int>(sBinMax));
 
   double *feNumVal;
   unsigned int *feRow, *feNumOff, *feRank, *feRLE, rleLength;
@@ -184,15 +256,18 @@ RcppExport SEXP RcppTrainReg(SEXP sPredBlock, SEXP sRowRank, SEXP sY, SEXP sNTre
   std::vector<unsigned int> facSplit;
 
   const std::vector<unsigned int> facCard(as<std::vector<unsigned int> >(predBlock["facCard"]));
-  Train::Regression(feRow, feRank, feNumOff, feNumVal, feRLE, rleLength, as<std::vector<double> >(y), as<std::vector<unsigned int> >(row2Rank), origin, facOrig, predInfo, facCard, forestNode, facSplit, leafOrigin, leafNode, as<double>(sAutoCompress), bagLeaf, bagBits);
+  Train::Regression(trainCtx, feRow, feRank, feNumOff, feNumVal, feRLE, rleLength, as<std::vector<double> >(y), as<std::vector<unsigned int> >(row2Rank), origin, facOrig, predInfo, facCard, forestNode, facSplit, leafOrigin, leafNode, as<double>(sAutoCompress), bagLeaf, bagBits);
 
   RcppRowrank::Clear();
 
   // Temporary copy for subscripted access by IntegerVector.
   NumericVector infoOut(predInfo.begin(), predInfo.end()); 
-  return List::create(
+  List trainOut = List::create(
       _["forest"] = RcppForest::Wrap(origin, facOrig, facSplit, forestNode),
       _["leaf"] = RcppLeaf::WrapReg(leafOrigin, leafNode, bagLeaf, bagBits, as<std::vector<double> >(y)),
       _["predInfo"] = infoOut[predMap] // Maps back from core order.
     );
+  trainOut.attr("trainStat") = RcppTrainStat(trainCtx.Stat());
+
+  return trainOut;
 }
@@ -0,0 +1,155 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file binscore.cc
+
+   @brief Construction of binned forests and binning of predictor blocks.
+
+   @author Mark Seligman
+ */
+
+#include "binscore.h"
+#include "forest.h"
+#include "predblock.h"
+#include "predict.h"
+
+#include <algorithm>
+#include <cmath>
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Constructor.  Cuts and nodes are filled by the factory.
+
+   @param height is the total number of nodes.
+ */
+BinScore::BinScore(unsigned int _nPred, unsigned int _binBytes, unsigned int _predBits, unsigned int height) : nPred(_nPred), binBytes(_binBytes), predBits(_predBits), predOrigin(std::vector<unsigned int>(_nPred + 1)), binNode(std::vector<BinNode>(height)), blockBin(std::vector<unsigned char>(PMPredict::rowBlock * _nPred * _binBytes)) {
+}
+
+
+/**
+   @brief Recasts a forest of numeric splits over the bins of their
+   thresholds.
+
+   @param _forestNode are the trained nodes, with numeric splits only.
+
+   @param _height is the total number of nodes.
+
+   @param _nPred is the number of (numeric) predictors.
+
+   @return new scorer, or null if some predictor has too many distinct
+   thresholds or some child offset cannot be packed.
+ */
+BinScore *BinScore::Factory(const ForestNode _forestNode[], unsigned int _height, unsigned int _nPred) {
+  std::vector<std::vector<double> > predCut(_nPred);
+  unsigned int bumpMax = 0;
+  for (unsigned int nodeIdx = 0; nodeIdx < _height; nodeIdx++) {
+    unsigned int pred, bump;
+    double num;
+    _forestNode[nodeIdx].Ref(pred, bump, num);
+    if (bump != 0) {
+      predCut[pred].push_back(num);
+      bumpMax = std::max(bumpMax, bump);
+    }
+  }
+
+  size_t cutMax = 0;
+  size_t cutTot = 0;
+  for (auto & cuts : predCut) {
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    cutMax = std::max(cutMax, cuts.size());
+    cutTot += cuts.size();
+  }
+
+  // Bins range up to the cut count, inclusive.
+  unsigned int binBytes;
+  if (cutMax <= 0xff)
+    binBytes = 1;
+  else if (cutMax <= 0xffff)
+    binBytes = 2;
+  else
+    return 0;
+
+  unsigned int predBits = 1;
+  while ((1u << predBits) < _nPred)
+    predBits++;
+  if (predBits >= 32 || bumpMax >= (1u << (32 - predBits)))
+    return 0;
+
+  BinScore *binScore = new BinScore(_nPred, binBytes, predBits, _height);
+  binScore->cut.reserve(cutTot);
+  for (unsigned int predIdx = 0; predIdx < _nPred; predIdx++) {
+    binScore->cut.insert(binScore->cut.end(), predCut[predIdx].begin(), predCut[predIdx].end());
+    binScore->predOrigin[predIdx + 1] = binScore->cut.size();
+  }
+
+  for (unsigned int nodeIdx = 0; nodeIdx < _height; nodeIdx++) {
+    unsigned int pred, bump;
+    double num;
+    _forestNode[nodeIdx].Ref(pred, bump, num);
+    BinNode &node = binScore->binNode[nodeIdx];
+    if (bump == 0) {
+      node.code = 0;
+      node.bin = pred;
+    }
+    else {
+      const double *first = binScore->cut.data() + binScore->predOrigin[pred];
+      const double *sup = binScore->cut.data() + binScore->predOrigin[pred + 1];
+      node.code = (bump << predBits) | pred;
+      node.bin = std::lower_bound(first, sup, num) - first;
+    }
+  }
+
+  return binScore;
+}
+
+
+/**
+   @brief Bins each value of a row by binary search over its predictor's
+   cuts.  Missing values are binned beyond every cut.
+
+   @param rowT is a numeric data array section corresponding to the row.
+
+   @param rowBin outputs the bins, by predictor.
+
+   @return void, with output parameter vector.
+ */
+template<typename binType> void BinScore::BinRow(const double rowT[], binType rowBin[]) const {
+  for (unsigned int predIdx = 0; predIdx < nPred; predIdx++) {
+    const double *first = cut.data() + predOrigin[predIdx];
+    const double *sup = cut.data() + predOrigin[predIdx + 1];
+    double val = rowT[predIdx];
+    rowBin[predIdx] = std::isnan(val) ? sup - first : std::lower_bound(first, sup, val) - first;
+  }
+}
+
+
+/**
+   @brief Bins the rows of the current block, once, ahead of traversal.
+
+   @param nBlockRow is the number of rows in the block.
+
+   @return void.
+ */
+void BinScore::BinBlock(const Predict *predict, unsigned int nBlockRow) {
+  int blockRow;
+
+#pragma omp parallel default(shared) private(blockRow)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (blockRow = 0; blockRow < int(nBlockRow); blockRow++) {
+      if (binBytes == 1)
+        BinRow(predict->RowNum(blockRow), &blockBin[blockRow * nPred]);
+      else
+        BinRow(predict->RowNum(blockRow), reinterpret_cast<unsigned short *>(&blockBin[0]) + blockRow * nPred);
+    }
+  }
+}
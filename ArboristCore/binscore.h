@@ -0,0 +1,98 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file binscore.h
+
+   @brief Evaluation of numeric forests over pre-binned predictor
+   values.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_BINSCORE_H
+#define ARBORIST_BINSCORE_H
+
+#include <vector>
+
+
+/**
+   @brief Numeric forest recast over integer bins.  The split thresholds
+   of each predictor are gathered into an ascending table of cuts, and
+   each value of a block is binned once, by binary search, to the number
+   of its predictor's cuts lying strictly below it.  A value then lies at
+   or below a threshold exactly when its bin does not exceed the
+   threshold's position in the table, so that nodes compare small
+   integers in place of doubles.  Missing values bin past the last cut,
+   so fall right, as in the double-valued test.
+
+   Bin codes occupy one byte if no predictor has more than 255 cuts, and
+   two if none has more than 65535.  Otherwise, the forest is not binned.
+ */
+class BinScore {
+  /**
+     @brief Binned counterpart of the ForestNode at the same position.
+   */
+  struct BinNode {
+    unsigned int code; // Child offset over predictor, zero iff terminal.
+    unsigned int bin; // Cut position, or leaf index if terminal.
+  };
+
+  const unsigned int nPred;
+  const unsigned int binBytes; // Width of a bin code.
+  const unsigned int predBits; // Width of the packed predictor index.
+  std::vector<unsigned int> predOrigin; // Per-predictor offsets into cuts.
+  std::vector<double> cut; // Split thresholds, ascending by predictor.
+  std::vector<BinNode> binNode;
+  std::vector<unsigned char> blockBin; // Bin codes of the current block.
+
+  BinScore(unsigned int _nPred, unsigned int _binBytes, unsigned int _predBits, unsigned int height);
+  template<typename binType> void BinRow(const double rowT[], binType rowBin[]) const;
+
+
+  /**
+     @brief Walks a single tree over a binned row.
+
+     @param idx is the tree's root.
+
+     @return leaf index reached.
+   */
+  template<typename binType> inline unsigned int Walk(unsigned int idx, const binType rowBin[]) const {
+    const unsigned int predMask = (1u << predBits) - 1;
+    const BinNode *node = &binNode[0];
+    while (node[idx].code != 0) {
+      unsigned int code = node[idx].code;
+      idx += (code >> predBits) + (rowBin[code & predMask] <= node[idx].bin ? 0 : 1);
+    }
+
+    return node[idx].bin;
+  }
+
+ public:
+  static BinScore *Factory(const class ForestNode _forestNode[], unsigned int _height, unsigned int _nPred);
+  void BinBlock(const class Predict *predict, unsigned int nBlockRow);
+
+
+  /**
+     @brief Walks a tree over a row of the current block.
+
+     @param rootIdx is the forest-relative position of the tree's root.
+
+     @param blockRow is the block-relative row index.
+
+     @return leaf index reached.
+   */
+  inline unsigned int Leaf(unsigned int rootIdx, unsigned int blockRow) const {
+    if (binBytes == 1)
+      return Walk(rootIdx, &blockBin[blockRow * nPred]);
+    else
+      return Walk(rootIdx, reinterpret_cast<const unsigned short *>(&blockBin[0]) + blockRow * nPred);
+  }
+};
+
+#endif
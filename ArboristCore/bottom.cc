@@ -29,6 +29,10 @@
 #include <numeric>
 #include <algorithm>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // Testing only:
 //#include <iostream>
 //using namespace std;
@@ -39,16 +43,16 @@
 /**
    @brief Static entry for regression.
  */
-Bottom *Bottom::FactoryReg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount) {
-  return new Bottom(_pmTrain, _samplePred, _rowRank, new SPReg(_pmTrain, _rowRank, _samplePred, _bagCount), _bagCount);
+Bottom *Bottom::FactoryReg(const TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount, unsigned int _tIdx) {
+  return new Bottom(_pmTrain, _samplePred, _rowRank, new SPReg(_trainCtx, _pmTrain, _rowRank, _samplePred, _bagCount, _tIdx), _bagCount);
 }
 
 
 /**
    @brief Static entry for classification.
  */
-Bottom *Bottom::FactoryCtg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, const std::vector<SampleNode> &_sampleCtg, unsigned int _bagCount) {
-  return new Bottom(_pmTrain, _samplePred, _rowRank, new SPCtg(_pmTrain, _rowRank, _samplePred, _sampleCtg, _bagCount), _bagCount);
+Bottom *Bottom::FactoryCtg(const TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, const std::vector<SampleNode> &_sampleCtg, unsigned int _bagCount, unsigned int _tIdx) {
+  return new Bottom(_pmTrain, _samplePred, _rowRank, new SPCtg(_trainCtx, _pmTrain, _rowRank, _samplePred, _sampleCtg, _bagCount, _tIdx), _bagCount);
 }
 
 
@@ -88,7 +92,7 @@ void Bottom::RootDef(unsigned int predIdx, bool singleton, unsigned int implicit
 }
 
   
-Level::Level(unsigned int _splitCount, unsigned int _nPred, const std::vector<unsigned int> &_denseIdx, unsigned int _nPredDense, unsigned int bagCount, unsigned int _idxLive, bool _nodeRel) : nPred(_nPred), denseIdx(_denseIdx), nPredDense(_nPredDense), splitCount(_splitCount), noIndex(bagCount), idxLive(_idxLive), nodeRel(_nodeRel), defCount(0), del(0), indexAnc(std::vector<IndexAnc>(splitCount)), def(std::vector<MRRA>(splitCount * nPred)), denseCoord(std::vector<DenseCoord>(splitCount * nPredDense)), relPath(new IdxPath(idxLive)) {
+Level::Level(unsigned int _splitCount, unsigned int _nPred, const std::vector<unsigned int> &_denseIdx, unsigned int _nPredDense, unsigned int bagCount, unsigned int _idxLive, bool _nodeRel) : nPred(_nPred), denseIdx(_denseIdx), nPredDense(_nPredDense), splitCount(_splitCount), noIndex(bagCount), idxLive(_idxLive), nodeRel(_nodeRel), defCount(0), del(0), indexAnc(std::vector<IndexAnc>(splitCount)), def(std::vector<MRRA>(size_t(splitCount) * nPred)), denseCoord(std::vector<DenseCoord>(size_t(splitCount) * nPredDense)), relPath(new IdxPath(idxLive)) {
   MRRA df;
   df.Init();
   std::fill(def.begin(), def.end(), df);
@@ -170,11 +174,21 @@ void Bottom::Reindex(IndexLevel *indexLevel) {
    @return vector of splitting signatures, possibly empty, for each node passed.
  */
 void Bottom::Split(IndexLevel &index, std::vector<SSNode> &argMax) {
+  TrainStat::Clock start = TrainStat::Now();
   unsigned int supUnFlush = FlushRear();
+  trainStat.Accum(TrainStat::flushRear, start);
   splitPred->LevelInit(index);
 
+  start = TrainStat::Now();
   Backdate();
+  trainStat.Accum(TrainStat::backdate, start);
+
+  LevelCount &census = trainStat.Front();
+  census.restaged += restageCoord.size();
+  census.nodeRel += nodeRel;
+  start = TrainStat::Now();
   Restage();
+  trainStat.Accum(TrainStat::restage, start);
 
   // Reaching levels must persist through restaging ut allow path lookup.
   //
@@ -182,7 +196,9 @@ void Bottom::Split(IndexLevel &index, std::vector<SSNode> &argMax) {
     delete level[off];
     level.pop_back();
   }
+  start = TrainStat::Now();
   splitPred->ScheduleSplits(index);
+  trainStat.Accum(TrainStat::scheduleSplits, start);
   splitPred->Split(argMax);
 }
 
@@ -395,17 +411,28 @@ bool Bottom::ScheduleSplit(unsigned int levelIdx, unsigned int predIdx, unsigned
 
 /**
    @brief Restages predictors and splits as pairs with equal priority.
+   Pairs too large to share a thread, as arise near the root when
+   predictors are few, are first restaged singly, each divided among
+   threads.
 
    @return void, with side-effected restaging buffers.
  */
 void Bottom::Restage() {
+  std::vector<unsigned int> chunkCount(restageCoord.size());
+  trainStat.Front().chunked += RestageChunks(chunkCount);
+  for (unsigned int coordIdx = 0; coordIdx < restageCoord.size(); coordIdx++) {
+    if (chunkCount[coordIdx] > 1)
+      Restage(restageCoord[coordIdx], chunkCount[coordIdx]);
+  }
+
   int nodeIdx;
 
 #pragma omp parallel default(shared) private(nodeIdx)
   {
 #pragma omp for schedule(dynamic, 1)
     for (nodeIdx = 0; nodeIdx < int(restageCoord.size()); nodeIdx++) {
-      Restage(restageCoord[nodeIdx]);
+      if (chunkCount[nodeIdx] == 1)
+        Restage(restageCoord[nodeIdx], 1);
     }
   }
 
@@ -413,23 +440,73 @@ void Bottom::Restage() {
 }
 
 
+/**
+   @brief Determines how many chunks each pair is to be divided into.  A
+   pair is divided only if it exceeds a thread's share of the level's
+   indices, and then into chunks no smaller than 'chunkMin'.  Within a
+   parallel region, as when trees are trained concurrently, pairs are
+   divided only if a nested team would be active.
+
+   @param chunkCount outputs the chunk count of each pair.
+
+   @return count of pairs divided.
+ */
+unsigned int Bottom::RestageChunks(std::vector<unsigned int> &chunkCount) {
+  std::fill(chunkCount.begin(), chunkCount.end(), 1);
+  unsigned int threadCount = 1;
+#ifdef _OPENMP
+  threadCount = omp_get_active_level() < omp_get_max_active_levels() ? omp_get_max_threads() : 1;
+#endif
+  if (threadCount == 1)
+    return 0;
+
+  std::vector<unsigned int> extent(restageCoord.size());
+  unsigned long extentTot = 0;
+  for (unsigned int coordIdx = 0; coordIdx < restageCoord.size(); coordIdx++) {
+    SPPair mrra;
+    unsigned int del, bufIdx, startIdx;
+    restageCoord[coordIdx].Ref(mrra, del, bufIdx);
+    Bounds(mrra, del, startIdx, extent[coordIdx]);
+    extentTot += extent[coordIdx];
+  }
+
+  unsigned int chunked = 0;
+  for (unsigned int coordIdx = 0; coordIdx < restageCoord.size(); coordIdx++) {
+    if ((unsigned long) extent[coordIdx] * threadCount > extentTot) {
+      chunkCount[coordIdx] = std::max(1u, std::min(2 * threadCount, extent[coordIdx] / chunkMin));
+      chunked += chunkCount[coordIdx] > 1 ? 1 : 0;
+    }
+  }
+
+  return chunked;
+}
+
+
 /**
    @brief General, multi-level restaging.
+
+   @param chunkCount is the number of chunks into which to divide the pair.
  */
-void Bottom::Restage(RestageCoord &rsCoord) {
+void Bottom::Restage(RestageCoord &rsCoord, unsigned int chunkCount) {
   unsigned int del, bufIdx;
   SPPair mrra;
   rsCoord.Ref(mrra, del, bufIdx);
 
   unsigned int reachOffset[1 << NodePath::pathMax];
-  if (level[del]->NodeRel()) { // Both levels employ node-relative indexing.
-    unsigned int reachBase[1 << NodePath::pathMax];
+  unsigned int reachBase[1 << NodePath::pathMax];
+  bool nodeRelSource = level[del]->NodeRel(); // Both levels node-relative.
+  if (nodeRelSource) {
     OffsetClone(mrra, del, reachOffset, reachBase);
-    Restage(mrra, bufIdx, del, reachBase, reachOffset);
   }
   else { // Source level employs subtree indexing.  Target may or may not.
     OffsetClone(mrra, del, reachOffset);
-    Restage(mrra, bufIdx, del, nullptr, reachOffset);
+  }
+
+  if (chunkCount > 1) {
+    RestageChunked(mrra, bufIdx, del, nodeRelSource ? reachBase : nullptr, reachOffset, chunkCount);
+  }
+  else {
+    Restage(mrra, bufIdx, del, nodeRelSource ? reachBase : nullptr, reachOffset);
   }
 }
 
@@ -494,6 +571,97 @@ void Bottom::Restage(const SPPair &mrra, unsigned int bufIdx, unsigned int del,
 }
 
 
+/**
+   @brief Restages a single pair as a parallel stable partition.  Chunks
+   first tabulate their paths independently.  Each chunk's target
+   offsets then follow those of its predecessors along every path, so
+   that the scatter preserves rank order.  Rank runs counted separately
+   by adjacent chunks are merged where they meet in the target.
+
+   @param chunkCount is the number of chunks, exceeding one.
+
+   @return void.
+ */
+void Bottom::RestageChunked(const SPPair &mrra, unsigned int bufIdx, unsigned int del, const unsigned int reachBase[], unsigned int reachOffset[], unsigned int chunkCount) {
+  unsigned int startIdx, extent;
+  Bounds(mrra, del, startIdx, extent);
+
+  const unsigned int pathTot = level[del]->BackScale(1);
+  const unsigned int predIdx = mrra.second;
+  const IdxPath *idxPath = level[del]->NodeRel() ?  FrontPath(del) : stPath;
+  const bool idxUpdate = reachBase == nullptr ? nodeRel : true;
+  const unsigned int pathMask = PathMask(del);
+  const unsigned int chunkSize = (extent + chunkCount - 1) / chunkCount;
+  std::vector<unsigned int> chunkPath(chunkCount * pathTot); // Zero-filled.
+
+  int chunk;
+#pragma omp parallel default(shared) private(chunk)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (chunk = 0; chunk < int(chunkCount); chunk++) {
+      unsigned int chunkStart = std::min(extent, chunk * chunkSize);
+      unsigned int chunkExtent = std::min(extent - chunkStart, chunkSize);
+      samplePred->Prepath(idxPath, reachBase, predIdx, bufIdx, startIdx + chunkStart, chunkExtent, pathMask, idxUpdate, &chunkPath[chunk * pathTot]);
+    }
+  }
+
+  unsigned int pathCount[1 << NodePath::pathMax];
+  for (unsigned int path = 0; path < pathTot; path++) {
+    pathCount[path] = 0;
+    for (unsigned int chunkIdx = 0; chunkIdx < chunkCount; chunkIdx++) {
+      pathCount[path] += chunkPath[chunkIdx * pathTot + path];
+    }
+  }
+
+  // Successors may or may not themselves be dense.
+  if (DensePlacement(mrra, del)) {
+    level[del]->PackDense(startIdx, pathCount, levelFront, mrra, reachOffset);
+  }
+
+  // Exclusive prefix sum over chunks, by path.
+  std::vector<unsigned int> chunkOffset(chunkCount * pathTot);
+  for (unsigned int path = 0; path < pathTot; path++) {
+    unsigned int offset = reachOffset[path];
+    for (unsigned int chunkIdx = 0; chunkIdx < chunkCount; chunkIdx++) {
+      chunkOffset[chunkIdx * pathTot + path] = offset;
+      offset += chunkPath[chunkIdx * pathTot + path];
+    }
+  }
+
+  std::vector<unsigned int> chunkRank(chunkCount * pathTot);
+#pragma omp parallel default(shared) private(chunk)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (chunk = 0; chunk < int(chunkCount); chunk++) {
+      unsigned int chunkStart = std::min(extent, chunk * chunkSize);
+      unsigned int chunkExtent = std::min(extent - chunkStart, chunkSize);
+      unsigned int rankPrev[1 << NodePath::pathMax];
+      for (unsigned int path = 0; path < pathTot; path++) {
+        rankPrev[path] = rowRank->NoRank();
+      }
+      samplePred->RestageRank(predIdx, bufIdx, startIdx + chunkStart, chunkExtent, &chunkOffset[chunk * pathTot], rankPrev, &chunkRank[chunk * pathTot]);
+    }
+  }
+
+  // A chunk's leading run along a path continues its predecessor's
+  // trailing run if their ranks agree at the junction.
+  SPCol targ = samplePred->PredBase(predIdx, 1 - bufIdx);
+  unsigned int rankCount[1 << NodePath::pathMax];
+  for (unsigned int path = 0; path < pathTot; path++) {
+    rankCount[path] = chunkRank[path];
+    for (unsigned int chunkIdx = 1; chunkIdx < chunkCount; chunkIdx++) {
+      unsigned int junction = chunkOffset[(chunkIdx - 1) * pathTot + path]; // Advanced by restaging.
+      rankCount[path] += chunkRank[chunkIdx * pathTot + path];
+      if (chunkPath[chunkIdx * pathTot + path] > 0 && junction > reachOffset[path] && targ.Rank(junction) == targ.Rank(junction - 1)) {
+        rankCount[path]--;
+      }
+    }
+    reachOffset[path] = chunkOffset[(chunkCount - 1) * pathTot + path];
+  }
+  level[del]->RunCounts(this, mrra, pathCount, rankCount);
+}
+
+
 /**
    @brief Sets the packed offsets for each successor.  Relies on Swiss Cheese
    index numbering ut prevent cell boundaries from crossing.
@@ -612,7 +780,7 @@ void Bottom::LevelPrepare(unsigned int splitNext, unsigned int idxLive, unsigned
   history = std::move(std::vector<unsigned int>(splitCount * (level.size()-1)));
 
   deltaPrev = std::move(levelDelta);
-  levelDelta = std::move(std::vector<unsigned char>(splitCount * nPred));
+  levelDelta = std::move(std::vector<unsigned char>(size_t(splitCount) * nPred));
 
   runCount = std::move(std::vector<unsigned int>(splitCount * nPredFac));
   std::fill(runCount.begin(), runCount.end(), 0);
@@ -22,6 +22,8 @@
 #include <vector>
 #include <map>
 
+#include "trainstat.h"
+
 
 /**
    @brief Coordinates from ancestor IndexSet.
@@ -252,13 +254,14 @@ class Level {
 
 
   /**
-     @brief Will overflow if level sufficiently fat.
-     TODO:  switch to depth-first in such regimes.
+     @brief Pair-indexed state, such as 'def', is sized by split count
+     times predictor count, as levels are built breadth-first throughout.
+     Offsets are computed in size_t, so wide levels do not overflow.
 
      @return offset strided by 'nPred'.
    */
-  inline unsigned int PairOffset(unsigned int mrraIdx, unsigned int predIdx) const {
-    return mrraIdx * nPred + predIdx;
+  inline size_t PairOffset(unsigned int mrraIdx, unsigned int predIdx) const {
+    return size_t(mrraIdx) * nPred + predIdx;
   }
 
 
@@ -267,8 +270,8 @@ class Level {
 
      @return offset strided by 'nPredDense'.
    */
-  inline unsigned int DenseOffset(unsigned int mrraIdx, unsigned int predIdx) const {
-    return mrraIdx * nPredDense + denseIdx[predIdx];
+  inline size_t DenseOffset(unsigned int mrraIdx, unsigned int predIdx) const {
+    return size_t(mrraIdx) * nPredDense + denseIdx[predIdx];
   }
 
   
@@ -448,6 +451,7 @@ class Bottom {
   bool nodeRel; // Subtree- or node-relative indexing.  Sticky, once node-.
 
   static constexpr double efficiency = 0.15; // Work efficiency threshold.
+  static const unsigned int chunkMin = 1 << 15; // Fewest indices restaged by a thread.
 
   IdxPath *stPath; // IdxPath accessed by subtree.
   unsigned int splitPrev;
@@ -461,17 +465,20 @@ class Bottom {
   class BV *replayExpl; // Whether sample employs explicit replay.
   std::vector<unsigned int> history;
   std::vector<unsigned int> historyPrev;
-  std::vector<unsigned char> levelDelta;
+  std::vector<unsigned char> levelDelta; // splitCount x nPred, as is 'deltaPrev'.
   std::vector<unsigned char> deltaPrev;
   Level *levelFront; // Current level.
   std::vector<unsigned int> runCount;
   std::deque<Level *> level;
   
   std::vector<RestageCoord> restageCoord;
+  TrainStat trainStat; // Per-tree instrumentation.
 
   // Restaging methods.
-  void Restage(RestageCoord &rsCoord);
+  unsigned int RestageChunks(std::vector<unsigned int> &chunkCount);
+  void Restage(RestageCoord &rsCoord, unsigned int chunkCount);
   void Restage(const SPPair &mrra, unsigned int bufIdx, unsigned int del, const unsigned int reachBase[], unsigned int reachOffset[]);
+  void RestageChunked(const SPPair &mrra, unsigned int bufIdx, unsigned int del, const unsigned int reachBase[], unsigned int reachOffset[], unsigned int chunkCount);
   void Backdate() const;
 
   
@@ -479,8 +486,8 @@ class Bottom {
      @brief Increments reaching levels for all pairs involving node.
    */
   inline void Inherit(unsigned int levelIdx, unsigned int par) {
-    unsigned char *colCur = &levelDelta[levelIdx * nPred];
-    unsigned char *colPrev = &deltaPrev[par * nPred];
+    unsigned char *colCur = &levelDelta[size_t(levelIdx) * nPred];
+    unsigned char *colPrev = &deltaPrev[size_t(par) * nPred];
     for (unsigned int predIdx = 0; predIdx < nPred; predIdx++) {
       colCur[predIdx] = colPrev[predIdx] + 1;
     }
@@ -504,8 +511,8 @@ class Bottom {
   bool Preschedule(unsigned int levelIdx, unsigned int predIdx, unsigned int &bufIdx);
   bool ScheduleSplit(unsigned int levelIdx, unsigned int predIdx, unsigned int &rCount) const;
 
-  static Bottom *FactoryReg(const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int _bagCount);
-  static Bottom *FactoryCtg(const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, const std::vector<class SampleNode> &_sampleCtg, unsigned int _bagCount);
+  static Bottom *FactoryReg(const class TrainContext &_trainCtx, const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int _bagCount, unsigned int _tIdx);
+  static Bottom *FactoryCtg(const class TrainContext &_trainCtx, const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, const std::vector<class SampleNode> &_sampleCtg, unsigned int _bagCount, unsigned int _tIdx);
   
   Bottom(const class PMTrain *_pmTrain, class SamplePred *_samplePred, const class RowRank *_rowRank, class SplitPred *_splitPred, unsigned int _bagCount);
   ~Bottom();
@@ -549,6 +556,14 @@ class Bottom {
   }
 
 
+  /**
+     @brief Accessor for the tree's instrumentation.
+   */
+  inline TrainStat &Stat() {
+    return trainStat;
+  }
+
+
   inline bool DensePlacement(const SPPair &mrra, unsigned int del = 0) const {
     return level[del]->Dense(mrra.first, mrra.second);
   }
@@ -576,7 +591,7 @@ class Bottom {
    */
   inline void AddDef(unsigned int reachIdx, unsigned int predIdx, unsigned int bufIdx, bool singleton) {
     if (levelFront->Define(reachIdx, predIdx, bufIdx, singleton)) {
-      levelDelta[reachIdx * nPred + predIdx] = 0;
+      levelDelta[size_t(reachIdx) * nPred + predIdx] = 0;
     }
   }
   
@@ -595,8 +610,23 @@ class Bottom {
   }
 
 
+  /**
+     @brief Looks up the parent of a front-level node.
+
+     @param parIdx outputs the parent's index at the previous level.
+
+     @return true iff the node has a parent, with output reference parameter.
+   */
+  inline bool Parent(unsigned int levelIdx, unsigned int &parIdx) const {
+    if (history.size() < splitCount)
+      return false;
+    parIdx = history[levelIdx];
+    return true;
+  }
+
+
   inline unsigned int ReachLevel(unsigned int levelIdx, unsigned int predIdx) {
-    return levelDelta[levelIdx * nPred + predIdx];
+    return levelDelta[size_t(levelIdx) * nPred + predIdx];
   }
 
   
@@ -192,6 +192,14 @@ class BitMatrix : public BV {
   }
 
 
+  /**
+     @return true iff the matrix has no columns, as when not validating.
+   */
+  inline bool Empty() const {
+    return stride == 0;
+  }
+
+
   /**
      @brief Bit test with short-circuit for zero-length matrix.
 
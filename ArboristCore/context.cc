@@ -0,0 +1,105 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file context.cc
+
+   @brief Methods for building and revising the training context.
+
+   @author Mark Seligman
+ */
+
+#include "context.h"
+#include "samplepred.h"
+#include "pretree.h"
+
+#include <algorithm>
+#include <numeric>
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Caches front-end parameters and derives the quantities formerly
+   computed by the static initializers of the training classes.
+
+   @param minNode is the minimal index node size on which to split.
+
+   @param minRatio is a threshold ratio for determining whether to split.
+
+   @param totLevels, if positive, limits the number of levels to build.
+
+   @param seed keys the generator of row samples and predictor selection.
+
+   @param treeConcurrent is true iff the trees of a block are trained
+   concurrently.
+
+   @param binMax, if positive, selects histogram splitting of numeric
+   predictors over at most this many bins.  Capped at 2^16.  Regression
+   only:  front ends reject positive values for categorical responses.
+   Applies to unconstrained numeric predictors without an implicit
+   (compressed) rank.  Only the cut search is bounded by the bin count,
+   as binned predictors are still restaged and accumulated per sample.
+
+   @param spillDir, if nonempty, names a directory in which to map the
+   rank orderings and staged samples onto files.
+ */
+TrainContext::TrainContext(unsigned int _nPred, unsigned int _nTree, unsigned int _nSamp, const std::vector<double> &_feSampleWeight, bool _withRepl, unsigned int _seed, unsigned int _trainBlock, unsigned int _minNode, double _minRatio, unsigned int _totLevels, unsigned int _ctgWidth, unsigned int _predFixed, const double _splitQuant[], const double _predProb[], bool _thinLeaves, const double _regMono[], bool _treeConcurrent, unsigned int _binMax, const std::string &_spillDir) : nPred(_nPred), nTree(_nTree), nRow(_feSampleWeight.size()), nSamp(_nSamp), withRepl(_withRepl), prng(PRNG(_seed)), trainBlock(_trainBlock), treeConcurrent(_treeConcurrent), binMax(std::min(_binMax, 1u << 16)), spillDir(_spillDir), minNode(_minNode), minRatio(_minRatio), totLevels(_totLevels), ctgWidth(_ctgWidth), ctgShift(SPCol::CtgShift(_ctgWidth)), predFixed(_predFixed), predProb(std::vector<double>(_predProb, _predProb + nPred)), splitQuant(std::vector<double>(_splitQuant, _splitQuant + nPred)), predMono(0), thinLeaves(_thinLeaves), heightEst(PreTree::HeightEst(_nSamp, _minNode)) {
+  // Weights are normalized and retained only if nonuniform.
+  double weightSum = 0.0;
+  bool uniform = true;
+  for (auto weight : _feSampleWeight) {
+    weightSum += weight;
+    uniform = uniform && weight == _feSampleWeight[0];
+  }
+  if (!uniform) {
+    rowWeight.assign(nRow, 0.0);
+    for (unsigned int row = 0; row < nRow; row++) {
+      rowWeight[row] = _feSampleWeight[row] / weightSum;
+    }
+    if (withRepl) {
+      rowCum.assign(nRow, 0.0);
+      std::partial_sum(rowWeight.begin(), rowWeight.end(), rowCum.begin());
+    }
+  }
+
+  // Monotonicity constraints apply only to regression.
+  if (ctgWidth == 0 && _regMono != 0) {
+    regMono.assign(_regMono, _regMono + nPred);
+    for (auto monoProb : regMono) {
+      predMono += monoProb != 0.0;
+    }
+  }
+}
+
+
+/**
+   @brief Refines the pre-tree height estimate using the actual height of
+   a constructed PreTree.
+
+   @param height is an actual height value.
+
+   @return void.
+ */
+void TrainContext::HeightReserve(unsigned int height) {
+  while (heightEst <= height) // Assigns next power-of-two above 'height'.
+    heightEst <<= 1;
+}
+
+
+/**
+   @brief Merges a completed tree's instrumentation into the job's.
+   Invoked serially, once a block's trees have been returned.
+
+   @param treeStat is the tree's accumulation.
+
+   @return void.
+ */
+void TrainContext::StatAccum(const TrainStat &treeStat) {
+  trainStat.Accum(treeStat);
+}
@@ -0,0 +1,213 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file context.h
+
+   @brief Per-job training configuration, replacing class-static state.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_CONTEXT_H
+#define ARBORIST_CONTEXT_H
+
+#include <vector>
+#include <string>
+
+#include "prng.h"
+#include "trainstat.h"
+
+/**
+   @brief Collects the parameters of a single training job, together with
+   quantities derived from them.
+
+   Training objects hold a reference to the context rather than consulting
+   statics, so that several jobs may train concurrently within a single
+   process.
+ */
+class TrainContext {
+  const unsigned int nPred;
+  const unsigned int nTree;
+  const unsigned int nRow;
+  const unsigned int nSamp;
+  const bool withRepl;
+  std::vector<double> rowWeight; // Normalized, empty iff uniform.
+  std::vector<double> rowCum; // Weighted w/ replacement:  CDF.
+  const PRNG prng;
+  const unsigned int trainBlock; // Front-end defined buffer size.
+  const bool treeConcurrent; // Whether trees in a block train concurrently.
+  const unsigned int binMax; // Numeric histogram width; zero iff exact splitting.
+  const std::string spillDir; // Backs large training structures; empty iff heap.
+  const unsigned int minNode;
+  const double minRatio;
+  const unsigned int totLevels;
+  const unsigned int ctgWidth;
+  unsigned int ctgShift; // Pack:  nonzero iff categorical response.
+  const unsigned int predFixed;
+  std::vector<double> predProb;
+  std::vector<double> splitQuant;
+  std::vector<double> regMono;
+  unsigned int predMono; // # predictors with monotone constraint.
+  const bool thinLeaves;
+  unsigned int heightEst; // Not really immutable:  revised after first block.
+  TrainStat trainStat; // Instrumentation, merged from trees.
+
+ public:
+  TrainContext(unsigned int _nPred, unsigned int _nTree, unsigned int _nSamp, const std::vector<double> &_feSampleWeight, bool _withRepl, unsigned int _seed, unsigned int _trainBlock, unsigned int _minNode, double _minRatio, unsigned int _totLevels, unsigned int _ctgWidth, unsigned int _predFixed, const double _splitQuant[], const double _predProb[], bool _thinLeaves, const double _regMono[] = 0, bool _treeConcurrent = false, unsigned int _binMax = 0, const std::string &_spillDir = std::string());
+
+  void HeightReserve(unsigned int height);
+  void StatAccum(const TrainStat &treeStat);
+
+  inline unsigned int NPred() const {
+    return nPred;
+  }
+
+
+  inline unsigned int NTree() const {
+    return nTree;
+  }
+
+
+  inline unsigned int NRow() const {
+    return nRow;
+  }
+
+
+  inline unsigned int NSamp() const {
+    return nSamp;
+  }
+
+
+  inline bool WithRepl() const {
+    return withRepl;
+  }
+
+
+  inline const std::vector<double> &RowWeight() const {
+    return rowWeight;
+  }
+
+
+  inline const std::vector<double> &RowCum() const {
+    return rowCum;
+  }
+
+
+  /**
+     @brief Accessor for the job's generator.
+   */
+  inline const PRNG &Rand() const {
+    return prng;
+  }
+
+
+  inline unsigned int TrainBlock() const {
+    return trainBlock;
+  }
+
+
+  inline bool TreeConcurrent() const {
+    return treeConcurrent;
+  }
+
+
+  /**
+     @brief Accessor for the maximal number of bins into which numeric
+     predictors are quantized.  Consulted by regression only, and for
+     predictors lacking an implicit rank.
+
+     @return bin count, zero iff splitting walks every sample.
+   */
+  inline unsigned int BinMax() const {
+    return binMax;
+  }
+
+
+  /**
+     @brief Accessor for the directory of spill files.
+
+     @return directory path, empty iff training structures reside on the heap.
+   */
+  inline const std::string &SpillDir() const {
+    return spillDir;
+  }
+
+
+  inline unsigned int MinNode() const {
+    return minNode;
+  }
+
+
+  inline double MinRatio() const {
+    return minRatio;
+  }
+
+
+  inline unsigned int TotLevels() const {
+    return totLevels;
+  }
+
+
+  inline unsigned int CtgWidth() const {
+    return ctgWidth;
+  }
+
+
+  inline unsigned int CtgShift() const {
+    return ctgShift;
+  }
+
+
+  inline unsigned int PredFixed() const {
+    return predFixed;
+  }
+
+
+  inline const double *PredProb() const {
+    return &predProb[0];
+  }
+
+
+  inline const double *SplitQuant() const {
+    return &splitQuant[0];
+  }
+
+
+  /**
+     @return monotonicity vector, or null if regression not constrained.
+   */
+  inline const double *RegMono() const {
+    return predMono > 0 ? &regMono[0] : 0;
+  }
+
+
+  inline unsigned int PredMono() const {
+    return predMono;
+  }
+
+
+  inline bool ThinLeaves() const {
+    return thinLeaves;
+  }
+
+
+  inline unsigned int HeightEst() const {
+    return heightEst;
+  }
+
+
+  /**
+     @brief Accessor for the job's accumulated instrumentation.
+   */
+  inline const TrainStat &Stat() const {
+    return trainStat;
+  }
+};
+
+#endif
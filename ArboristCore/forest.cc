@@ -19,12 +19,23 @@
 #include "predblock.h"
 #include "rowrank.h"
 #include "predict.h"
+#include "quickscore.h"
+#include "binscore.h"
+
+#include "simd.h"
+
+#ifdef ARBORIST_SIMD
+#include <immintrin.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //#include <iostream>
 //using namespace std;
 
 
-const double *ForestNode::splitQuant = 0;
 
 
 /**
@@ -40,7 +51,18 @@ ForestTrain::~ForestTrain() {
 /**
    @brief Constructor for prediction.
 */
-Forest::Forest(const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facVec[], size_t _facLen, const unsigned int _facOrigin[], unsigned int _nFac, Predict *_predict) : forestNode(_forestNode), treeOrigin(_origin), nTree(_nTree), facSplit(new BVJagged(_facVec, _facLen, _facOrigin, _nFac)), predict(_predict), predMap(predict->PredMap())  {
+Forest::Forest(const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facVec[], size_t _facLen, const unsigned int _facOrigin[], unsigned int _nFac, Predict *_predict) : forestNode(_forestNode), treeOrigin(_origin), nTree(_nTree), facSplit(new BVJagged(_facVec, _facLen, _facOrigin, _nFac)), predict(_predict), predMap(predict->PredMap()), predMask(0), bumpShift(0), quickScore(0), binScore(0)  {
+  if (nTree == 0)
+    return;
+
+  unsigned int height = treeOrigin[nTree - 1] + TreeExtent(nTree - 1);
+  if (size_t(height) > size_t(predMap->NRow()) * nTree * compileDepth)
+    return;
+
+  if (predMap->NPredFac() == 0)
+    quickScore = QuickScore::Factory(forestNode, treeOrigin, nTree, height, predMap->NPredNum());
+  if (quickScore == 0 && !Compile(height) && predMap->NPredFac() == 0)
+    binScore = BinScore::Factory(forestNode, height, predMap->NPredNum());
 }
 
 
@@ -48,18 +70,35 @@ Forest::Forest(const ForestNode _forestNode[], const unsigned int _origin[], uns
  */ 
 Forest::~Forest() {
   delete facSplit;
+  delete quickScore;
+  delete binScore;
 }
 
 
 /**
-   @brief Dispatches prediction method based on available predictor types.
+   @brief Dispatches prediction method based on forest size and on
+   available predictor types.
 
    @param bag is the packed in-bag representation, if validating.
 
    @return void.
  */
 void Forest::PredictAcross(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
-  if (predMap->NPredFac() == 0)
+  if (binScore != 0)
+    binScore->BinBlock(predict, rowEnd - rowStart);
+
+  if (quickScore != 0) {
+    PredictAcrossQuick(rowStart, rowEnd, bag);
+  }
+  else if (!predNode.empty()) {
+    if (bag->Empty())
+      PredictCompact<false>(rowStart, rowEnd, bag);
+    else
+      PredictCompact<true>(rowStart, rowEnd, bag);
+  }
+  else if (TreeMajor())
+    PredictAcrossTree(rowStart, rowEnd, bag);
+  else if (predMap->NPredFac() == 0)
     PredictAcrossNum(rowStart, rowEnd, bag);
   else if (predMap->NPredNum() == 0)
     PredictAcrossFac(rowStart, rowEnd, bag);
@@ -68,6 +107,527 @@ void Forest::PredictAcross(unsigned int rowStart, unsigned int rowEnd, const cla
 }
 
 
+/**
+   @brief Determines whether the forest is too large for row-major
+   traversal to reuse cached nodes.  The final tree's extent is not
+   recorded, so size is judged from its predecessors.
+
+   @return true iff traversal is to proceed tree by tree.
+ */
+bool Forest::TreeMajor() const {
+  size_t nodeBytes = predNode.empty() ? sizeof(ForestNode) : sizeof(PredNode);
+  return nTree > 1 && size_t(treeOrigin[nTree - 1]) * nodeBytes > cacheBytes;
+}
+
+
+/**
+   @brief Derives the number of nodes in a tree.  The final tree's
+   extent is not recorded, so is measured by scanning for its furthest
+   child reference.
+
+   @param tIdx is the tree index.
+
+   @return count of nodes in the tree.
+ */
+unsigned int Forest::TreeExtent(unsigned int tIdx) const {
+  if (tIdx + 1 < nTree)
+    return treeOrigin[tIdx + 1] - treeOrigin[tIdx];
+
+  unsigned int origin = treeOrigin[tIdx];
+  unsigned int extent = 1;
+  for (unsigned int idx = 0; idx < extent; idx++) {
+    unsigned int pred, bump;
+    double num;
+    Ref(origin + idx, pred, bump, num);
+    if (bump != 0)
+      extent = std::max(extent, idx + bump + 2);
+  }
+
+  return extent;
+}
+
+
+/**
+   @brief Compiles the forest into compact prediction nodes, provided
+   that the trees are large enough to benefit and that every node can be
+   packed.  Nodes keep their positions, so that the breadth-first layout
+   of trained trees is preserved and child offsets are unchanged.
+
+   @param height is the total number of nodes.
+
+   @return true iff compact nodes are available for prediction.
+ */
+bool Forest::Compile(unsigned int height) {
+  if (size_t(height) * sizeof(ForestNode) < nTree * compileBytes)
+    return false;
+
+  unsigned int blockWidth = std::max(predMap->NPredNum(), predMap->NPredFac());
+  unsigned int predBits = 0;
+  while ((1ul << predBits) < blockWidth)
+    predBits++;
+  if (predBits + PredNode::flagBits >= 8 * sizeof(unsigned int))
+    return false;
+  predMask = (1ul << predBits) - 1;
+  bumpShift = predBits + PredNode::flagBits;
+
+  predNode.resize(height);
+  for (unsigned int idx = 0; idx < height; idx++) {
+    if (!predNode[idx].Init(forestNode[idx], predMap, predBits)) {
+      predNode.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/**
+   @brief Packs a trained node for prediction.
+
+   @param forestNode is the node to compile.
+
+   @param predMap maps predictor indices to block positions.
+
+   @param predBits is the width of the packed block index.
+
+   @return false iff the child offset is too wide to pack.
+ */
+bool PredNode::Init(const ForestNode &forestNode, const PMPredict *predMap, unsigned int predBits) {
+  unsigned int pred, bump;
+  double num;
+  forestNode.Ref(pred, bump, num);
+  if (bump == 0) {
+    split.offset = pred;
+    code = 0;
+    return true;
+  }
+
+  unsigned int bumpShift = predBits + flagBits;
+  if ((bump >> (8 * sizeof(unsigned int) - bumpShift)) != 0)
+    return false;
+
+  bool isFactor;
+  unsigned int blockIdx = predMap->BlockIdx(pred, isFactor);
+  code = (bump << bumpShift) | (blockIdx << flagBits);
+  if (isFactor) {
+    code |= facBit;
+    split.offset = (unsigned int) num;
+  }
+  else {
+    float numDown = num;
+    if (numDown > num)
+      numDown = -NextUp(-numDown);
+    split.num = numDown;
+    if (numDown != num)
+      code |= inexactBit;
+  }
+
+  return true;
+}
+
+
+/**
+   @brief Dispatches compact prediction on the available predictor types.
+
+   @param bag indexes out-of-bag rows, and is empty unless validating.
+
+   @return void.
+ */
+template<bool bagged>
+void Forest::PredictCompact(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
+  if (predMap->NPredFac() == 0)
+    PredictCompact<bagged, numMode>(rowStart, rowEnd, bag);
+  else if (predMap->NPredNum() == 0)
+    PredictCompact<bagged, facMode>(rowStart, rowEnd, bag);
+  else
+    PredictCompact<bagged, mixedMode>(rowStart, rowEnd, bag);
+}
+
+
+/**
+   @brief Multi-row prediction over compact nodes, specialized by
+   predictor types and by whether bagged rows are screened.
+
+   @param rowStart is the first row in the block.
+
+   @param rowEnd is the first row beyond the block.
+
+   @param bag indexes out-of-bag rows, if 'bagged'.
+
+   @return void.
+ */
+template<bool bagged, Forest::PredMode mode>
+void Forest::PredictCompact(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
+  if (TreeMajor()) {
+    unsigned int chunkRows = ChunkRows(rowEnd - rowStart);
+    unsigned int nChunk = (rowEnd - rowStart + chunkRows - 1) / chunkRows;
+    unsigned int nTile = predict->Fused() ? 1 : (nTree + treeTile - 1) / treeTile;
+    int task;
+
+#pragma omp parallel default(shared) private(task)
+    {
+#pragma omp for schedule(dynamic, 1)
+      for (task = 0; task < int(nTile * nChunk); task++) {
+        unsigned int tStart = (task / nChunk) * treeTile;
+        unsigned int tSup = predict->Fused() ? nTree : std::min(tStart + treeTile, nTree);
+        unsigned int rowFirst = rowStart + (task % nChunk) * chunkRows;
+        for (; tStart < tSup; tStart += treeTile)
+          CompactTile<bagged, mode>(tStart, std::min(tStart + treeTile, nTree), rowFirst, std::min(rowFirst + chunkRows, rowEnd), rowStart, bag);
+      }
+    }
+  }
+  else {
+    int row;
+
+#pragma omp parallel default(shared) private(row)
+    {
+#pragma omp for schedule(dynamic, 1)
+      for (row = int(rowStart); row < int(rowEnd); row++) {
+        CompactTile<bagged, mode>(0, nTree, row, row + 1, rowStart, bag);
+      }
+    }
+  }
+}
+
+
+/**
+   @brief Walks a tile of trees over a chunk of rows, tree-major, using
+   compact nodes.
+
+   @param tStart is the first tree in the tile.
+
+   @param tEnd is the first tree beyond the tile.
+
+   @param rowFirst is the first row in the chunk.
+
+   @param rowSup is the first row beyond the chunk.
+
+   @param rowStart is the first row in the block.
+
+   @param bag indexes out-of-bag rows, if 'bagged'.
+
+   @return void.
+ */
+template<bool bagged, Forest::PredMode mode>
+void Forest::CompactTile(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const {
+  for (unsigned int tIdx = tStart; tIdx < tEnd; tIdx++) {
+    for (unsigned int row = rowFirst; row < rowSup; row++) {
+      unsigned int blockRow = row - rowStart;
+      if (bagged && bag->TestBit(row, tIdx)) {
+        predict->BagIdx(blockRow, tIdx);
+      }
+      else {
+        predict->LeafIdx(blockRow, tIdx, LeafCompact<mode>(tIdx, mode == facMode ? 0 : predict->RowNum(blockRow), mode == numMode ? 0 : predict->RowFac(blockRow)));
+      }
+    }
+  }
+}
+
+
+/**
+   @brief Walks a single tree over compact nodes.  Numeric arguments
+   lying between an inexact threshold and its successor are resolved
+   against the exact threshold.
+
+   @param tIdx is the tree index.
+
+   @param rowNT is a numeric data array section corresponding to the row.
+
+   @param rowFT is a factor data array section corresponding to the row.
+
+   @return leaf index reached.
+ */
+template<Forest::PredMode mode>
+unsigned int Forest::LeafCompact(unsigned int tIdx, const double rowNT[], const unsigned int rowFT[]) const {
+  const PredNode *node = &predNode[0];
+  unsigned int idx = treeOrigin[tIdx];
+  while (node[idx].Nonterminal()) {
+    const PredNode &pn = node[idx];
+    unsigned int blockIdx = pn.BlockIdx(predMask);
+    unsigned int bump = pn.Bump(bumpShift);
+    if (mode == facMode || (mode == mixedMode && pn.IsFactor())) {
+      idx += facSplit->TestBit(tIdx, pn.Offset() + rowFT[blockIdx]) ? bump : bump + 1;
+    }
+    else {
+      double val = rowNT[blockIdx];
+      if (val <= pn.Num())
+        idx += bump;
+      else if (pn.Inexact() && val < PredNode::NextUp(pn.Num()))
+        idx += val <= forestNode[idx].Num() ? bump : bump + 1;
+      else
+        idx += bump + 1;
+    }
+  }
+
+  return node[idx].Offset();
+}
+
+
+/**
+   @brief Multi-row prediction walking each tree over a chunk of rows,
+   so that the tree's nodes remain cached across the chunk.  Tiles of
+   trees are spread across threads, tiles sharing trees scheduled
+   consecutively.  If leaves are scored as reached, a chunk's tiles are
+   instead walked in order by a single task, so that rows accumulate
+   their trees serially.
+
+   @param rowStart is the first row in the block.
+
+   @param rowEnd is the first row beyond the block.
+
+   @param bag indexes out-of-bag rows, and may be null.
+
+   @return void.
+ */
+void Forest::PredictAcrossTree(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
+  unsigned int chunkRows = ChunkRows(rowEnd - rowStart);
+  unsigned int nChunk = (rowEnd - rowStart + chunkRows - 1) / chunkRows;
+  unsigned int nTile = predict->Fused() ? 1 : (nTree + treeTile - 1) / treeTile;
+  int task;
+
+#pragma omp parallel default(shared) private(task)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (task = 0; task < int(nTile * nChunk); task++) {
+      unsigned int tStart = (task / nChunk) * treeTile;
+      unsigned int tSup = predict->Fused() ? nTree : std::min(tStart + treeTile, nTree);
+      unsigned int rowFirst = rowStart + (task % nChunk) * chunkRows;
+      for (; tStart < tSup; tStart += treeTile)
+        PredictTile(tStart, std::min(tStart + treeTile, nTree), rowFirst, std::min(rowFirst + chunkRows, rowEnd), rowStart, bag);
+    }
+  }
+}
+
+
+/**
+   @brief Sizes the row chunks of tree-major traversal.  Fused chunks
+   each carry all tiles, so are narrowed until every thread has one.
+
+   @param blockRows is the number of rows in the block.
+
+   @return rows per chunk.
+ */
+unsigned int Forest::ChunkRows(unsigned int blockRows) const {
+  if (!predict->Fused())
+    return rowChunk;
+
+  unsigned int nThread = 1;
+#ifdef _OPENMP
+  nThread = omp_get_max_threads();
+#endif
+  return std::min(rowChunk, (blockRows + nThread - 1) / nThread);
+}
+
+
+/**
+   @brief Walks a tile of trees over a chunk of rows, tree-major.
+
+   @param tStart is the first tree in the tile.
+
+   @param tEnd is the first tree beyond the tile.
+
+   @param rowFirst is the first row in the chunk.
+
+   @param rowSup is the first row beyond the chunk.
+
+   @param rowStart is the first row in the block.
+
+   @param bag indexes out-of-bag rows, and may be null.
+
+   @return void.
+ */
+void Forest::PredictTile(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const {
+  bool numOnly = predMap->NPredFac() == 0;
+  bool facOnly = predMap->NPredNum() == 0;
+  unsigned int rowScalar = numOnly ? PredictLanesNum(tStart, tEnd, rowFirst, rowSup, rowStart, bag) : rowFirst;
+  for (unsigned int tIdx = tStart; tIdx < tEnd; tIdx++) {
+    for (unsigned int row = rowScalar; row < rowSup; row++) {
+      unsigned int blockRow = row - rowStart;
+      if (bag->TestBit(row, tIdx)) {
+        predict->BagIdx(blockRow, tIdx);
+      }
+      else if (numOnly) {
+        predict->LeafIdx(blockRow, tIdx, binScore != 0 ? binScore->Leaf(treeOrigin[tIdx], blockRow) : LeafNum(tIdx, predict->RowNum(blockRow)));
+      }
+      else if (facOnly) {
+        predict->LeafIdx(blockRow, tIdx, LeafFac(tIdx, predict->RowFac(blockRow)));
+      }
+      else {
+        predict->LeafIdx(blockRow, tIdx, LeafMixed(tIdx, predict->RowNum(blockRow), predict->RowFac(blockRow)));
+      }
+    }
+  }
+}
+
+
+/**
+   @brief Multi-row prediction by bitvector scoring, with predictors of
+   only numeric type.  Each thread maintains the surviving leaves of
+   every tree for the row at hand.
+
+   @param rowStart is the first row in the block.
+
+   @param rowEnd is the first row beyond the block.
+
+   @param bag indexes out-of-bag rows, and may be null.
+
+   @return void.
+ */
+void Forest::PredictAcrossQuick(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
+  int row;
+
+#pragma omp parallel default(shared) private(row)
+  {
+    std::vector<unsigned long long> exitBits(nTree);
+#pragma omp for schedule(dynamic, 1)
+    for (row = int(rowStart); row < int(rowEnd); row++) {
+      unsigned int blockRow = row - rowStart;
+      quickScore->Exits(predict->RowNum(blockRow), &exitBits[0]);
+      for (unsigned int tIdx = 0; tIdx < nTree; tIdx++) {
+        if (bag->TestBit(row, tIdx)) {
+          predict->BagIdx(blockRow, tIdx);
+        }
+        else {
+          predict->LeafIdx(blockRow, tIdx, quickScore->Leaf(tIdx, exitBits[tIdx]));
+        }
+      }
+    }
+  }
+}
+
+
+#ifdef ARBORIST_SIMD
+
+namespace avx512 {
+static const int laneCount = 16;
+
+/**
+   @brief Walks a tree over sixteen consecutive rows at once, gathering
+   node fields and predictor values lane by lane.  Lanes reaching a
+   leaf are masked from further advance.  Gathers and extractions are
+   merged into zeroed registers, so that no lane is read undefined.
+
+   @param nodeBase is the tree's root.
+
+   @param rowBase is the numeric row section of the first row.
+
+   @param nPred is the row stride.
+
+   @param leaf outputs the leaf index reached, by lane.
+
+   @return void, with output parameter vector.
+ */
+ARBORIST_AVX512 static void LanesNum(const ForestNode *nodeBase, const double rowBase[], unsigned int nPred, unsigned int leaf[]) {
+  const int *nodeInt = reinterpret_cast<const int *>(nodeBase);
+  const double *nodeNum = reinterpret_cast<const double *>(nodeBase) + 1;
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512d zeroD = _mm512_setzero_pd();
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i rowOff = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(nPred));
+  __m512i idx = zero; // Node index, tree-relative.
+  __m512i bump = _mm512_mask_i32gather_epi32(zero, 0xffff, _mm512_maskz_slli_epi32(0xffff, idx, 2), nodeInt + 1, 4);
+  __mmask16 live = _mm512_test_epi32_mask(bump, bump);
+  while (live != 0) {
+    __m512i slot = _mm512_maskz_slli_epi32(0xffff, idx, 2);
+    __m512i pred = _mm512_mask_i32gather_epi32(zero, live, slot, nodeInt, 4);
+    __m512i numIdx = _mm512_maskz_slli_epi32(0xffff, idx, 1);
+    __m512i valIdx = _mm512_add_epi32(rowOff, pred);
+    __m256i numIdxLo = _mm512_maskz_extracti64x4_epi64(0xf, numIdx, 0);
+    __m256i numIdxHi = _mm512_maskz_extracti64x4_epi64(0xf, numIdx, 1);
+    __m256i valIdxLo = _mm512_maskz_extracti64x4_epi64(0xf, valIdx, 0);
+    __m256i valIdxHi = _mm512_maskz_extracti64x4_epi64(0xf, valIdx, 1);
+    __m512d numLo = _mm512_mask_i32gather_pd(zeroD, 0xff, numIdxLo, nodeNum, 8);
+    __m512d numHi = _mm512_mask_i32gather_pd(zeroD, 0xff, numIdxHi, nodeNum, 8);
+    __m512d valLo = _mm512_mask_i32gather_pd(zeroD, __mmask8(live), valIdxLo, rowBase, 8);
+    __m512d valHi = _mm512_mask_i32gather_pd(zeroD, __mmask8(live >> 8), valIdxHi, rowBase, 8);
+    __mmask16 left = __mmask16(_mm512_cmp_pd_mask(valLo, numLo, _CMP_LE_OQ)) | __mmask16(_mm512_cmp_pd_mask(valHi, numHi, _CMP_LE_OQ) << 8);
+    __m512i step = _mm512_mask_add_epi32(bump, ~left, bump, one);
+    idx = _mm512_mask_add_epi32(idx, live, idx, step);
+    bump = _mm512_mask_i32gather_epi32(zero, 0xffff, _mm512_maskz_slli_epi32(0xffff, idx, 2), nodeInt + 1, 4);
+    live = _mm512_test_epi32_mask(bump, bump);
+  }
+  _mm512_storeu_si512(leaf, _mm512_mask_i32gather_epi32(zero, 0xffff, _mm512_maskz_slli_epi32(0xffff, idx, 2), nodeInt, 4));
+}
+}
+
+
+namespace avx2 {
+static const int laneCount = 8;
+
+/**
+   @brief As above, over eight consecutive rows.  Gathers are masked
+   over zeroed registers, in the same fashion.
+
+   @return void, with output parameter vector.
+ */
+ARBORIST_AVX2 static void LanesNum(const ForestNode *nodeBase, const double rowBase[], unsigned int nPred, unsigned int leaf[]) {
+  const int *nodeInt = reinterpret_cast<const int *>(nodeBase);
+  const double *nodeNum = reinterpret_cast<const double *>(nodeBase) + 1;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256d zeroD = _mm256_setzero_pd();
+  const __m256d allD = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i evenFirst = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  const __m256i rowOff = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(nPred));
+  __m256i idx = zero; // Node index, tree-relative.
+  __m256i bump = _mm256_i32gather_epi32(nodeInt + 1, _mm256_slli_epi32(idx, 2), 4);
+  __m256i live = _mm256_xor_si256(_mm256_cmpeq_epi32(bump, zero), _mm256_set1_epi32(-1));
+  while (!_mm256_testz_si256(live, live)) {
+    __m256i slot = _mm256_slli_epi32(idx, 2);
+    __m256i pred = _mm256_and_si256(live, _mm256_i32gather_epi32(nodeInt, slot, 4));
+    __m256i numIdx = _mm256_slli_epi32(idx, 1);
+    __m256i valIdx = _mm256_add_epi32(rowOff, pred);
+    __m256d numLo = _mm256_mask_i32gather_pd(zeroD, nodeNum, _mm256_castsi256_si128(numIdx), allD, 8);
+    __m256d numHi = _mm256_mask_i32gather_pd(zeroD, nodeNum, _mm256_extracti128_si256(numIdx, 1), allD, 8);
+    __m256d valLo = _mm256_mask_i32gather_pd(zeroD, rowBase, _mm256_castsi256_si128(valIdx), allD, 8);
+    __m256d valHi = _mm256_mask_i32gather_pd(zeroD, rowBase, _mm256_extracti128_si256(valIdx, 1), allD, 8);
+
+    // Narrows each pair of 64-bit comparison masks to a 32-bit lane.
+    __m256i leftLo = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(_mm256_cmp_pd(valLo, numLo, _CMP_LE_OQ)), evenFirst);
+    __m256i leftHi = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(_mm256_cmp_pd(valHi, numHi, _CMP_LE_OQ)), evenFirst);
+    __m256i left = _mm256_inserti128_si256(leftLo, _mm256_castsi256_si128(leftHi), 1);
+
+    __m256i step = _mm256_add_epi32(_mm256_add_epi32(bump, one), left);
+    idx = _mm256_add_epi32(idx, _mm256_and_si256(live, step));
+    bump = _mm256_i32gather_epi32(nodeInt + 1, _mm256_slli_epi32(idx, 2), 4);
+    live = _mm256_xor_si256(_mm256_cmpeq_epi32(bump, zero), _mm256_set1_epi32(-1));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(leaf), _mm256_i32gather_epi32(nodeInt, _mm256_slli_epi32(idx, 2), 4));
+}
+}
+
+#endif
+
+typedef void (*LanesWalk)(const ForestNode *nodeBase, const double rowBase[], unsigned int nPred, unsigned int leaf[]);
+static const int laneMax = 16; // Widest walk compiled.
+
+
+/**
+   @brief Selects the widest lane walk supported by the host.
+
+   @param laneCount outputs the number of rows walked at once.
+
+   @return lane walk, or null if rows are to be walked singly.
+ */
+static LanesWalk LanesSelect(int &laneCount) {
+#ifdef ARBORIST_SIMD
+  switch (Simd::Level()) {
+  case Simd::avx512:
+    laneCount = avx512::laneCount;
+    return avx512::LanesNum;
+  case Simd::avx2:
+    laneCount = avx2::laneCount;
+    return avx2::LanesNum;
+  default:
+    break;
+  }
+#endif
+  laneCount = 1;
+  return 0;
+}
+
+
 /**
    @brief Multi-row prediction for regression tree, with predictors of only numeric.
 
@@ -76,18 +636,71 @@ void Forest::PredictAcross(unsigned int rowStart, unsigned int rowEnd, const cla
    @return Void with output vector parameter.
  */
 void Forest::PredictAcrossNum(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const {
+  int laneCount;
+  (void) LanesSelect(laneCount);
   int row;
 
 #pragma omp parallel default(shared) private(row)
   {
 #pragma omp for schedule(dynamic, 1)
-    for (row = int(rowStart); row < int(rowEnd); row++) {
-      PredictRowNum(row, predict->RowNum(row - rowStart), row - rowStart, bag);
+    for (row = int(rowStart); row < int(rowEnd); row += laneCount) {
+      unsigned int rowSup = std::min(row + laneCount, int(rowEnd));
+      for (unsigned int rowScalar = PredictLanesNum(0, nTree, row, rowSup, rowStart, bag); rowScalar < rowSup; rowScalar++) {
+        PredictRowNum(rowScalar, predict->RowNum(rowScalar - rowStart), rowScalar - rowStart, bag);
+      }
     }
   }
 }
 
 
+
+
+/**
+   @brief Walks a tile of trees over whole groups of rows, as many as the
+   host's vector instruction set permits.  Rows are walked tree-major
+   within the tile.
+
+   @param tStart is the first tree in the tile.
+
+   @param tEnd is the first tree beyond the tile.
+
+   @param rowFirst is the first row to walk.
+
+   @param rowSup is the first row beyond those to walk.
+
+   @param rowStart is the first row in the block.
+
+   @param bag indexes out-of-bag rows, and may be null.
+
+   @return first row remaining to be walked by scalar code.
+ */
+unsigned int Forest::PredictLanesNum(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const {
+  static_assert(sizeof(ForestNode) == 4 * sizeof(int), "Vector walk assumes 16-byte nodes");
+  int laneCount;
+  LanesWalk lanesNum = LanesSelect(laneCount);
+  if (lanesNum == 0 || binScore != 0)
+    return rowFirst;
+
+  unsigned int nPred = predMap->NPredNum();
+  unsigned int rowLanes = rowFirst + ((rowSup - rowFirst) / laneCount) * laneCount;
+  unsigned int leaf[laneMax];
+  for (unsigned int tIdx = tStart; tIdx < tEnd; tIdx++) {
+    for (unsigned int row = rowFirst; row < rowLanes; row += laneCount) {
+      lanesNum(&forestNode[treeOrigin[tIdx]], predict->RowNum(row - rowStart), nPred, leaf);
+      for (int lane = 0; lane < laneCount; lane++) {
+        if (bag->TestBit(row + lane, tIdx)) {
+          predict->BagIdx(row + lane - rowStart, tIdx);
+        }
+        else {
+          predict->LeafIdx(row + lane - rowStart, tIdx, leaf[lane]);
+        }
+      }
+    }
+  }
+  return rowLanes;
+}
+
+
 /**
    @brief Multi-row prediction for regression tree, with predictors of both numeric and factor type.
 
@@ -134,6 +747,83 @@ void Forest::PredictAcrossMixed(unsigned int rowStart, unsigned int rowEnd, cons
 }
 
 
+/**
+   @brief Walks a single tree over a row of numeric predictors.
+
+   @param tIdx is the tree index.
+
+   @param rowT is a numeric data array section corresponding to the row.
+
+   @return leaf index reached.
+ */
+unsigned int Forest::LeafNum(unsigned int tIdx, const double rowT[]) const {
+  unsigned int idx = treeOrigin[tIdx];
+  unsigned int bump;
+  unsigned int pred; // N.B.:  Use BlockIdx() if numericals not numbered from 0.
+  double num;
+  Ref(idx, pred, bump, num);
+  while (bump != 0) {
+    idx += (rowT[pred] <= num ? bump : bump + 1);
+    Ref(idx, pred, bump, num);
+  }
+
+  return pred;
+}
+
+
+/**
+   @brief Walks a single tree over a row of factor predictors.
+
+   @param tIdx is the tree index.
+
+   @param rowT is a factor data array section corresponding to the row.
+
+   @return leaf index reached.
+ */
+unsigned int Forest::LeafFac(unsigned int tIdx, const unsigned int rowT[]) const {
+  unsigned int idx = treeOrigin[tIdx];
+  unsigned int bump;
+  unsigned int pred; // N.B.: Use BlockIdx() if not factor-only (zero based).
+  double num;
+  Ref(idx, pred, bump, num);
+  while (bump != 0) {
+    unsigned int bitOff = (unsigned int) num + rowT[pred];
+    idx += facSplit->TestBit(tIdx, bitOff) ? bump : bump + 1;
+    Ref(idx, pred, bump, num);
+  }
+
+  return pred;
+}
+
+
+/**
+   @brief Walks a single tree over a row of mixed predictors.
+
+   @param tIdx is the tree index.
+
+   @param rowNT is a numeric data array section corresponding to the row.
+
+   @param rowFT is a factor data array section corresponding to the row.
+
+   @return leaf index reached.
+ */
+unsigned int Forest::LeafMixed(unsigned int tIdx, const double rowNT[], const unsigned int rowFT[]) const {
+  unsigned int idx = treeOrigin[tIdx];
+  unsigned int bump;
+  unsigned int pred;
+  double num;
+  Ref(idx, pred, bump, num);
+  while (bump != 0) {
+    bool isFactor;
+    unsigned int blockIdx = predMap->BlockIdx(pred, isFactor);
+    idx += isFactor ? (facSplit->TestBit(tIdx, (unsigned int) num + rowFT[blockIdx]) ? bump : bump + 1) : (rowNT[blockIdx] <= num ? bump : bump + 1);
+    Ref(idx, pred, bump, num);
+  }
+
+  return pred;
+}
+
+
 /**
    @brief Prediction with predictors of only numeric type.
 
@@ -152,17 +842,7 @@ void Forest::PredictRowNum(unsigned int row, const double rowT[], unsigned int b
       predict->BagIdx(blockRow, tIdx);
       continue;
     }
-
-    unsigned int idx = treeOrigin[tIdx];
-    unsigned int bump;
-    unsigned int pred; // N.B.:  Use BlockIdx() if numericals not numbered from 0.
-    double num;
-    Ref(idx, pred, bump, num);
-    while (bump != 0) {
-      idx += (rowT[pred] <= num ? bump : bump + 1);
-      Ref(idx, pred, bump, num);
-    }
-    predict->LeafIdx(blockRow, tIdx, pred);
+    predict->LeafIdx(blockRow, tIdx, binScore != 0 ? binScore->Leaf(treeOrigin[tIdx], blockRow) : LeafNum(tIdx, rowT));
   }
 }
 
@@ -184,18 +864,7 @@ void Forest::PredictRowFac(unsigned int row, const unsigned int rowT[], unsigned
       predict->BagIdx(blockRow, tIdx);
       continue;
     }
-
-    unsigned int idx = treeOrigin[tIdx];
-    unsigned int bump;
-    unsigned int pred; // N.B.: Use BlockIdx() if not factor-only (zero based).
-    double num;
-    Ref(idx, pred, bump, num);
-    while (bump != 0) {
-      unsigned int bitOff = (unsigned int) num + rowT[pred];
-      idx += facSplit->TestBit(tIdx, bitOff) ? bump : bump + 1;
-      Ref(idx, pred, bump, num);
-    }
-    predict->LeafIdx(blockRow, tIdx, pred);
+    predict->LeafIdx(blockRow, tIdx, LeafFac(tIdx, rowT));
   }
 }
 
@@ -219,19 +888,7 @@ void Forest::PredictRowMixed(unsigned int row, const double rowNT[], const unsig
       predict->BagIdx(blockRow, tIdx);
       continue;
     }
-
-    unsigned int idx = treeOrigin[tIdx];
-    unsigned int bump;
-    unsigned int pred;
-    double num;
-    Ref(idx, pred, bump, num);
-    while (bump != 0) {
-      bool isFactor;
-      unsigned int blockIdx = predMap->BlockIdx(pred, isFactor);
-      idx += isFactor ? (facSplit->TestBit(tIdx, (unsigned int) num + rowFT[blockIdx]) ? bump : bump + 1) : (rowNT[blockIdx] <= num ? bump : bump + 1);
-      Ref(idx, pred, bump, num);
-    }
-    predict->LeafIdx(blockRow, tIdx, pred);
+    predict->LeafIdx(blockRow, tIdx, LeafMixed(tIdx, rowNT, rowFT));
   }
 }
 
@@ -282,11 +939,13 @@ void ForestTrain::Origins(unsigned int tIdx) {
 
    @param rowRank holds the presorted predictor values.
 
+   @param splitQuant gives the per-predictor quantile at which to split.
+
    @return void
  */
-void ForestTrain::SplitUpdate(const PMTrain *pmTrain, const RowRank *rowRank) const {
+void ForestTrain::SplitUpdate(const PMTrain *pmTrain, const RowRank *rowRank, const double splitQuant[]) const {
   for (unsigned int i = 0; i < forestNode.size(); i++) {
-    forestNode[i].SplitUpdate(pmTrain, rowRank);
+    forestNode[i].SplitUpdate(pmTrain, rowRank, splitQuant);
   }
 }
 
@@ -296,9 +955,11 @@ void ForestTrain::SplitUpdate(const PMTrain *pmTrain, const RowRank *rowRank) co
 
    @param rowRank holds the presorted predictor values.
 
+   @param splitQuant gives the per-predictor quantile at which to split.
+
    @return void.
  */
-void ForestNode::SplitUpdate(const PMTrain *pmTrain, const RowRank *rowRank) {
+void ForestNode::SplitUpdate(const PMTrain *pmTrain, const RowRank *rowRank, const double splitQuant[]) {
   if (Nonterminal() && !pmTrain->IsFactor(pred)) {
     splitVal.num = rowRank->QuantRank(pred, splitVal.rankRange, splitQuant);
   }
@@ -27,7 +27,6 @@
    @brief To replace parallel array access.
  */
 class ForestNode {
-  static const double *splitQuant;
   unsigned int pred;
   unsigned int bump;
   union {
@@ -49,17 +48,7 @@ class ForestNode {
 
   
  public:
-  static void Immutables(const double _splitQuant[]) {
-    splitQuant = _splitQuant;
-  }
-
-  
-  static void DeImmutables() {
-    splitQuant = 0;
-  }
-  
-  
-  void SplitUpdate(const class PMTrain *pmTrain, const class RowRank *rowRank);
+  void SplitUpdate(const class PMTrain *pmTrain, const class RowRank *rowRank, const double splitQuant[]);
   static void Export(const unsigned int _nodeOrigin[], unsigned int _nTree, const ForestNode *_forestNode, unsigned int nodeEnd, std::vector<std::vector<unsigned int> > &_pred, std::vector<std::vector<unsigned int> > &_bump, std::vector<std::vector<double> > &_split);
 
   inline void Init() {
@@ -93,6 +82,11 @@ class ForestNode {
   }
 
 
+  inline double Num() const {
+    return splitVal.num;
+  }
+
+
   /**
      @return True iff bump value is nonzero.
    */
@@ -109,10 +103,109 @@ class ForestNode {
 };
 
 
+/**
+   @brief Compact prediction node, compiled from a ForestNode at the
+   same position.  Numeric thresholds are held in single precision,
+   rounded down, the exact value consulted only for arguments lying
+   strictly between the rounded threshold and its successor.  The
+   control word packs the child offset, block-relative predictor index
+   and flags, and is zero iff the node is terminal.
+ */
+class PredNode {
+  static const unsigned int facBit = 1; // Factor-valued predictor.
+  static const unsigned int inexactBit = 2; // Threshold rounded.
+  union {
+    float num; // Numeric threshold, rounded down.
+    unsigned int offset; // Factor bit offset, or leaf index if terminal.
+  } split;
+  unsigned int code;
+
+ public:
+  static const unsigned int flagBits = 2;
+
+  bool Init(const ForestNode &forestNode, const class PMPredict *predMap, unsigned int predBits);
+
+
+  inline bool Nonterminal() const {
+    return code != 0;
+  }
+
+
+  inline bool IsFactor() const {
+    return (code & facBit) != 0;
+  }
+
+
+  inline bool Inexact() const {
+    return (code & inexactBit) != 0;
+  }
+
+
+  inline unsigned int Bump(unsigned int bumpShift) const {
+    return code >> bumpShift;
+  }
+
+
+  inline unsigned int BlockIdx(unsigned int predMask) const {
+    return (code >> flagBits) & predMask;
+  }
+
+
+  inline float Num() const {
+    return split.num;
+  }
+
+
+  /**
+     @brief Successor of a finite or infinite single-precision value,
+     by adjustment of its representation.
+
+     @return least float exceeding 'val'.
+   */
+  static inline float NextUp(float val) {
+    union {
+      float f;
+      unsigned int bits;
+    } rep;
+    rep.f = val;
+    if (rep.bits == 0x80000000)
+      rep.bits = 1; // -0.0
+    else if ((rep.bits & 0x80000000) == 0)
+      rep.bits++;
+    else
+      rep.bits--;
+    return rep.f;
+  }
+
+
+  /**
+     @return factor bit offset, or leaf index if terminal.
+   */
+  inline unsigned int Offset() const {
+    return split.offset;
+  }
+};
+
+
 /**
    @brief The decision forest as a read-only collection.
 */
 class Forest {
+  // Tree-major traversal applies once the forest outgrows 'cacheBytes'.
+  // Work is then parcelled into tiles of 'treeTile' trees by 'rowChunk'
+  // rows, each tree walking its chunk of rows before yielding to the next.
+  static const size_t cacheBytes = 1 << 20;
+  static const unsigned int treeTile = 16;
+  static const unsigned int rowChunk = 1024;
+
+  // Compact nodes are compiled only once trees average 'compileBytes'
+  // of trained nodes, below which they already remain cached.  Numeric
+  // forests not compiled are instead binned.  No alternate form is built
+  // unless the forest has no more than 'compileDepth' nodes per tree
+  // walk, so that construction is amortized.
+  static const size_t compileBytes = 1 << 17;
+  static const unsigned int compileDepth = 16;
+
   const ForestNode *forestNode;
   const unsigned int *treeOrigin;
   const unsigned int nTree;
@@ -121,9 +214,33 @@ class Forest {
   class Predict *predict;
   const class PMPredict *predMap;
 
+  enum PredMode { numMode, facMode, mixedMode };
+
+  std::vector<PredNode> predNode; // Empty iff not compiled.
+  unsigned int predMask; // Block-relative predictor index mask.
+  unsigned int bumpShift; // Position of child offset within code.
+  class QuickScore *quickScore; // Bitvector scorer, if applicable.
+  class BinScore *binScore; // Binned numeric walker, if applicable.
+
+  bool Compile(unsigned int height);
+  unsigned int TreeExtent(unsigned int tIdx) const;
+  void PredictAcrossQuick(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
+  template<bool bagged> void PredictCompact(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
+  template<bool bagged, PredMode mode> void PredictCompact(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
+  template<bool bagged, PredMode mode> void CompactTile(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const;
+  template<PredMode mode> unsigned int LeafCompact(unsigned int tIdx, const double rowNT[], const unsigned int rowFT[]) const;
+
   void PredictAcrossNum(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
   void PredictAcrossFac(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
   void PredictAcrossMixed(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
+  bool TreeMajor() const;
+  unsigned int ChunkRows(unsigned int blockRows) const;
+  void PredictAcrossTree(unsigned int rowStart, unsigned int rowEnd, const class BitMatrix *bag) const;
+  void PredictTile(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const;
+  unsigned int PredictLanesNum(unsigned int tStart, unsigned int tEnd, unsigned int rowFirst, unsigned int rowSup, unsigned int rowStart, const class BitMatrix *bag) const;
+  unsigned int LeafNum(unsigned int tIdx, const double rowT[]) const;
+  unsigned int LeafFac(unsigned int tIdx, const unsigned int rowT[]) const;
+  unsigned int LeafMixed(unsigned int tIdx, const double rowNT[], const unsigned int rowFT[]) const;
 
 
   inline unsigned int NTree() const {
@@ -182,7 +299,7 @@ class ForestTrain {
   void Origins(unsigned int tIdx);
   void Reserve(unsigned int nodeEst, unsigned int facEst, double slop);
   void NodeInit(unsigned int treeHeight);
-  void SplitUpdate(const class PMTrain *pmTrain, const class RowRank *rowRank) const;
+  void SplitUpdate(const class PMTrain *pmTrain, const class RowRank *rowRank, const double splitQuant[]) const;
 
 
   /**
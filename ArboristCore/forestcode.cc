@@ -0,0 +1,217 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file forestcode.cc
+
+   @brief Methods emitting forest source and loading compiled scorers.
+
+   @author Mark Seligman
+ */
+
+#include "forestcode.h"
+#include "forest.h"
+#include "leaf.h"
+#include "bv.h"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Writes the source for a trained forest.
+
+   @param path names the source file to write.
+
+   @param nPredNum is the number of numeric predictors, which precede
+   the factors in predictor numbering.
+
+   @param ctgWidth is the response cardinality, zero iff regression.
+
+   @return true iff the source was written.
+ */
+bool ForestCode::Write(const std::string &path, const std::vector<ForestNode> &forestNode, const std::vector<unsigned int> &origin, const std::vector<unsigned int> &facSplit, const std::vector<unsigned int> &facOrigin, const std::vector<unsigned int> &leafOrigin, const std::vector<LeafNode> &leafNode, unsigned int nPredNum, unsigned int nPredFac, unsigned int ctgWidth) {
+  std::ofstream out(path.c_str(), std::ios::trunc);
+  if (!out)
+    return false;
+
+  unsigned int nTree = origin.size();
+  bool ctg = ctgWidth > 0;
+  out << "// Generated by ArboristCore:  " << nTree << (ctg ? " classification" : " regression") << " trees.\n\n";
+  out << "#include <limits>\n\n";
+
+  out << "static const unsigned int facBits[] = {";
+  for (unsigned int slot = 0; slot < facSplit.size(); slot++) {
+    out << (slot % 8 == 0 ? "\n  " : " ") << facSplit[slot] << "u,";
+  }
+  out << (facSplit.empty() ? " 0u" : "\n") << "};\n\n";
+  out << "static inline bool FacBit(unsigned int base, unsigned int pos) {\n";
+  out << "  return ((facBits[base + pos / " << BV::SlotElts() << "] >> (pos % " << BV::SlotElts() << ")) & 1u) != 0;\n";
+  out << "}\n\n";
+
+  for (unsigned int tIdx = 0; tIdx < nTree; tIdx++) {
+    unsigned int nodeEnd = tIdx + 1 < nTree ? origin[tIdx + 1] : forestNode.size();
+    Tree(out, forestNode, origin[tIdx], nodeEnd, facOrigin[tIdx], &leafNode[leafOrigin[tIdx]], nPredNum, tIdx);
+  }
+
+  out << "extern \"C\" {\n\n";
+  out << "unsigned int arborist_abi() {\n  return " << abiVersion << ";\n}\n\n";
+  out << "unsigned int arborist_shape(unsigned int *nPredNum, unsigned int *nPredFac) {\n";
+  out << "  *nPredNum = " << nPredNum << ";\n  *nPredFac = " << nPredFac << ";\n";
+  out << "  return " << ctgWidth << ";\n}\n\n";
+  if (ctg) {
+    out << "static void Vote(double score, double votes[]) {\n";
+    out << "  unsigned int ctg = score;\n  votes[ctg] += 1 + score - ctg;\n}\n\n";
+    out << "unsigned int arborist_classification(const double num[], const unsigned int fac[], double votes[]) {\n";
+    out << "  for (unsigned int ctg = 0; ctg < " << ctgWidth << "; ctg++)\n    votes[ctg] = 0.0;\n";
+    for (unsigned int tIdx = 0; tIdx < nTree; tIdx++) {
+      out << "  Vote(tree" << tIdx << "(num, fac), votes);\n";
+    }
+    out << "  int argMax = -1;\n  double scoreMax = 0.0;\n";
+    out << "  for (unsigned int ctg = 0; ctg < " << ctgWidth << "; ctg++) {\n";
+    out << "    if (votes[ctg] > scoreMax) {\n      scoreMax = votes[ctg];\n      argMax = ctg;\n    }\n  }\n";
+    out << "  return argMax;\n}\n\n";
+  }
+  else {
+    out << "double arborist_regression(const double num[], const unsigned int fac[]) {\n";
+    out << "  double score = 0.0;\n";
+    for (unsigned int tIdx = 0; tIdx < nTree; tIdx++) {
+      out << "  score += tree" << tIdx << "(num, fac);\n";
+    }
+    out << "  return score / " << nTree << ";\n}\n\n";
+  }
+  out << "}\n";
+  out.close();
+
+  return !out.fail();
+}
+
+
+/**
+   @brief Emits a single tree as a function returning its leaf score.
+   Nodes are labelled by tree-relative index, the root falling through.
+
+   @param nodeStart is the tree's first node.
+
+   @param nodeEnd is the first node beyond the tree.
+
+   @param facBase is the tree's offset into the factor splitting bits.
+
+   @param treeLeaf are the tree's leaves.
+
+   @return void.
+ */
+void ForestCode::Tree(std::ostream &out, const std::vector<ForestNode> &forestNode, unsigned int nodeStart, unsigned int nodeEnd, unsigned int facBase, const LeafNode *treeLeaf, unsigned int nPredNum, unsigned int tIdx) {
+  out << "static double tree" << tIdx << "(const double num[], const unsigned int fac[]) {\n";
+  for (unsigned int nodeIdx = 0; nodeIdx < nodeEnd - nodeStart; nodeIdx++) {
+    unsigned int pred, bump;
+    double num;
+    forestNode[nodeStart + nodeIdx].Ref(pred, bump, num);
+    if (nodeIdx > 0)
+      out << " n" << nodeIdx << ":\n";
+    if (bump == 0) {
+      out << "  return ";
+      Literal(out, treeLeaf[pred].GetScore());
+      out << ";\n";
+    }
+    else if (pred >= nPredNum) {
+      out << "  if (FacBit(" << facBase << "u, " << (unsigned int) num << "u + fac[" << pred - nPredNum << "]))";
+      out << " goto n" << nodeIdx + bump << ";\n  goto n" << nodeIdx + bump + 1 << ";\n";
+    }
+    else {
+      out << "  if (num[" << pred << "] <= ";
+      Literal(out, num);
+      out << ") goto n" << nodeIdx + bump << ";\n  goto n" << nodeIdx + bump + 1 << ";\n";
+    }
+  }
+  out << "}\n\n";
+}
+
+
+/**
+   @brief Emits a double literal which reads back exactly.
+
+   @return void.
+ */
+void ForestCode::Literal(std::ostream &out, double val) {
+  if (std::isinf(val)) {
+    out << (val < 0.0 ? "-" : "") << "std::numeric_limits<double>::infinity()";
+    return;
+  }
+
+  std::streamsize precision = out.precision(std::numeric_limits<double>::max_digits10);
+  out << val;
+  if (val == std::floor(val) && std::fabs(val) < 1.0e15)
+    out << ".0"; // Avoids integer literals.
+  out.precision(precision);
+}
+
+
+/**
+   @brief Private constructor:  wraps a library opened by 'Load'.
+ */
+ScoreLib::ScoreLib(void *_handle) : handle(_handle), nPredNum(0), nPredFac(0), ctgWidth(0), regFn(0), ctgFn(0) {
+}
+
+
+/**
+   @brief Closes the library.
+ */
+ScoreLib::~ScoreLib() {
+#if !defined(_WIN32)
+  dlclose(handle);
+#endif
+}
+
+
+/**
+   @brief Opens a compiled scorer, checking its ABI version and the
+   presence of the entry appropriate to its response.
+
+   @param path names the shared library.
+
+   @return new scorer, or null if the library cannot be used.
+ */
+ScoreLib *ScoreLib::Load(const std::string &path) {
+#if !defined(_WIN32)
+  void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle == 0)
+    return 0;
+
+  typedef unsigned int (*AbiFn)();
+  typedef unsigned int (*ShapeFn)(unsigned int *, unsigned int *);
+  AbiFn abiFn = reinterpret_cast<AbiFn>(dlsym(handle, "arborist_abi"));
+  ShapeFn shapeFn = reinterpret_cast<ShapeFn>(dlsym(handle, "arborist_shape"));
+  if (abiFn == 0 || shapeFn == 0 || abiFn() != ForestCode::abiVersion) {
+    dlclose(handle);
+    return 0;
+  }
+
+  ScoreLib *scoreLib = new ScoreLib(handle);
+  scoreLib->ctgWidth = shapeFn(&scoreLib->nPredNum, &scoreLib->nPredFac);
+  if (scoreLib->ctgWidth == 0)
+    scoreLib->regFn = reinterpret_cast<RegFn>(dlsym(handle, "arborist_regression"));
+  else
+    scoreLib->ctgFn = reinterpret_cast<CtgFn>(dlsym(handle, "arborist_classification"));
+  if (scoreLib->regFn == 0 && scoreLib->ctgFn == 0) {
+    delete scoreLib;
+    return 0;
+  }
+
+  return scoreLib;
+#else
+  return 0;
+#endif
+}
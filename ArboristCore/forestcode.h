@@ -0,0 +1,126 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file forestcode.h
+
+   @brief Translation of a trained forest into standalone C++ source,
+   and loading of the scorers compiled from it.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_FORESTCODE_H
+#define ARBORIST_FORESTCODE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/**
+   @brief Emits a forest as C++ source, one function per tree.  Each
+   node becomes a labelled branch, each leaf a return of its score.  The
+   source exports the scoring ABI below with C linkage, depending on
+   nothing beyond the standard library, so that it may be compiled
+   ahead of time into a shared library.
+
+   ABI, version 'abiVersion':
+
+     unsigned int arborist_abi();
+        Returns the ABI version.
+
+     unsigned int arborist_shape(unsigned int *nPredNum, unsigned int *nPredFac);
+        Reports the predictor counts and returns the response
+        cardinality, zero iff regression.
+
+     double arborist_regression(const double num[], const unsigned int fac[]);
+        Mean of the trees' leaf scores.
+
+     unsigned int arborist_classification(const double num[], const unsigned int fac[], double votes[]);
+        Accumulates jittered votes by category, as does prediction,
+        returning the winning category.
+
+   Predictor values are passed as for a single row of the transposed
+   prediction blocks:  numeric values by numeric index and factor
+   codes by factor index.
+ */
+class ForestCode {
+  static void Tree(std::ostream &out, const std::vector<class ForestNode> &forestNode, unsigned int nodeStart, unsigned int nodeEnd, unsigned int facBase, const class LeafNode *treeLeaf, unsigned int nPredNum, unsigned int tIdx);
+  static void Literal(std::ostream &out, double val);
+
+ public:
+  static const unsigned int abiVersion = 1;
+
+  static bool Write(const std::string &path, const std::vector<class ForestNode> &forestNode, const std::vector<unsigned int> &origin, const std::vector<unsigned int> &facSplit, const std::vector<unsigned int> &facOrigin, const std::vector<unsigned int> &leafOrigin, const std::vector<class LeafNode> &leafNode, unsigned int nPredNum, unsigned int nPredFac, unsigned int ctgWidth);
+};
+
+
+/**
+   @brief Scorer loaded from a shared library compiled from ForestCode
+   output.
+ */
+class ScoreLib {
+  typedef double (*RegFn)(const double[], const unsigned int[]);
+  typedef unsigned int (*CtgFn)(const double[], const unsigned int[], double[]);
+
+  void *handle;
+  unsigned int nPredNum;
+  unsigned int nPredFac;
+  unsigned int ctgWidth;
+  RegFn regFn;
+  CtgFn ctgFn;
+
+  ScoreLib(void *_handle);
+
+ public:
+  ~ScoreLib();
+  static ScoreLib *Load(const std::string &path);
+
+
+  inline unsigned int NPredNum() const {
+    return nPredNum;
+  }
+
+
+  inline unsigned int NPredFac() const {
+    return nPredFac;
+  }
+
+
+  /**
+     @return response cardinality, zero iff regression.
+   */
+  inline unsigned int CtgWidth() const {
+    return ctgWidth;
+  }
+
+
+  /**
+     @brief Scores a single row of a regression forest.
+
+     @return predicted response.
+   */
+  inline double Regression(const double num[], const unsigned int fac[]) const {
+    return regFn(num, fac);
+  }
+
+
+  /**
+     @brief Scores a single row of a classification forest.
+
+     @param votes outputs the jittered vote counts, by category.
+
+     @return predicted category.
+   */
+  inline unsigned int Classification(const double num[], const unsigned int fac[], double votes[]) const {
+    return ctgFn(num, fac, votes);
+  }
+};
+
+#endif
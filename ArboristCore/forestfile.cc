@@ -0,0 +1,242 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file forestfile.cc
+
+   @brief Methods for writing and mapping binary forest images.
+
+   @author Mark Seligman
+ */
+
+#include "forestfile.h"
+#include "forest.h"
+#include "leaf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//#include <iostream>
+//using namespace std;
+
+const char ForestFile::magic[8] = { 'A', 'R', 'B', 'F', 'R', 'S', 'T', '\0' };
+
+
+/**
+   @brief Private constructor:  wraps an image read by 'Load'.
+ */
+ForestFile::ForestFile(unsigned char *_base, size_t _bytes, bool _mapped) : base(_base), bytes(_bytes), mapped(_mapped), header(reinterpret_cast<const Header *>(base)) {
+}
+
+
+/**
+   @brief Releases the image.
+ */
+ForestFile::~ForestFile() {
+#if !defined(_WIN32)
+  if (mapped) {
+    munmap(base, bytes);
+    return;
+  }
+#endif
+  delete [] base;
+}
+
+
+/**
+   @brief Writes a section's elements as stored.  Suitable only for types
+   without padding.
+
+   @return void.
+ */
+template<typename T> static void WriteRecords(std::ofstream &out, const std::vector<T> &vec) {
+  out.write(reinterpret_cast<const char *>(&vec[0]), vec.size() * sizeof(T));
+}
+
+
+/**
+   @brief Writes leaves through zeroed records, in batches, as LeafNode
+   pads its extent to the alignment of its score.
+
+   @return void.
+ */
+template<> void WriteRecords(std::ofstream &out, const std::vector<LeafNode> &vec) {
+  static const size_t batch = 1024;
+  std::vector<unsigned char> rec(batch * sizeof(LeafNode));
+  for (size_t start = 0; start < vec.size(); start += batch) {
+    size_t end = std::min(start + batch, vec.size());
+    for (size_t idx = start; idx < end; idx++) {
+      vec[idx].Image(&rec[(idx - start) * sizeof(LeafNode)]);
+    }
+    out.write(reinterpret_cast<const char *>(&rec[0]), (end - start) * sizeof(LeafNode));
+  }
+}
+
+
+/**
+   @brief Appends a section to the image, padded to alignment.
+
+   @param out is the image stream.
+
+   @param vec holds the section's contents.
+
+   @param offset is the running image size, advanced past the section.
+
+   @param secOffset, count and eltSize output the section's placement.
+
+   @return void.
+ */
+template<typename T> static void WriteSection(std::ofstream &out, const std::vector<T> &vec, size_t align, uint64_t &offset, uint64_t &secOffset, uint64_t &count, uint32_t &eltSize) {
+  static const char zeros[64] = { 0 };
+  size_t pad = (align - offset % align) % align;
+  out.write(zeros, pad);
+  secOffset = offset + pad;
+  count = vec.size();
+  eltSize = sizeof(T);
+  if (!vec.empty()) {
+    WriteRecords(out, vec);
+  }
+  offset = secOffset + vec.size() * sizeof(T);
+}
+
+
+/**
+   @brief Writes an image of a trained forest.  Bag and bag-leaf sections
+   may be empty, as may either of the response-specific sections.
+
+   @param rowTrain is the number of training rows.
+
+   @param ctgWidth is the response cardinality, zero iff regression.
+
+   @return true iff the image was written in its entirety.
+ */
+bool ForestFile::Write(const std::string &path, const std::vector<class ForestNode> &forestNode, const std::vector<unsigned int> &origin, const std::vector<unsigned int> &facSplit, const std::vector<unsigned int> &facOrigin, const std::vector<unsigned int> &_leafOrigin, const std::vector<class LeafNode> &leafNode, const std::vector<class BagLeaf> &bagLeaf, const std::vector<unsigned int> &bagBits, const std::vector<double> &_yTrain, const std::vector<double> &weight, unsigned int rowTrain, unsigned int ctgWidth) {
+  std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
+
+  // The header is rewritten once the sections have been placed.
+  Header hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, magic, sizeof(magic));
+  hdr.version = version;
+  hdr.byteOrder = byteOrder;
+  hdr.nTree = origin.size();
+  hdr.rowTrain = rowTrain;
+  hdr.ctgWidth = ctgWidth;
+  hdr.nSection = sectionCount;
+
+  out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  uint64_t offset = sizeof(hdr);
+  SectionDesc *sec = hdr.section;
+  WriteSection(out, forestNode, align, offset, sec[forestNodeSec].offset, sec[forestNodeSec].count, sec[forestNodeSec].eltSize);
+  WriteSection(out, origin, align, offset, sec[originSec].offset, sec[originSec].count, sec[originSec].eltSize);
+  WriteSection(out, facSplit, align, offset, sec[facSplitSec].offset, sec[facSplitSec].count, sec[facSplitSec].eltSize);
+  WriteSection(out, facOrigin, align, offset, sec[facOriginSec].offset, sec[facOriginSec].count, sec[facOriginSec].eltSize);
+  WriteSection(out, _leafOrigin, align, offset, sec[leafOriginSec].offset, sec[leafOriginSec].count, sec[leafOriginSec].eltSize);
+  WriteSection(out, leafNode, align, offset, sec[leafNodeSec].offset, sec[leafNodeSec].count, sec[leafNodeSec].eltSize);
+  WriteSection(out, bagLeaf, align, offset, sec[bagLeafSec].offset, sec[bagLeafSec].count, sec[bagLeafSec].eltSize);
+  WriteSection(out, bagBits, align, offset, sec[bagBitsSec].offset, sec[bagBitsSec].count, sec[bagBitsSec].eltSize);
+  WriteSection(out, _yTrain, align, offset, sec[yTrainSec].offset, sec[yTrainSec].count, sec[yTrainSec].eltSize);
+  WriteSection(out, weight, align, offset, sec[weightSec].offset, sec[weightSec].count, sec[weightSec].eltSize);
+
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  out.close();
+
+  return !out.fail();
+}
+
+
+/**
+   @brief Maps an image privately, so that pages are shared with the
+   file until written, which prediction does not do.  Falls back to
+   reading the image onto the heap where mapping is unavailable.
+
+   @return loaded image, or null if the file is unreadable or does not
+   hold an image compatible with this build.
+ */
+ForestFile *ForestFile::Load(const std::string &path) {
+  unsigned char *base = 0;
+  size_t bytes = 0;
+  bool mapped = false;
+#if !defined(_WIN32)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return 0;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(Header)) {
+    bytes = st.st_size;
+    void *addr = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      base = static_cast<unsigned char *>(addr);
+      mapped = true;
+    }
+  }
+  close(fd);
+#else
+  std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+  if (in) {
+    bytes = in.tellg();
+    if (bytes >= sizeof(Header)) {
+      base = new unsigned char[bytes];
+      in.seekg(0);
+      if (!in.read(reinterpret_cast<char *>(base), bytes)) {
+        delete [] base;
+        base = 0;
+      }
+    }
+  }
+#endif
+  if (base == 0)
+    return 0;
+
+  ForestFile *forestFile = new ForestFile(base, bytes, mapped);
+  if (!forestFile->Validate()) {
+    delete forestFile;
+    return 0;
+  }
+
+  // Small sections taken by vector are copied out.
+  const unsigned int *originLeaf = forestFile->Sec<const unsigned int>(leafOriginSec);
+  forestFile->leafOrigin.assign(originLeaf, originLeaf + forestFile->Count(leafOriginSec));
+  const double *y = forestFile->Sec<const double>(yTrainSec);
+  forestFile->yTrain.assign(y, y + forestFile->Count(yTrainSec));
+
+  return forestFile;
+}
+
+
+/**
+   @brief Checks that the image was written by a compatible build and
+   that every section lies, aligned, within the image.
+
+   @return true iff the image is usable.
+ */
+bool ForestFile::Validate() const {
+  if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version || header->byteOrder != byteOrder || header->nSection != sectionCount)
+    return false;
+
+  const uint32_t eltSize[sectionCount] = { sizeof(class ForestNode), sizeof(unsigned int), sizeof(unsigned int), sizeof(unsigned int), sizeof(unsigned int), sizeof(class LeafNode), sizeof(class BagLeaf), sizeof(unsigned int), sizeof(double), sizeof(double) };
+  for (unsigned int sec = 0; sec < sectionCount; sec++) {
+    const SectionDesc &desc = header->section[sec];
+    if (desc.count == 0)
+      continue;
+    if (desc.eltSize != eltSize[sec] || desc.offset % align != 0 || desc.offset > bytes || desc.count > (bytes - desc.offset) / desc.eltSize)
+      return false;
+  }
+
+  return Count(originSec) == header->nTree && Count(facOriginSec) == header->nTree && Count(leafOriginSec) == header->nTree;
+}
@@ -0,0 +1,179 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file forestfile.h
+
+   @brief Binary image of a trained forest, loadable by mapping rather
+   than by deserialization.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_FORESTFILE_H
+#define ARBORIST_FORESTFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/**
+   @brief A trained forest, together with its leaves and optional bag,
+   laid out as a header followed by aligned sections.  Sections hold the
+   very arrays consumed by Forest and LeafPerf, so that prediction may
+   proceed directly from the mapped image.
+
+   Images are specific to the byte order and structure layout of the
+   build which wrote them, both of which are verified on loading.
+ */
+class ForestFile {
+  static const char magic[8];
+  static const uint32_t version = 1;
+  static const uint32_t byteOrder = 0x01020304;
+  static const size_t align = 64; // Section alignment, in bytes.
+
+ public:
+  enum Section { forestNodeSec, originSec, facSplitSec, facOriginSec, leafOriginSec, leafNodeSec, bagLeafSec, bagBitsSec, yTrainSec, weightSec, sectionCount };
+
+ private:
+  /**
+     @brief Placement of a section within the image.
+   */
+  struct SectionDesc {
+    uint64_t offset; // Bytes from start of image.
+    uint64_t count; // Element count.
+    uint32_t eltSize; // Bytes per element, as written.
+    uint32_t pad;
+  };
+
+  /**
+     @brief Leads the image.
+   */
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t nTree;
+    uint32_t rowTrain;
+    uint32_t ctgWidth; // Zero iff regression.
+    uint32_t nSection;
+    SectionDesc section[sectionCount];
+  };
+
+  unsigned char *base;
+  size_t bytes;
+  bool mapped; // Whether 'base' is mapped, else heap-allocated.
+  const Header *header;
+
+  // Small per-tree or per-row arrays which clients take by vector.
+  std::vector<unsigned int> leafOrigin;
+  std::vector<double> yTrain;
+
+  ForestFile(unsigned char *_base, size_t _bytes, bool _mapped);
+  bool Validate() const;
+
+  template<typename T> T *Sec(Section sec) const {
+    return header->section[sec].count == 0 ? 0 : reinterpret_cast<T *>(base + header->section[sec].offset);
+  }
+
+ public:
+  ~ForestFile();
+
+  static bool Write(const std::string &path, const std::vector<class ForestNode> &forestNode, const std::vector<unsigned int> &origin, const std::vector<unsigned int> &facSplit, const std::vector<unsigned int> &facOrigin, const std::vector<unsigned int> &_leafOrigin, const std::vector<class LeafNode> &leafNode, const std::vector<class BagLeaf> &bagLeaf, const std::vector<unsigned int> &bagBits, const std::vector<double> &_yTrain, const std::vector<double> &weight, unsigned int rowTrain, unsigned int ctgWidth);
+  static ForestFile *Load(const std::string &path);
+
+
+  inline unsigned int NTree() const {
+    return header->nTree;
+  }
+
+
+  inline unsigned int RowTrain() const {
+    return header->rowTrain;
+  }
+
+
+  /**
+     @return response cardinality, zero iff regression.
+   */
+  inline unsigned int CtgWidth() const {
+    return header->ctgWidth;
+  }
+
+
+  inline size_t Count(Section sec) const {
+    return header->section[sec].count;
+  }
+
+
+  inline const class ForestNode *Nodes() const {
+    return Sec<const class ForestNode>(forestNodeSec);
+  }
+
+
+  inline const unsigned int *Origin() const {
+    return Sec<const unsigned int>(originSec);
+  }
+
+
+  /**
+     @brief Factor splitting bits.  Mapped privately, so writes, if any,
+     do not reach the file.
+   */
+  inline unsigned int *FacSplit() const {
+    return Sec<unsigned int>(facSplitSec);
+  }
+
+
+  inline const unsigned int *FacOrigin() const {
+    return Sec<const unsigned int>(facOriginSec);
+  }
+
+
+  inline std::vector<unsigned int> &LeafOrigin() {
+    return leafOrigin;
+  }
+
+
+  inline const class LeafNode *Leaves() const {
+    return Sec<const class LeafNode>(leafNodeSec);
+  }
+
+
+  /**
+     @return bag-leaf records, or null if not retained.
+   */
+  inline const class BagLeaf *BagLeaves() const {
+    return Sec<const class BagLeaf>(bagLeafSec);
+  }
+
+
+  /**
+     @return bagged-row bits, or null if not retained.
+   */
+  inline unsigned int *BagBits() const {
+    return Sec<unsigned int>(bagBitsSec);
+  }
+
+
+  inline const std::vector<double> &YTrain() const {
+    return yTrain;
+  }
+
+
+  /**
+     @return per-leaf category weights, or null if regression.
+   */
+  inline const double *Weight() const {
+    return Sec<const double>(weightSec);
+  }
+};
+
+#endif
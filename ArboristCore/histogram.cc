@@ -0,0 +1,166 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file histogram.cc
+
+   @brief Methods for accumulating and deriving per-pair histograms.
+
+   @author Mark Seligman
+ */
+
+#include "histogram.h"
+#include "rowrank.h"
+#include "samplepred.h"
+
+#include <algorithm>
+
+//#include <iostream>
+//using namespace std;
+
+
+Histogram::Histogram(const RowRank *_rowRank, unsigned int _nPred) : rowRank(_rowRank), nPred(_nPred) {
+}
+
+
+/**
+   @brief Retires the current level's histograms to parent status.
+
+   @return void.
+ */
+void Histogram::LevelInit() {
+  cellPrev = std::move(cell);
+  pairPrev = std::move(pairCell);
+  cell.clear();
+  pairCell.clear();
+}
+
+
+/**
+   @brief Orders the pair map following reservation.
+
+   @return void.
+ */
+void Histogram::LevelSeal() {
+  std::sort(pairCell.begin(), pairCell.end());
+}
+
+
+/**
+   @brief Looks up a pair's histogram at the previous level.
+
+   @param parIdx is the level-relative index of the parent.
+
+   @return starting cell offset, if any, else 'noCell'.
+ */
+unsigned int Histogram::Parent(unsigned int parIdx, unsigned int predIdx) const {
+  unsigned int pairOff = parIdx * nPred + predIdx;
+  auto it = std::lower_bound(pairPrev.begin(), pairPrev.end(), std::make_pair(pairOff, 0u));
+  return (it != pairPrev.end() && it->first == pairOff) ? it->second : noCell;
+}
+
+
+/**
+   @brief Reserves zeroed bins for a pair.  Not thread-safe:  reservation
+   precedes splitting.
+
+   @return starting cell offset.
+ */
+unsigned int Histogram::Reserve(unsigned int levelIdx, unsigned int predIdx, unsigned int binCount) {
+  unsigned int cellOff = cell.size();
+  BinCell zero;
+  zero.sum = 0.0;
+  zero.sCount = zero.extent = 0;
+  cell.insert(cell.end(), binCount, zero);
+  pairCell.push_back(std::make_pair(levelIdx * nPred + predIdx, cellOff));
+
+  return cellOff;
+}
+
+
+/**
+   @brief Accumulates a pair's restaged samples into its bins.  Samples
+   arrive in rank order, so bins are visited in order and are accumulated
+   in registers.
+
+   @param idxStart is the pair's starting index.
+
+   @param idxEnd is the pair's final index, inclusive.
+
+   @return void.
+ */
+void Histogram::Accum(unsigned int cellOff, unsigned int predIdx, const SPCol &spn, unsigned int idxStart, unsigned int idxEnd) {
+  BinCell *binCell = &cell[cellOff];
+  const unsigned int *binSup = rowRank->BinSup(predIdx);
+  unsigned int binPrev = rowRank->Bin(predIdx, spn.Rank(idxStart));
+  unsigned int rankSup = binSup[binPrev];
+  unsigned int idxPrev = idxStart;
+  double sum = 0.0;
+  unsigned int sCountBin = 0;
+  for (unsigned int idx = idxStart; idx <= idxEnd; idx++) {
+    FltVal ySum;
+    unsigned int rank, sCount;
+    spn.RegFields(idx, ySum, rank, sCount);
+    if (rank >= rankSup) { // Ranks nondecreasing:  bin complete.
+      BinCell &bc = binCell[binPrev];
+      bc.sum += sum;
+      bc.sCount += sCountBin;
+      bc.extent += idx - idxPrev;
+      sum = 0.0;
+      sCountBin = 0;
+      idxPrev = idx;
+      do {
+        rankSup = binSup[++binPrev];
+      } while (rank >= rankSup);
+    }
+    sum += ySum;
+    sCountBin += sCount;
+  }
+  BinCell &bc = binCell[binPrev];
+  bc.sum += sum;
+  bc.sCount += sCountBin;
+  bc.extent += idxEnd + 1 - idxPrev;
+}
+
+
+/**
+   @brief Derives a pair's bins by subtracting its sibling's from its
+   parent's.
+
+   @param parOff is the parent's starting cell, at the previous level.
+
+   @param sibOff is the sibling's starting cell, at the current level.
+
+   @param extent is the pair's index count, against which the derived
+   bins are checked.
+
+   @return true iff the derived bins account for every index of the pair,
+   otherwise false with bins zeroed.
+ */
+bool Histogram::Derive(unsigned int cellOff, unsigned int parOff, unsigned int sibOff, unsigned int binCount, unsigned int extent) {
+  BinCell *binCell = &cell[cellOff];
+  const BinCell *par = &cellPrev[parOff];
+  const BinCell *sib = &cell[sibOff];
+  unsigned int extentTot = 0;
+  bool consistent = true;
+  for (unsigned int bin = 0; bin < binCount && consistent; bin++) {
+    consistent = sib[bin].extent <= par[bin].extent;
+    binCell[bin].extent = par[bin].extent - sib[bin].extent;
+    binCell[bin].sCount = par[bin].sCount - sib[bin].sCount;
+    binCell[bin].sum = binCell[bin].extent == 0 ? 0.0 : par[bin].sum - sib[bin].sum;
+    extentTot += binCell[bin].extent;
+  }
+
+  if (!consistent || extentTot != extent) { // Leaves bins zeroed for Accum().
+    for (unsigned int bin = 0; bin < binCount; bin++) {
+      binCell[bin].sum = 0.0;
+      binCell[bin].sCount = binCell[bin].extent = 0;
+    }
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,75 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file histogram.h
+
+   @brief Per-pair bin accumulators supporting histogram splitting of
+   numeric predictors.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_HISTOGRAM_H
+#define ARBORIST_HISTOGRAM_H
+
+#include <vector>
+#include <utility>
+
+
+/**
+   @brief Response summary of the samples whose ranks fall within a bin.
+ */
+class BinCell {
+ public:
+  double sum; // Sum of response values.
+  unsigned int sCount; // Sample count, including multiplicities.
+  unsigned int extent; // Count of distinct sample indices.
+};
+
+
+/**
+   @brief Bin accumulators for the current and previous levels, indexed by
+   split/predictor pair.  Retaining the previous level allows a node's
+   histogram to be derived from its parent's by subtracting that of its
+   sibling.  Bins summarize the staged samples, which continue to be
+   restaged every level.
+ */
+class Histogram {
+  const class RowRank *rowRank;
+  const unsigned int nPred;
+  std::vector<BinCell> cell; // Current level.
+  std::vector<BinCell> cellPrev; // Previous level.
+
+  // Few pairs are binned, so cell offsets are keyed by pair offset in
+  // sorted vectors rather than tabulated for every pair.
+  std::vector<std::pair<unsigned int, unsigned int> > pairCell; // Current level.
+  std::vector<std::pair<unsigned int, unsigned int> > pairPrev; // Previous level.
+
+ public:
+  static const unsigned int noCell = 0xffffffff;
+  static const unsigned int spanMin = 16; // Fewest bins worth scanning.
+
+  Histogram(const class RowRank *_rowRank, unsigned int _nPred);
+  void LevelInit();
+  void LevelSeal();
+  unsigned int Parent(unsigned int parIdx, unsigned int predIdx) const;
+  unsigned int Reserve(unsigned int levelIdx, unsigned int predIdx, unsigned int binCount);
+  void Accum(unsigned int cellOff, unsigned int predIdx, const class SPCol &spn, unsigned int idxStart, unsigned int idxEnd);
+  bool Derive(unsigned int cellOff, unsigned int parOff, unsigned int sibOff, unsigned int binCount, unsigned int extent);
+
+
+  /**
+     @return base of the bins reserved for a pair at the current level.
+   */
+  inline const BinCell *Cell(unsigned int cellOff) const {
+    return &cell[cellOff];
+  }
+};
+
+#endif
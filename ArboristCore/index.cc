@@ -21,8 +21,14 @@
 #include "splitsig.h"
 #include "bottom.h"
 #include "path.h"
+#include "context.h"
 
 #include <numeric>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Testing only:
 //#include <iostream>
@@ -31,40 +37,12 @@
 //clock_t clock(void);
 
 
-unsigned int IndexLevel::totLevels = 0;
-unsigned int IndexLevel::minNode = 0;
-
-/**
-   @brief Initialization of static invariants.
-
-   @param _minNode is the minimum node size for splitting.
-
-   @param _totLevels is the maximum number of levels to evaluate.
-
-   @return void.
- */
-void IndexLevel::Immutables(unsigned int _minNode, unsigned int _totLevels) {
-  minNode = _minNode;
-  totLevels = _totLevels;
-}
-
-
-/**
-   @brief Reset of statics.
-
-   @return void.
- */
-void IndexLevel::DeImmutables() {
-  totLevels = 0;
-  minNode = 0;
-}
-
-
-
 /**
    @brief Per-tree constructor.  Sets up root node for level zero.
+
+   @param trainCtx supplies the job's splitting thresholds.
  */
-IndexLevel::IndexLevel(const std::vector<SampleNode> &_stageSample, unsigned int nSamp, double bagSum) : stageSample(_stageSample), indexSet(std::vector<IndexSet>(1)), bagCount(stageSample.size()), idxLive(bagCount), relBase(std::vector<unsigned int>(1)), rel2ST(std::vector<unsigned int>(bagCount)), rel2Sample(stageSample), st2Split(std::vector<unsigned int>(bagCount)) {
+IndexLevel::IndexLevel(const TrainContext &trainCtx, const std::vector<SampleNode> &_stageSample, unsigned int nSamp, double bagSum) : minNode(trainCtx.MinNode()), totLevels(trainCtx.TotLevels()), minRatio(trainCtx.MinRatio()), nPred(trainCtx.NPred()), treesActive(0), threadTot(1), stageSample(_stageSample), indexSet(std::vector<IndexSet>(1)), bagCount(stageSample.size()), idxLive(bagCount), relBase(std::vector<unsigned int>(1)), rel2ST(std::vector<unsigned int>(bagCount)), rel2Sample(stageSample), st2Split(std::vector<unsigned int>(bagCount)) {
   indexSet[0].Init(0, nSamp, 0, bagCount, 0.0, 0, bagSum, 0, 0, bagCount);
   relBase[0] = 0;
   std::iota(rel2ST.begin(), rel2ST.end(), 0);
@@ -89,19 +67,61 @@ IndexSet::IndexSet() : preBias(0.0), splitIdx(0), ptId(0), lhStart(0), extent(0)
    @brief Instantiates a block of PreTees for bulk return, but may or may
    not build them concurrently.
 
+   Each tree owns its Sample, SamplePred, Bottom and PreTree, so trees
+   within a block share only read-only state.  When concurrent, one
+   thread is allotted to each tree and the level-wise parallel regions
+   within each tree become nested.  Nesting is enabled for the duration
+   of the block, each tree sizing its inner teams by the threads left
+   idle by the trees still training.
+
+   @param trainCtx is the job's configuration.
+
    @param sampleBlock contains the sample objects characterizing the roots.
 
    @param treeBlock is the number of trees to train in this block.
 
+   @param statBlock outputs the instrumentation of each tree, for the
+   caller to merge.
+
    @return brace of 'treeBlock'-many PreTree objects.
 */
-PreTree **IndexLevel::BlockTrees(const PMTrain *pmTrain, Sample **sampleBlock, int treeBlock) {
+PreTree **IndexLevel::BlockTrees(const TrainContext &trainCtx, const PMTrain *pmTrain, Sample **sampleBlock, int treeBlock, std::vector<TrainStat> &statBlock) {
   PreTree **ptBlock = new PreTree*[treeBlock];
-
-  for (int blockIdx = 0; blockIdx < treeBlock; blockIdx++) {
-    Sample *sample = sampleBlock[blockIdx];
-    ptBlock[blockIdx] = OneTree(pmTrain, sample);
+  statBlock.resize(treeBlock);
+  int threadTot = 1;
+#ifdef _OPENMP
+  threadTot = omp_get_max_threads();
+#endif
+  bool treeConcurrent = trainCtx.TreeConcurrent() && treeBlock > 1 && threadTot > 1;
+  int treesActive = 0;
+  int teamSize = std::min(treeBlock, threadTot);
+
+#ifdef _OPENMP
+  int levelsPrev = omp_get_max_active_levels();
+  if (treeConcurrent)
+    omp_set_max_active_levels(std::max(levelsPrev, omp_get_active_level() + 2));
+#endif
+
+  int blockIdx;
+#pragma omp parallel default(shared) private(blockIdx) if(treeConcurrent) num_threads(teamSize)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (blockIdx = 0; blockIdx < treeBlock; blockIdx++) {
+      if (treeConcurrent) {
+#pragma omp atomic
+        treesActive++;
+      }
+      ptBlock[blockIdx] = OneTree(trainCtx, pmTrain, sampleBlock[blockIdx], treeConcurrent ? &treesActive : 0, threadTot, statBlock[blockIdx]);
+      if (treeConcurrent) {
+#pragma omp atomic
+        treesActive--;
+      }
+    }
   }
+
+#ifdef _OPENMP
+  omp_set_max_active_levels(levelsPrev);
+#endif
   
   return ptBlock;
 }
@@ -110,14 +130,24 @@ PreTree **IndexLevel::BlockTrees(const PMTrain *pmTrain, Sample **sampleBlock, i
 /**
    @brief Performs sampling and level processing for a single tree.
 
-   @return void.
+   @param treesActive counts the trees of the block in training, if
+   trained concurrently, else null.
+
+   @param threadTot is the number of threads available to the block.
+
+   @param treeStat outputs the tree's instrumentation.
+
+   @return trained PreTree.
  */
-PreTree *IndexLevel::OneTree(const PMTrain *pmTrain, Sample *sample) {
-  PreTree *preTree = new PreTree(pmTrain, sample->BagCount());
-  IndexLevel *index = new IndexLevel(sample->StageSample(), Sample::NSamp(), sample->BagSum());
+PreTree *IndexLevel::OneTree(const TrainContext &trainCtx, const PMTrain *pmTrain, Sample *sample, const int *treesActive, int threadTot, TrainStat &treeStat) {
+  PreTree *preTree = new PreTree(pmTrain, sample->BagCount(), trainCtx.HeightEst());
+  IndexLevel *index = new IndexLevel(trainCtx, sample->StageSample(), sample->NSamp(), sample->BagSum());
+  index->treesActive = treesActive;
+  index->threadTot = threadTot;
   Bottom *bottom = sample->Bot();
   index->Levels(bottom, preTree);
   delete index;
+  treeStat = bottom->Stat();
 
   bottom->SubtreeFrontier(preTree);
 
@@ -132,8 +162,12 @@ PreTree *IndexLevel::OneTree(const PMTrain *pmTrain, Sample *sample) {
    @return void.
 */
 void  IndexLevel::Levels(Bottom *bottom, PreTree *preTree) {
+  TrainStat &trainStat = bottom->Stat();
   for (unsigned int level = 0; !indexSet.empty(); level++) {
     //    cout << "\nLevel " << level << "\n" << endl;
+    if (level > 0)
+      trainStat.LevelNext();
+    LevelThreads();
     std::vector<SSNode> argMax(indexSet.size());
     for (unsigned int i = 0; i < indexSet.size(); i++) {
       argMax[i].SetInfo(indexSet[i].MinInfo());
@@ -143,11 +177,38 @@ void  IndexLevel::Levels(Bottom *bottom, PreTree *preTree) {
     unsigned int leafNext;
     unsigned int splitNext = SplitCensus(argMax, leafNext, level + 1 == totLevels);
     Consume(bottom, preTree, argMax, splitNext, leafNext);
+
+    TrainStat::Clock start = TrainStat::Now();
     Produce(bottom, preTree, splitNext);
+    trainStat.Accum(TrainStat::produce, start);
   }
 }
 
 
+/**
+   @brief Sizes the nested teams of a concurrently-trained tree by its
+   share of the threads, as the trees still training divide them, and by
+   the number of pairs the level may schedule.  Wide levels thereby
+   retain node-level parallelism, while narrow levels do not idle
+   threads other trees could employ.
+
+   @return void.
+ */
+void IndexLevel::LevelThreads() const {
+#ifdef _OPENMP
+  if (treesActive == 0)
+    return;
+
+  int active;
+#pragma omp atomic read
+  active = *treesActive;
+  int share = std::max(1, threadTot / std::max(1, active));
+  size_t width = indexSet.size() * size_t(nPred);
+  omp_set_num_threads(int(std::min(size_t(share), std::max(size_t(1), width))));
+#endif
+}
+
+
 /**
    @brief Tallies previous level's splitting results.
 
@@ -162,7 +223,7 @@ unsigned int IndexLevel::SplitCensus(const std::vector<SSNode> &argMax, unsigned
   idxExtent = idxLive; // Previous level's index space.
   leafThis = splitNext = idxLive = idxMax = 0;
   for (auto & iSet : indexSet) {
-    iSet.ApplySplit(argMax);
+    iSet.ApplySplit(argMax, minRatio);
     iSet.SplitCensus(this, leafThis, splitNext, idxLive, idxMax);
   }
 
@@ -205,13 +266,15 @@ void IndexSet::SplitCensus(IndexLevel *indexLevel, unsigned int &leafThis, unsig
 
      @param argMax is the arg-max node for the split.
 
+     @param minRatio scales the information threshold for the next level.
+
      @return void.
  */
-void IndexSet::ApplySplit(const std::vector<SSNode> &argMaxVec) {
+void IndexSet::ApplySplit(const std::vector<SSNode> &argMaxVec, double minRatio) {
   SSNode argMax = argMaxVec[splitIdx];
   if (argMax.Info() > minInfo) {
     argMax.LHSizes(lhSCount, lhExtent);
-    minInfo = argMax.MinInfo(); // Reset for splitting next level.
+    minInfo = argMax.MinInfo(minRatio); // Reset for splitting next level.
     terminal = false;
   }
   else {
@@ -242,6 +305,8 @@ unsigned IndexSet::SplitAccum(class IndexLevel *indexLevel, unsigned int _extent
    @return void.
 */
 void IndexLevel::Consume(Bottom *bottom, PreTree *preTree, const std::vector<SSNode> &argMax, unsigned int splitNext, unsigned int leafNext) {
+  TrainStat &trainStat = bottom->Stat();
+  TrainStat::Clock start = TrainStat::Now();
   bottom->Overlap(preTree, splitNext, leafNext); // Two levels co-exist.
   succLive = 0;
   succExtinct = splitNext; // Pseudo-indexing for extinct sets.
@@ -250,8 +315,11 @@ void IndexLevel::Consume(Bottom *bottom, PreTree *preTree, const std::vector<SSN
   for (auto & iSet : indexSet) {
     iSet.Consume(this, bottom, preTree, argMax);
   }
+  trainStat.Accum(TrainStat::consume, start);
 
+  start = TrainStat::Now();
   bottom->Reindex(this);
+  trainStat.Accum(TrainStat::reindex, start);
   relBase = std::move(succBase);
 }
 
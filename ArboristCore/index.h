@@ -70,7 +70,7 @@ class IndexSet {
   
  public:
   IndexSet();
-  void ApplySplit(const std::vector<class SSNode> &argMax);
+  void ApplySplit(const std::vector<class SSNode> &argMax, double minRatio);
   void SplitCensus(class IndexLevel *indexLevel, unsigned int &leafThis, unsigned int &splitNext, unsigned int &idxLive, unsigned int &idxMax);
   void Consume(class IndexLevel *indexlevel, class Bottom *bottom, class PreTree *preTree, const std::vector<class SSNode> &argMax);
   void NonTerminal(class IndexLevel *indexLevel, class Bottom *bottom, class PreTree *preTree, const class SSNode &argMax);
@@ -235,8 +235,12 @@ class IndexSet {
    @brief The index sets associated with nodes at a single subtree level.
  */
 class IndexLevel {
-  static unsigned int minNode;
-  static unsigned int totLevels;
+  const unsigned int minNode;
+  const unsigned int totLevels;
+  const double minRatio;
+  const unsigned int nPred;
+  const int *treesActive; // Trees of the block in training, iff concurrent.
+  int threadTot; // Threads available to the block.
   const std::vector<class SampleNode> &stageSample;
   std::vector<IndexSet> indexSet;
   const unsigned int bagCount;
@@ -253,20 +257,18 @@ class IndexLevel {
   std::vector<class SampleNode> rel2Sample;
   std::vector<unsigned int> st2Split; // Useful for subtree-relative indexing.
 
-  static class PreTree *OneTree(const class PMTrain *pmTrain, class Sample *sample);
+  static class PreTree *OneTree(const class TrainContext &trainCtx, const class PMTrain *pmTrain, class Sample *sample, const int *treesActive, int threadTot, class TrainStat &treeStat);
+  void LevelThreads() const;
   unsigned int SplitCensus(const std::vector<class SSNode> &argMax, unsigned int &leafNext, bool _levelTerminal);
   void Consume(class Bottom *bottom, class PreTree *preTree, const std::vector<class SSNode> &argMax, unsigned int splitNext, unsigned int leafNext);
   void Produce(class Bottom *bottom, class PreTree *preTree, unsigned int splitNext);
 
 
  public:
-  static void Immutables(unsigned int _minNode, unsigned int _totLevels);
-  static void DeImmutables();
-
-  IndexLevel(const std::vector<class SampleNode> &_stageSample, unsigned int _nSamp, double _bagSum);
+  IndexLevel(const class TrainContext &trainCtx, const std::vector<class SampleNode> &_stageSample, unsigned int _nSamp, double _bagSum);
   ~IndexLevel();
 
-  static class PreTree **BlockTrees(const class PMTrain *pmTrain, class Sample **sampleBlock, int _treeBlock);
+  static class PreTree **BlockTrees(const class TrainContext &trainCtx, const class PMTrain *pmTrain, class Sample **sampleBlock, int _treeBlock, std::vector<class TrainStat> &statBlock);
   void Levels(class Bottom *bottom, class PreTree *preTree);
   unsigned int IdxSucc(class Bottom *bottom, unsigned int extent, unsigned int ptId, unsigned int &outOff, bool terminal = false);
   void Reindex(class Bottom *bottom, class BV *replayExpl);
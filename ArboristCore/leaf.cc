@@ -23,22 +23,12 @@
 //#include <iostream>
 //using namespace std;
 
-bool Leaf::thinLeaves = false;
-
-void Leaf::Immutables(bool _thinLeaves) {
-  thinLeaves = _thinLeaves;
-}
-
-
-void Leaf::DeImmutables() {
-  thinLeaves = false;
-}
-
-
 /**
    @breif Training constructor.
+
+   @param _thinLeaves is true iff bag/leaf records are to be suppressed.
  */
-Leaf::Leaf(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain) : origin(_origin), nTree(origin.size()), leafNode(_leafNode), bagLeaf(_bagLeaf), bagRow(new BitMatrix(_bagBits, rowTrain, nTree)) {
+Leaf::Leaf(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, bool _thinLeaves) : thinLeaves(_thinLeaves), origin(_origin), nTree(origin.size()), leafNode(_leafNode), bagLeaf(_bagLeaf), bagRow(new BitMatrix(_bagBits, rowTrain, nTree)) {
 }
 
 
@@ -49,7 +39,7 @@ Leaf::~Leaf() {
 
 /**
  */
-LeafReg::LeafReg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain) : Leaf(_origin, _leafNode, _bagLeaf, _bagBits, rowTrain) {
+LeafReg::LeafReg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, bool _thinLeaves) : Leaf(_origin, _leafNode, _bagLeaf, _bagBits, rowTrain, _thinLeaves) {
 }
 
 
@@ -89,7 +79,7 @@ void LeafCtg::Reserve(unsigned int leafEst, unsigned int bagEst) {
 /**
    @brief Constructor for crescent forest.
  */
-LeafCtg::LeafCtg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int>  &_bagBits, unsigned int rowTrain, std::vector<double> &_weight, unsigned int _ctgWidth) : Leaf(_origin, _leafNode, _bagLeaf, _bagBits, rowTrain), weight(_weight), ctgWidth(_ctgWidth) {
+LeafCtg::LeafCtg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int>  &_bagBits, unsigned int rowTrain, std::vector<double> &_weight, unsigned int _ctgWidth, bool _thinLeaves) : Leaf(_origin, _leafNode, _bagLeaf, _bagBits, rowTrain, _thinLeaves), weight(_weight), ctgWidth(_ctgWidth) {
 }
 
 
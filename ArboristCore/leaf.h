@@ -18,6 +18,8 @@
 
 #include "sample.h"
 #include <vector>
+#include <cstddef>
+#include <cstring>
 
 
 class BagLeaf {
@@ -120,11 +122,26 @@ class LeafNode {
   inline double GetScore() const {
     return score;
   }
+
+
+  /**
+     @brief Copies the fields into a zeroed record of the same layout,
+     so that padding does not carry indeterminate bytes into images.
+
+     @param rec outputs the record:  sizeof(LeafNode) bytes.
+
+     @return void, with output parameter.
+   */
+  inline void Image(unsigned char rec[]) const {
+    std::memset(rec, 0, sizeof(LeafNode));
+    std::memcpy(rec + offsetof(LeafNode, score), &score, sizeof(score));
+    std::memcpy(rec + offsetof(LeafNode, extent), &extent, sizeof(extent));
+  }
 };
 
 
 class Leaf {
-  static bool thinLeaves;
+  const bool thinLeaves; // Whether to suppress bag/leaf records.
   std::vector<unsigned int> &origin; // Starting position, per tree.
   const unsigned int nTree;
   std::vector<LeafNode> &leafNode;
@@ -139,10 +156,7 @@ class Leaf {
   void NodeExtent(const class Sample *sample, std::vector<unsigned int> leafMap, unsigned int leafCount, unsigned int tIdx);
 
  public:
-  static void Immutables(bool _thinLeaves);
-  static void DeImmutables();
-
-  Leaf(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain);
+  Leaf(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, bool _thinLeaves);
   virtual ~Leaf();
   virtual void Reserve(unsigned int leafEst, unsigned int bagEst);
   virtual void Leaves(const class PMTrain *pmTrain, const class Sample *sample, const std::vector<unsigned int> &leafMap, unsigned int tIdx) = 0;
@@ -221,7 +235,7 @@ class LeafReg : public Leaf {
 
 
  public:
-  LeafReg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain);
+  LeafReg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, bool _thinLeaves);
   ~LeafReg();
   static void Export(const std::vector<unsigned int> &_origin, const LeafNode _leafNode[], unsigned int _leafCount, const BagLeaf _bagLeaf[], unsigned int _bagBits[], unsigned int _trainRow, std::vector<std::vector<unsigned int> >&rowTree, std::vector<std::vector<unsigned int> > &sCountTree, std::vector<std::vector<double> > &scoreTree, std::vector<std::vector<unsigned int> >&extentTree);
   
@@ -239,7 +253,7 @@ class LeafCtg : public Leaf {
 
   void Scores(const class PMTrain *pmTrain, const class SampleCtg *sample, const std::vector<unsigned int> &leafMap, unsigned int leafCount, unsigned int tIdx);
  public:
-  LeafCtg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, std::vector<double> &_weight, unsigned int _ctgWdith);
+  LeafCtg(std::vector<unsigned int> &_origin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagLeaf, std::vector<unsigned int> &_bagBits, unsigned int rowTrain, std::vector<double> &_weight, unsigned int _ctgWdith, bool _thinLeaves);
   ~LeafCtg();
 
   static void Export(const std::vector<unsigned int> &_origin, const LeafNode _leafNode[], unsigned int _leafCount, const BagLeaf _bagLeaf[], unsigned int _bagBits[], unsigned int _trainRow, const double _weight[], unsigned int _ctgWidth, std::vector<std::vector<unsigned int> > &rowTree, std::vector<std::vector<unsigned int> > &sCountTree, std::vector<std::vector<double> > &scoreTree, std::vector<std::vector<unsigned int> > &extentTree, std::vector<std::vector<double> > &_weightTree);
@@ -419,9 +433,21 @@ class LeafPerfCtg : public LeafPerf {
   }
   
 
-  inline double WeightCtg(int tIdx, unsigned int leafIdx, unsigned int ctg) const {
-    return weight[ctgWidth * NodeIdx(tIdx, leafIdx) + ctg];
+  /**
+     @return base of the per-leaf category weights.
+   */
+  inline const double *Weight() const {
+    return weight;
+  }
+
+
+  /**
+     @return the leaf's category weights, contiguous by category.
+   */
+  inline const double *Weight(int tIdx, unsigned int leafIdx) const {
+    return weight + ctgWidth * NodeIdx(tIdx, leafIdx);
   }
+
 };
 
 #endif
@@ -0,0 +1,79 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file mapblock.cc
+
+   @brief Methods for allocating and releasing spillable storage.
+
+   @author Mark Seligman
+ */
+
+#include "mapblock.h"
+
+#include <vector>
+
+#if !defined(_WIN32)
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Maps the block onto a fresh spill file, if requested and
+   supported, else allocates from the heap.  The file is unlinked as soon
+   as it is mapped, so it vanishes when the block is released.
+
+   @param _bytes is the block size.
+
+   @param spillDir is the directory to hold the spill file, empty iff
+   the block is to reside on the heap.
+ */
+MapBlock::MapBlock(size_t _bytes, const std::string &spillDir) : bytes(_bytes > 0 ? _bytes : 1), base(0), mapped(false) {
+#if !defined(_WIN32)
+  if (!spillDir.empty()) {
+    std::string name = spillDir + "/arborist.XXXXXX";
+    std::vector<char> path(name.begin(), name.end());
+    path.push_back('\0');
+    int fd = mkstemp(&path[0]);
+    if (fd >= 0) {
+      unlink(&path[0]);
+      if (ftruncate(fd, bytes) == 0) {
+        void *addr = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+          base = addr;
+          mapped = true;
+        }
+      }
+      close(fd); // Mapping persists.
+    }
+  }
+#endif
+
+  if (!mapped) {
+    base = new unsigned char[bytes];
+  }
+}
+
+
+/**
+   @brief Releases the mapping or heap storage.
+ */
+MapBlock::~MapBlock() {
+#if !defined(_WIN32)
+  if (mapped) {
+    munmap(base, bytes);
+    return;
+  }
+#endif
+  delete [] static_cast<unsigned char *>(base);
+}
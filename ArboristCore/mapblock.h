@@ -0,0 +1,57 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file mapblock.h
+
+   @brief Storage optionally backed by a memory-mapped spill file, so that
+   large training structures may exceed physical memory.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_MAPBLOCK_H
+#define ARBORIST_MAPBLOCK_H
+
+#include <cstddef>
+#include <string>
+
+
+/**
+   @brief Fixed-size block of raw storage.  If a spill directory is
+   specified, the block is mapped onto an unlinked file in that directory,
+   so that the operating system may page it to disk rather than to swap.
+   Otherwise, or should mapping fail, the block resides on the heap.
+ */
+class MapBlock {
+  const size_t bytes;
+  void *base;
+  bool mapped; // Whether backed by a file.
+
+ public:
+  MapBlock(size_t _bytes, const std::string &spillDir);
+  ~MapBlock();
+
+
+  /**
+     @return base address of the block.
+   */
+  inline unsigned char *Base() const {
+    return static_cast<unsigned char *>(base);
+  }
+
+
+  /**
+     @return true iff the block is backed by a spill file.
+   */
+  inline bool Mapped() const {
+    return mapped;
+  }
+};
+
+#endif
@@ -17,6 +17,10 @@
 #include <vector>
 #include <algorithm>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#include <iostream>
 //using namespace std;
 
@@ -35,16 +39,64 @@ PMTrain::PMTrain(const std::vector<unsigned int> &_feCard, unsigned int _nPred,
 
    @return void.
  */
-PMPredict::PMPredict(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_feNumT, unsigned int *_feFacT, unsigned int _nPredNum, unsigned int _nPredFac, unsigned int _nRow) : PredMap(_nRow, _nPredNum, _nPredFac), blockNum(BlockNum::Factory(_valNum, _rowStart, _runLength, _predStart, _feNumT, nPredNum)), blockFac(BlockFac::Factory(_feFacT, nPredFac)) {
+PMPredict::PMPredict(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_feNumT, unsigned int *_feFacT, unsigned int _nPredNum, unsigned int _nPredFac, unsigned int _nRow) : PredMap(_nRow, _nPredNum, _nPredFac), blockNum(BlockNum::Factory(_valNum, _rowStart, _runLength, _predStart, _feNumT, nPredNum)), blockFac(BlockFac::Factory(_valFac, _rowStartFac, _runLengthFac, _predStartFac, _feFacT, nPredFac)), pipelined((blockNum->Copies() || blockFac->Copies()) && nRow > rowBlock), stageStart(nRow), nThread(1), stageThread(1) {
+#ifdef _OPENMP
+  nThread = omp_get_max_threads();
+#endif
+  stageThread = std::max(1u, nThread / stageShare);
 }
 
 
 PMPredict::~PMPredict() {
+  if (stager.joinable())
+    stager.join();
   delete blockNum;
   delete blockFac;
 }
 
 
+/**
+   @brief Makes a block of rows current for prediction.  Blocks must be
+   requested in order, as the transposition of sparse values proceeds
+   sequentially.  If pipelined, the block will already have been staged
+   by the helper thread, which is then launched on the following block.
+
+   @param rowStart is the first row of the block.
+
+   @param rowEnd is the sup row.
+
+   @return void.
+ */
+void PMPredict::BlockTranspose(unsigned int rowStart, unsigned int rowEnd) {
+  if (stager.joinable())
+    stager.join();
+  if (stageStart != rowStart)
+    Stage(rowStart, rowEnd, nThread);
+  blockNum->Flip();
+  blockFac->Flip();
+
+  if (pipelined && rowEnd < nRow) {
+    stageStart = rowEnd;
+    stager = std::thread(&PMPredict::Stage, this, rowEnd, std::min(rowEnd + rowBlock, nRow), stageThread);
+  }
+}
+
+
+/**
+   @brief Transposes a block of rows into the staging buffers.
+
+   @param _nThread is the size of the team to employ:  the full team
+   when staging on demand, a share of it when staging on the helper
+   thread, whose team is its own.
+
+   @return void.
+ */
+void PMPredict::Stage(unsigned int rowStart, unsigned int rowEnd, unsigned int _nThread) {
+  blockNum->Transpose(rowStart, rowEnd, _nThread);
+  blockFac->Transpose(rowStart, rowEnd, _nThread);
+}
+
+
 BlockNum *BlockNum::Factory(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_feNumT, unsigned int _nPredNum) {
   if (_valNum.size() > 0) {
     return new BlockNumRLE(_valNum, _rowStart, _runLength, _predStart);
@@ -55,58 +107,141 @@ BlockNum *BlockNum::Factory(const std::vector<double> &_valNum, const std::vecto
 }
 
 
+BlockFac *BlockFac::Factory(const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, unsigned int *_feFacT, unsigned int _nPredFac) {
+  if (_valFac.size() > 0) {
+    return new BlockFacRLE(_valFac, _rowStart, _runLength, _predStart);
+  }
+  else {
+    return new BlockFacDense(_feFacT, _nPredFac);
+  }
+}
+
+
 /**
-   @brief RLE variant NYI.
+   @brief Sparse constructor.
  */
-BlockFac *BlockFac::Factory(unsigned int *_feFacT, unsigned int nPredFac) {
-  return new BlockFac(_feFacT, nPredFac);
+BlockNumRLE::BlockNumRLE(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart) : BlockNum(_predStart.size()), rle(_valNum, _rowStart, _runLength, _predStart) {
+  // Updated before the next use, so need not be initialized.  A second
+  // buffer stages the block ahead.
+  blockNumT = new double[PMPredict::rowBlock * nPredNum];
+  blockStage = new double[PMPredict::rowBlock * nPredNum];
 }
 
-  /**
-     @brief Sparse constructor.
-   */
-BlockNumRLE::BlockNumRLE(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart) : BlockNum(_predStart.size()), valNum(_valNum), rowStart(_rowStart), runLength(_runLength), predStart(_predStart) {
 
-  // Both 'blockNumT' and 'valPrev' are updated before the next use, so
-  // need not be initialized.
-  blockNumT = new double[PMPredict::rowBlock * nPredNum];
-  val = new double[nPredNum];
+BlockNumRLE::~BlockNumRLE() {
+  delete [] blockNumT;
+  delete [] blockStage;
+}
 
-  rowNext = new unsigned int[nPredNum];
-  idxNext = new unsigned int[nPredNum];
-  for (unsigned int predIdx = 0; predIdx < nPredNum; predIdx++) {
+
+/**
+   @brief Fills the staging buffer.
+
+   @return void.
+ */
+void BlockNumRLE::Transpose(unsigned int rowBegin, unsigned int rowEnd, unsigned int nThread) {
+  rle.Transpose(blockStage, rowBegin, rowEnd, nThread);
+}
+
+
+/**
+   @brief Sparse constructor.
+ */
+BlockFacRLE::BlockFacRLE(const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart) : BlockFac(_predStart.size()), rle(_valFac, _rowStart, _runLength, _predStart) {
+  blockFacT = new unsigned int[PMPredict::rowBlock * nPredFac];
+  blockStage = new unsigned int[PMPredict::rowBlock * nPredFac];
+}
+
+
+BlockFacRLE::~BlockFacRLE() {
+  delete [] blockFacT;
+  delete [] blockStage;
+}
+
+
+/**
+   @brief Fills the staging buffer.
+
+   @return void.
+ */
+void BlockFacRLE::Transpose(unsigned int rowBegin, unsigned int rowEnd, unsigned int nThread) {
+  rle.Transpose(blockStage, rowBegin, rowEnd, nThread);
+}
+
+
+/**
+   @brief Positions each predictor's cursor before its first run.
+ */
+template<typename valType> BlockRLE<valType>::BlockRLE(const std::vector<valType> &_val, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart) : val(_val), rowStart(_rowStart), runLength(_runLength), predStart(_predStart), nPred(_predStart.size()) {
+  // 'valCurrent' is updated before first use.
+  valCurrent = new valType[nPred];
+  rowNext = new unsigned int[nPred];
+  idxNext = new unsigned int[nPred];
+  for (unsigned int predIdx = 0; predIdx < nPred; predIdx++) {
     rowNext[predIdx] = 0; // Position of first update.
     idxNext[predIdx] = predStart[predIdx]; // Current starting offset.
   }
 }
 
 
-BlockNumRLE::~BlockNumRLE() {
-  delete [] blockNumT;
+template<typename valType> BlockRLE<valType>::~BlockRLE() {
+  delete [] valCurrent;
   delete [] rowNext;
   delete [] idxNext;
-  delete [] val;
 }
 
 
 /**
-   @brief Requires sequential update by row, but could be parallelized by
-   chunking predictors independently.
+   @brief Transposes a block of rows, chunking predictors across threads.
+   Requires sequential update by row within each predictor.
+
+   @param blockT outputs the row-major block.
+
+   @param nThread is the number of threads over which to spread chunks.
 
    @return void.
  */
-void BlockNumRLE::Transpose(unsigned int rowBegin, unsigned int rowEnd) {
+template<typename valType> void BlockRLE<valType>::Transpose(valType blockT[], unsigned int rowBegin, unsigned int rowEnd, unsigned int nThread) {
+  int nChunk = (nPred + chunkWidth - 1) / chunkWidth;
+  int chunk;
+  int teamSize = std::min(int(nThread), nChunk);
+
+#pragma omp parallel default(shared) private(chunk) if(teamSize > 1) num_threads(teamSize)
+  {
+#pragma omp for schedule(dynamic, 1)
+    for (chunk = 0; chunk < nChunk; chunk++) {
+      unsigned int predFirst = chunk * chunkWidth;
+      TransposeChunk(blockT, predFirst, std::min(predFirst + chunkWidth, nPred), rowBegin, rowEnd);
+    }
+  }
+}
+
+
+/**
+   @brief Transposes a chunk of predictors, advancing their cursors.
+   Assignments persist across invocations.
+
+   @param predFirst is the first predictor of the chunk.
+
+   @param predSup is the sup predictor of the chunk.
+
+   @return void.
+ */
+template<typename valType> void BlockRLE<valType>::TransposeChunk(valType blockT[], unsigned int predFirst, unsigned int predSup, unsigned int rowBegin, unsigned int rowEnd) {
   for (unsigned int row = rowBegin; row < rowEnd; row++) {
-    for (unsigned int predIdx = 0; predIdx < nPredNum; predIdx++) {
-      if (row == rowNext[predIdx]) { // Assignments persist across invocations:
+    valType *rowT = blockT + (row - rowBegin) * nPred;
+    for (unsigned int predIdx = predFirst; predIdx < predSup; predIdx++) {
+      if (row == rowNext[predIdx]) {
 	unsigned int vecIdx = idxNext[predIdx];
-	val[predIdx] = valNum[vecIdx];
+	valCurrent[predIdx] = val[vecIdx];
 	rowNext[predIdx] = rowStart[vecIdx] + runLength[vecIdx];
 	idxNext[predIdx] = ++vecIdx;
       }
-      blockNumT[(row - rowBegin) * nPredNum + predIdx] = val[predIdx];
+      rowT[predIdx] = valCurrent[predIdx];
     }
   }
 }
 
-  
+
+template class BlockRLE<double>;
+template class BlockRLE<unsigned int>;
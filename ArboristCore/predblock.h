@@ -17,6 +17,36 @@
 #define ARBORIST_PREDBLOCK_H
 
 #include <vector>
+#include <thread>
+#include <algorithm>
+
+
+/**
+   @brief Run-length encoded predictor values, transposed block by block
+   into row-major buffers.  Runs are ordered by row within each
+   predictor, so each predictor's cursor advances monotonically.  As
+   cursors are independent, predictors are transposed in chunks, one
+   chunk per task, each chunk spanning a cache line of the buffer.
+ */
+template<typename valType> class BlockRLE {
+  static const unsigned int chunkWidth = 64 / sizeof(valType);
+
+  const std::vector<valType> &val;
+  const std::vector<unsigned int> &rowStart;
+  const std::vector<unsigned int> &runLength;
+  const std::vector<unsigned int> &predStart;
+  const unsigned int nPred;
+  valType *valCurrent; // Value of the run under each cursor.
+  unsigned int *rowNext; // Row at which each cursor next advances.
+  unsigned int *idxNext; // Next run for each cursor.
+
+  void TransposeChunk(valType blockT[], unsigned int predFirst, unsigned int predSup, unsigned int rowBegin, unsigned int rowEnd);
+
+ public:
+  BlockRLE(const std::vector<valType> &_val, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart);
+  ~BlockRLE();
+  void Transpose(valType blockT[], unsigned int rowBegin, unsigned int rowEnd, unsigned int nThread);
+};
 
 
 /**
@@ -25,6 +55,7 @@
 class BlockNum {
  protected:
   double *blockNumT; // Iterator state
+  double *blockStage; // Block being transposed, pending Flip().
   const unsigned int nPredNum;
  public:
 
@@ -33,7 +64,27 @@ class BlockNum {
 
   static BlockNum *Factory(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_feNumT, unsigned int _nPredNum);
 
-  virtual void Transpose(unsigned int rowStart, unsigned int rowEnd) = 0;
+  virtual void Transpose(unsigned int rowStart, unsigned int rowEnd, unsigned int nThread) = 0;
+
+
+  /**
+     @return true iff transposition copies values, rather than
+     repositioning within values already transposed.
+   */
+  virtual bool Copies() const {
+    return false;
+  }
+
+
+  /**
+     @brief Promotes the most recently transposed block to current.
+
+     @return void.
+   */
+  inline void Flip() {
+    std::swap(blockNumT, blockStage);
+  }
+
 
 
   inline const double *Row(unsigned int rowOff) {
@@ -43,13 +94,7 @@ class BlockNum {
 
 
 class BlockNumRLE : public BlockNum {
-  const std::vector<double> &valNum;
-  const std::vector<unsigned int> &rowStart;
-  const std::vector<unsigned int> &runLength;
-  const std::vector<unsigned int> &predStart;
-  double *val;
-  unsigned int *rowNext;
-  unsigned int *idxNext;
+  BlockRLE<double> rle;
 
  public:
 
@@ -58,7 +103,12 @@ class BlockNumRLE : public BlockNum {
    */
   BlockNumRLE(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart);
   ~BlockNumRLE();
-  void Transpose(unsigned int rowStart, unsigned int rowEnd);
+  void Transpose(unsigned int rowStart, unsigned int rowEnd, unsigned int nThread);
+
+
+  bool Copies() const {
+    return true;
+  }
 };
 
 
@@ -67,7 +117,7 @@ class BlockNumDense : public BlockNum {
  public:
 
  BlockNumDense(double *_feNumT, unsigned int _nPredNum) : BlockNum(_nPredNum), feNumT(_feNumT) {
-    blockNumT = _feNumT;
+    blockNumT = blockStage = _feNumT;
   }
 
 
@@ -83,40 +133,51 @@ class BlockNumDense : public BlockNum {
 
      @param rowEnd is the sup row.  Unused here.
 
+     @param nThread is unused here, as nothing is copied.
+
      @return void.
    */
-  inline void Transpose(unsigned int rowStart, unsigned int rowEnd) {
-    blockNumT = feNumT + nPredNum * rowStart;
+  inline void Transpose(unsigned int rowStart, unsigned int /* rowEnd */, unsigned int /* nThread */) {
+    blockStage = feNumT + nPredNum * rowStart;
   }
 };
 
 
+/**
+   @brief Abstract class for blocks of factor codes.
+ */
 class BlockFac {
+ protected:
   const unsigned int nPredFac;
-  unsigned int *feFac; // Factors, may or may not already be transposed.
   unsigned int *blockFacT; // Iterator state.
+  unsigned int *blockStage; // Pending Flip().
 
  public:
 
+ BlockFac(unsigned int _nPredFac) : nPredFac(_nPredFac) {
+  }
+  virtual ~BlockFac() {}
+
+  static BlockFac *Factory(const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, unsigned int *_feFacT, unsigned int _nPredFac);
+
+  virtual void Transpose(unsigned int rowStart, unsigned int rowEnd, unsigned int nThread) = 0;
+
+
   /**
-     @brief Dense constructor:  currently pre-transposed.
+     @return true iff transposition copies values.
    */
- BlockFac(unsigned int *_feFacT, unsigned int _nPredFac) : nPredFac(_nPredFac), feFac(_feFacT) {
+  virtual bool Copies() const {
+    return false;
   }
-  static BlockFac *Factory(unsigned int *_feFacT, unsigned int _nPredFac);
-  
-  /**
-     @brief Resets starting position to block within region previously
-     transposed.
 
-     @param rowStart is the first row of the block.
 
-     @param rowEnd is the sup row.  Unused here.
+  /**
+     @brief Promotes the most recently transposed block to current.
 
      @return void.
    */
-  inline void Transpose(unsigned int rowStart, unsigned int rowEnd) {
-    blockFacT = feFac + nPredFac * rowStart;
+  inline void Flip() {
+    std::swap(blockFacT, blockStage);
   }
 
 
@@ -134,6 +195,55 @@ class BlockFac {
 };
 
 
+class BlockFacRLE : public BlockFac {
+  BlockRLE<unsigned int> rle;
+
+ public:
+
+  /**
+     @brief Sparse constructor.
+   */
+  BlockFacRLE(const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart);
+  ~BlockFacRLE();
+  void Transpose(unsigned int rowStart, unsigned int rowEnd, unsigned int nThread);
+
+
+  bool Copies() const {
+    return true;
+  }
+};
+
+
+class BlockFacDense : public BlockFac {
+  unsigned int *feFacT;
+
+ public:
+
+  /**
+     @brief Dense constructor:  pre-transposed.
+   */
+ BlockFacDense(unsigned int *_feFacT, unsigned int _nPredFac) : BlockFac(_nPredFac), feFacT(_feFacT) {
+    blockFacT = blockStage = _feFacT;
+  }
+
+  
+  /**
+     @brief Resets starting position to block within region previously
+     transposed.
+
+     @param rowStart is the first row of the block.
+
+     @param rowEnd is the sup row.  Unused here.
+
+     @param nThread is unused here, as nothing is copied.
+
+     @return void.
+   */
+  inline void Transpose(unsigned int rowStart, unsigned int /* rowEnd */, unsigned int /* nThread */) {
+    blockStage = feFacT + nPredFac * rowStart;
+  }
+};
+
 
 /**
    @brief Singleton subclass instances:  training or prediction.
@@ -284,21 +394,32 @@ class PMTrain : public PredMap {
 };
 
 
+/**
+   @brief Prediction walks the observations in blocks of 'rowBlock' rows.
+   Blocks are double-buffered:  when transposition copies values, the
+   block following the current one is transposed on a helper thread,
+   overlapping traversal and scoring of the current block.  The helper
+   runs a team of its own, a fraction of the size of the team traversing
+   the current block, as transposition is the cheaper of the two.
+ */
 class PMPredict : public PredMap {
   BlockNum *blockNum;
   BlockFac *blockFac;
+  const bool pipelined; // Whether to transpose ahead.
+  std::thread stager; // Transposes the block ahead, if pipelined.
+  unsigned int stageStart; // First row of the staged block.
+  static const unsigned int stageShare = 4; // Traversal threads per stager.
+  unsigned int nThread; // Threads available to transposition.
+  unsigned int stageThread; // Threads employed by the helper.
+
+  void Stage(unsigned int rowStart, unsigned int rowEnd, unsigned int _nThread);
 
  public:
   static const unsigned int rowBlock = 0x2000;
 
-  PMPredict(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_feNumT, unsigned int *_feFacT, unsigned int _nPredNum, unsigned int _nPredFac, unsigned int _nRow);
+  PMPredict(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_feNumT, unsigned int *_feFacT, unsigned int _nPredNum, unsigned int _nPredFac, unsigned int _nRow);
   ~PMPredict();
-
-
-  inline void BlockTranspose(unsigned int rowStart, unsigned int rowEnd) {
-    blockNum->Transpose(rowStart, rowEnd);
-    blockFac->Transpose(rowStart, rowEnd);
-  }
+  void BlockTranspose(unsigned int rowStart, unsigned int rowEnd);
 
 
   /**
@@ -30,10 +30,10 @@
 /**
    @brief Static entry for regression case.
  */
-void Predict::Regression(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred) {
+void Predict::Regression(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred) {
   // Non-quantile regression does not employ BagLeaf information.
   LeafPerfReg *_leafReg = new LeafPerfReg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, 0, 0, _bagBits, yTrain.size());
-  PredictReg *predictReg = new PredictReg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafReg, yTrain, _nTree, _yPred);
+  PredictReg *predictReg = new PredictReg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _valFac, _rowStartFac, _runLengthFac, _predStartFac, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafReg, yTrain, _nTree, _yPred);
   Forest *forest =  new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictReg);
   predictReg->PredictAcross(forest);
 
@@ -48,9 +48,9 @@ void Predict::Regression(const std::vector<double> &_valNum, const std::vector<u
 
    // Only prediction method requiring BagLeaf.
  */
-void Predict::Quantiles(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, const BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred, const std::vector<double> &quantVec, unsigned int qBin, std::vector<double> &qPred, bool validate) {
+void Predict::Quantiles(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, const BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred, const std::vector<double> &quantVec, unsigned int qBin, std::vector<double> &qPred, bool validate) {
   LeafPerfReg *_leafReg = new LeafPerfReg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, _bagLeaf, _bagLeafTot, _bagBits, yTrain.size());
-  PredictReg *predictReg = new PredictReg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafReg, yTrain, _nTree, _yPred);
+  PredictReg *predictReg = new PredictReg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _valFac, _rowStartFac, _runLengthFac, _predStartFac, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafReg, yTrain, _nTree, _yPred);
   Forest *forest =  new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictReg);
   Quant *quant = new Quant(predictReg, _leafReg, quantVec, qBin);
   predictReg->PredictAcross(forest, quant, &qPred[0], validate);
@@ -65,10 +65,10 @@ void Predict::Quantiles(const std::vector<double> &_valNum, const std::vector<un
 /**
    @brief Entry for separate classification prediction.
  */
-void Predict::Classification(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, std::vector<unsigned int> &_yPred, unsigned int *_census, const std::vector<unsigned int> &_yTest, unsigned int *_conf, std::vector<double> &_error, double *_prob) {
+void Predict::Classification(const std::vector<double> &_valNum, const std::vector<unsigned int> &_rowStart, const std::vector<unsigned int> &_runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, std::vector<unsigned int> &_yPred, unsigned int *_census, const std::vector<unsigned int> &_yTest, unsigned int *_conf, std::vector<double> &_error, double *_prob) {
   // Ctg prediction does not employ BagLeaf information.
   LeafPerfCtg *_leafCtg = new LeafPerfCtg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, 0, 0, _bagBits, _rowTrain, _weight, _ctgWidth);
-  PredictCtg *predictCtg = new PredictCtg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafCtg, _nTree, _yPred);
+  PredictCtg *predictCtg = new PredictCtg(new PMPredict(_valNum, _rowStart, _runLength, _predStart, _valFac, _rowStartFac, _runLengthFac, _predStartFac, _blockNumT, _blockFacT, _nPredNum, _nPredFac, _yPred.size()), _leafCtg, _nTree, _yPred);
   Forest *forest = new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictCtg);
   predictCtg->PredictAcross(forest, _census, _yTest, _conf, _error, _prob);
 
@@ -78,6 +78,111 @@ void Predict::Classification(const std::vector<double> &_valNum, const std::vect
 }
 
 
+/**
+   @brief Builds the predictor map for streaming:  a single block of
+   dense buffers, refilled by the caller's source.
+
+   @param numT is the numeric buffer, 'rowBlock' rows wide.
+
+   @param facT is the factor buffer, 'rowBlock' rows wide.
+
+   @return new predictor map.
+ */
+PMPredict *Predict::StreamMap(unsigned int nPredNum, unsigned int nPredFac, double *numT, unsigned int *facT) {
+  static const std::vector<double> valNone;
+  static const std::vector<unsigned int> runNone;
+  return new PMPredict(valNone, runNone, runNone, runNone, runNone, runNone, runNone, runNone, numT, facT, nPredNum, nPredFac, PMPredict::rowBlock);
+}
+
+
+/**
+   @brief Streaming entry for regression.  Memory is bounded by the
+   block size, independent of the number of rows.
+
+   @param source supplies the observations, block by block.
+
+   @param sink receives each block's predictions.
+
+   @return number of rows predicted.
+ */
+unsigned int Predict::Regression(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, const std::vector<double> &yTrain) {
+  double *numT = new double[PMPredict::rowBlock * _nPredNum];
+  unsigned int *facT = new unsigned int[PMPredict::rowBlock * _nPredFac];
+  std::vector<double> yPred(PMPredict::rowBlock);
+  LeafPerfReg *_leafReg = new LeafPerfReg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, 0, 0, 0, yTrain.size());
+  PredictReg *predictReg = new PredictReg(StreamMap(_nPredNum, _nPredFac, numT, facT), _leafReg, yTrain, _nTree, yPred);
+  Forest *forest = new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictReg);
+  unsigned int rowTot = predictReg->PredictStream(forest, 0, 0, source, sink, numT, facT);
+
+  delete predictReg;
+  delete forest;
+  delete _leafReg;
+  delete [] numT;
+  delete [] facT;
+
+  return rowTot;
+}
+
+
+/**
+   @brief Streaming entry for regression with quantiles.  As with
+   the other quantile entry, bagged rows are required to rank the
+   training responses.
+
+   @return number of rows predicted.
+ */
+unsigned int Predict::Quantiles(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, const BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, const std::vector<double> &quantVec, unsigned int qBin) {
+  double *numT = new double[PMPredict::rowBlock * _nPredNum];
+  unsigned int *facT = new unsigned int[PMPredict::rowBlock * _nPredFac];
+  std::vector<double> yPred(PMPredict::rowBlock);
+  std::vector<double> qPred(PMPredict::rowBlock * quantVec.size());
+  LeafPerfReg *_leafReg = new LeafPerfReg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, _bagLeaf, _bagLeafTot, _bagBits, yTrain.size());
+  PredictReg *predictReg = new PredictReg(StreamMap(_nPredNum, _nPredFac, numT, facT), _leafReg, yTrain, _nTree, yPred);
+  Forest *forest = new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictReg);
+  Quant *quant = new Quant(predictReg, _leafReg, quantVec, qBin);
+  unsigned int rowTot = predictReg->PredictStream(forest, quant, &qPred[0], source, sink, numT, facT);
+
+  delete predictReg;
+  delete _leafReg;
+  delete quant;
+  delete forest;
+  delete [] numT;
+  delete [] facT;
+
+  return rowTot;
+}
+
+
+/**
+   @brief Streaming entry for classification.
+
+   @param doProb is true iff probabilities are requested.
+
+   @return number of rows predicted.
+ */
+unsigned int Predict::Classification(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, bool doProb) {
+  double *numT = new double[PMPredict::rowBlock * _nPredNum];
+  unsigned int *facT = new unsigned int[PMPredict::rowBlock * _nPredFac];
+  std::vector<unsigned int> yPred(PMPredict::rowBlock);
+  unsigned int *census = new unsigned int[PMPredict::rowBlock * _ctgWidth];
+  double *prob = doProb ? new double[PMPredict::rowBlock * _ctgWidth] : 0;
+  LeafPerfCtg *_leafCtg = new LeafPerfCtg(&_leafOrigin[0], _nTree, _leafNode, _leafCount, 0, 0, 0, _rowTrain, _weight, _ctgWidth);
+  PredictCtg *predictCtg = new PredictCtg(StreamMap(_nPredNum, _nPredFac, numT, facT), _leafCtg, _nTree, yPred);
+  Forest *forest = new Forest(_forestNode, _origin, _nTree, _facSplit, _facLen, _facOff, _nFac, predictCtg);
+  unsigned int rowTot = predictCtg->PredictStream(forest, census, prob, source, sink, numT, facT);
+
+  delete predictCtg;
+  delete forest;
+  delete _leafCtg;
+  delete [] census;
+  delete [] prob;
+  delete [] numT;
+  delete [] facT;
+
+  return rowTot;
+}
+
+
 PredictCtg::PredictCtg(PMPredict *_pmPredict, const LeafPerfCtg *_leafCtg, unsigned int _nTree, std::vector<unsigned int> &_yPred) : Predict(_pmPredict, _nTree, _yPred.size(), _leafCtg->NoLeaf()), leafCtg(_leafCtg), ctgWidth(leafCtg->CtgWidth()), yPred(_yPred), defaultScore(ctgWidth), defaultWeight(std::vector<double>(ctgWidth)) {
   std::fill(defaultWeight.begin(), defaultWeight.end(), -1.0);
 }
@@ -154,45 +259,145 @@ double PredictCtg::DefaultWeight(double *weightPredict) {
 }
 
 
-Predict::Predict(class PMPredict *_pmPredict, unsigned int _nTree, unsigned int _nRow, unsigned int _noLeaf) : noLeaf(_noLeaf), pmPredict(_pmPredict), nTree(_nTree), nRow(_nRow) {
-  predictLeaves = new unsigned int[PMPredict::rowBlock * nTree];
+Predict::Predict(class PMPredict *_pmPredict, unsigned int _nTree, unsigned int _nRow, unsigned int _noLeaf) : noLeaf(_noLeaf), leafFuse(0), ctgFuse(0), weightFuse(0), fuseStride(0), pmPredict(_pmPredict), nTree(_nTree), nRow(_nRow), predictLeaves(0), fuseAcc(0) {
 }
 
 
 Predict::~Predict() {
   delete [] predictLeaves;
+  delete [] fuseAcc;
   delete pmPredict;
 }
 
 
+/**
+   @brief Allocates the leaf-index matrix, for clients reading back the
+   leaves reached.
+
+   @return void.
+ */
+void Predict::LeavesInit() {
+  if (predictLeaves == 0)
+    predictLeaves = new unsigned int[PMPredict::rowBlock * nTree];
+}
+
+
+/**
+   @brief Directs leaves to be scored as reached, in place of recording
+   their indices, provided a row's accumulators fit a cache line.  Wider
+   rows, as for many categories, would be streamed through the cache
+   once per tree, at greater cost than the leaf indices they replace.
+   Rows are padded to a cache line, as neighbouring rows may be walked
+   by different threads.
+
+   @param leafPerf supplies the leaf scores.
+
+   @param ctgWidth is the response cardinality, zero iff regression.
+
+   @param weight are the per-leaf category weights, iff fusing
+   probabilities.
+
+   @return true iff fused.
+ */
+bool Predict::FuseInit(const LeafPerf *leafPerf, unsigned int ctgWidth, const double *weight) {
+  unsigned int width = ctgWidth == 0 ? 1 : (weight == 0 ? ctgWidth : 2 * ctgWidth);
+  if (width > fuseAlign)
+    return false;
+
+  leafFuse = leafPerf;
+  ctgFuse = ctgWidth;
+  weightFuse = ctgWidth == 0 ? 0 : weight;
+  fuseStride = fuseAlign;
+  fuseAcc = new double[PMPredict::rowBlock * fuseStride];
+
+  return true;
+}
+
+
+/**
+   @brief Traverses the forest over a block of rows.
+
+   @param bag indexes out-of-bag rows.
+
+   @return void.
+ */
+void Predict::PredictBlock(const Forest *forest, const BitMatrix *bag, unsigned int rowStart, unsigned int rowEnd) {
+  pmPredict->BlockTranspose(rowStart, rowEnd);
+  FuseClear(rowStart, rowEnd);
+  forest->PredictAcross(rowStart, rowEnd, bag);
+}
+
+
+/**
+   @brief Zeroes the accumulators of a block's rows, if fused.
+
+   @return void.
+ */
+void Predict::FuseClear(unsigned int rowStart, unsigned int rowEnd) {
+  if (fuseAcc != 0)
+    std::fill(fuseAcc, fuseAcc + (rowEnd - rowStart) * fuseStride, 0.0);
+}
+
+
 PredictCtg::~PredictCtg() {
 }
 
 
 void PredictCtg::PredictAcross(const Forest *forest, unsigned int *census, const std::vector<unsigned int> &yTest, unsigned int *conf, std::vector<double> &error, double *prob) {
   const BitMatrix *bag = leafCtg->Bag();
+  if (!bag->Empty() || !FuseInit(leafCtg, ctgWidth, prob != 0 ? leafCtg->Weight() : 0))
+    LeavesInit();
 
-  double *votes = new double[nRow * ctgWidth];
-  for (unsigned int i = 0; i < nRow * ctgWidth; i++)
-    votes[i] = 0;
   for (unsigned int rowStart = 0; rowStart < nRow; rowStart += PMPredict::rowBlock) {
     unsigned int rowEnd = std::min(rowStart + PMPredict::rowBlock, nRow);
-    pmPredict->BlockTranspose(rowStart, rowEnd);
-    forest->PredictAcross(rowStart, rowEnd, bag);
-    Score(votes, rowStart, rowEnd);
+    PredictBlock(forest, bag, rowStart, rowEnd);
+    Score(census, rowStart, rowEnd);
     if (prob != 0)
       Prob(prob, rowStart, rowEnd);
   }
 
-  Vote(votes, census);
-  delete [] votes;
-
   if (yTest.size() > 0) {
     Validate(yTest, conf, error);
   }
 }
 
 
+/**
+   @brief Predicts the rows of a source, block by block, passing each
+   block's outputs to the sink.  Outputs are buffers of a single block.
+
+   @param census buffers the vote counts.
+
+   @param prob buffers the probabilities, if requested, else null.
+
+   @param numT is the numeric buffer filled by the source.
+
+   @param facT is the factor buffer filled by the source.
+
+   @return number of rows predicted.
+ */
+unsigned int PredictCtg::PredictStream(const Forest *forest, unsigned int *census, double *prob, PredictSource *source, PredictSink *sink, double numT[], unsigned int facT[]) {
+  const BitMatrix *bag = new BitMatrix(0, 0); // Streamed rows are unseen.
+  if (!FuseInit(leafCtg, ctgWidth, prob != 0 ? leafCtg->Weight() : 0))
+    LeavesInit();
+
+  unsigned int rowTot = 0;
+  for (unsigned int blockRows = source->Fill(numT, facT, PMPredict::rowBlock); blockRows > 0; blockRows = source->Fill(numT, facT, PMPredict::rowBlock)) {
+    PredictBlock(forest, bag, 0, blockRows);
+    Score(census, 0, blockRows);
+    if (prob != 0) {
+      std::fill(prob, prob + blockRows * ctgWidth, 0.0);
+      Prob(prob, 0, blockRows);
+    }
+    sink->Classification(rowTot, blockRows, &yPred[0], census, prob);
+    rowTot += blockRows;
+  }
+  delete bag;
+
+  return rowTot;
+}
+
+
 /**
    @brief Fills in confusion matrix and error vector.
 
@@ -230,105 +435,159 @@ void PredictCtg::Validate(const std::vector<unsigned int> &yTest, unsigned int c
 
  
 /**
-   @brief Voting for non-bagged prediction.  Rounds jittered scores to category.
+   @brief Selects the category with the most votes.  Ties are broken
+   by the summed jitter, which favours the category voted for by the
+   more confident leaves, and then by the lower category.
 
-   @param yCtg outputs predicted response.
+   @param count are the integer vote counts, by category.
 
-   @return void, with output reference vector.
-*/
-void PredictCtg::Vote(double *votes, unsigned int census[]) {
-  int row;
+   @param jitter are the summed jitters, by category.
 
-#pragma omp parallel default(shared) private(row)
-  {
-#pragma omp for schedule(dynamic, 1)
-  for (row = 0; row < int(nRow); row++) {
-    int argMax = -1;
-    double scoreMax = 0.0;
-    double *score = votes + row * ctgWidth;
-    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
-      double ctgScore = score[ctg]; // Jittered vote count.
-      if (ctgScore > scoreMax) {
-	scoreMax = ctgScore;
-	argMax = ctg;
-      }
-      census[row * ctgWidth + ctg] = ctgScore; // De-jittered.
-    }
-    yPred[row] = argMax;
-  }
+   @return predicted category.
+ */
+unsigned int PredictCtg::ArgMax(const unsigned int count[], const double jitter[]) const {
+  unsigned int argMax = 0;
+  for (unsigned int ctg = 1; ctg < ctgWidth; ctg++) {
+    if (count[ctg] > count[argMax] || (count[ctg] == count[argMax] && jitter[ctg] > jitter[argMax]))
+      argMax = ctg;
   }
+
+  return argMax;
 }
 
 
 /**
-   @brief Computes score from leaf predictions.
+   @brief Counts votes from leaf predictions, directly into the census,
+   and predicts by majority.  Rows are scored in tiles of 'voteTile',
+   one tile per task, so that threads write disjoint spans of the
+   census and response.
+
+   @param census outputs the integer vote counts, by row and category.
 
-   @return internal vote table, with output reference vector.
+   @return void, with output reference vector.
  */
-void PredictCtg::Score(double *votes, unsigned int rowStart, unsigned int rowEnd) {
-  int blockRow;
+void PredictCtg::Score(unsigned int census[], unsigned int rowStart, unsigned int rowEnd) {
+  unsigned int nTile = (rowEnd - rowStart + voteTile - 1) / voteTile;
+  int tile;
 
-// TODO:  Recast loop by blocks, to avoid
-// false sharing.
-#pragma omp parallel default(shared) private(blockRow)
+#pragma omp parallel default(shared) private(tile)
   {
+  double *jitter = new double[ctgWidth];
 #pragma omp for schedule(dynamic, 1)
-  for (blockRow = 0; blockRow < int(rowEnd - rowStart); blockRow++) {
-    double *prediction = votes + (rowStart + blockRow) * ctgWidth;
-    unsigned int treesSeen = 0;
-    for (unsigned int tc = 0; tc < nTree; tc++) {
-      if (!IsBagged(blockRow, tc)) {
-	treesSeen++;
-	double val = leafCtg->GetScore(tc, LeafIdx(blockRow, tc));
-	unsigned int ctg = val; // Truncates jittered score for indexing.
-	prediction[ctg] += 1 + val - ctg;
+  for (tile = 0; tile < int(nTile); tile++) {
+    unsigned int tileEnd = std::min(rowEnd - rowStart, (tile + 1) * voteTile);
+    for (unsigned int blockRow = tile * voteTile; blockRow < tileEnd; blockRow++) {
+      unsigned int *count = census + (rowStart + blockRow) * ctgWidth;
+      unsigned int treesSeen = 0;
+      if (Fused()) { // Splits accumulated votes into count and jitter.
+	const double *acc = FuseRow(blockRow);
+	for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
+	  count[ctg] = acc[ctg];
+	  jitter[ctg] = acc[ctg] - count[ctg];
+	}
+	treesSeen = nTree;
       }
-    }
-    if (treesSeen == 0) {
-      for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
-	prediction[ctg] = 0.0;
+      else {
+	for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
+	  count[ctg] = 0;
+	  jitter[ctg] = 0.0;
+	}
+	for (unsigned int tc = 0; tc < nTree; tc++) {
+	  if (!IsBagged(blockRow, tc)) {
+	    treesSeen++;
+	    double val = leafCtg->GetScore(tc, LeafIdx(blockRow, tc));
+	    unsigned int ctg = val; // Truncates jittered score for indexing.
+	    count[ctg]++;
+	    jitter[ctg] += val - ctg;
+	  }
+	}
+      }
+
+      if (treesSeen == 0) {
+	yPred[rowStart + blockRow] = DefaultScore();
+	count[yPred[rowStart + blockRow]] = 1;
+      }
+      else {
+	yPred[rowStart + blockRow] = ArgMax(count, jitter);
       }
-      prediction[DefaultScore()] = 1;
     }
   }
+  delete [] jitter;
   }
 }
 
 
+/**
+   @brief Computes class probabilities from the leaf weights, in tiles
+   of rows spread across threads.  Each leaf's weights are contiguous
+   by category, so are accumulated as a vector.
+
+   @param prob outputs the probabilities, by row and category.
+
+   @return void, with output parameter vector.
+ */
 void PredictCtg::Prob(double *prob, unsigned int rowStart, unsigned int rowEnd) {
-  for (unsigned int blockRow = 0; blockRow < rowEnd - rowStart; blockRow++) {
-    double *probRow = prob + (rowStart + blockRow) * ctgWidth;
-    double rowSum = 0.0;
-    unsigned int treesSeen = 0;
-    for (unsigned int tc = 0; tc < nTree; tc++) {
-      if (!IsBagged(blockRow, tc)) {
-	treesSeen++;
-	for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
-	  double idxWeight = leafCtg->WeightCtg(tc, LeafIdx(blockRow, tc), ctg);
-	  probRow[ctg] += idxWeight;
-	  rowSum += idxWeight;
+  unsigned int nTile = (rowEnd - rowStart + voteTile - 1) / voteTile;
+  int tile;
+
+#pragma omp parallel default(shared) private(tile)
+  {
+#pragma omp for schedule(dynamic, 1)
+  for (tile = 0; tile < int(nTile); tile++) {
+    unsigned int tileEnd = std::min(rowEnd - rowStart, (tile + 1) * voteTile);
+    for (unsigned int blockRow = tile * voteTile; blockRow < tileEnd; blockRow++) {
+      double *probRow = prob + (rowStart + blockRow) * ctgWidth;
+      unsigned int treesSeen = 0;
+      if (Fused()) {
+	const double *acc = FuseRow(blockRow) + ctgWidth;
+	for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+	  probRow[ctg] += acc[ctg];
+	treesSeen = nTree;
+      }
+      else {
+	for (unsigned int tc = 0; tc < nTree; tc++) {
+	  if (!IsBagged(blockRow, tc)) {
+	    treesSeen++;
+	    const double *weight = leafCtg->Weight(tc, LeafIdx(blockRow, tc));
+	    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+	      probRow[ctg] += weight[ctg];
+	  }
 	}
       }
-    }
-    if (treesSeen == 0) {
-      rowSum = DefaultWeight(probRow);
-    }
 
-    double recipSum = 1.0 / rowSum;
-    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
-      probRow[ctg] *= recipSum;
+      double rowSum;
+      if (treesSeen == 0) {
+	rowSum = DefaultWeight(probRow);
+      }
+      else {
+	rowSum = 0.0;
+	for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+	  rowSum += probRow[ctg];
+      }
+
+      double recipSum = 1.0 / rowSum;
+      for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+	probRow[ctg] *= recipSum;
+    }
+  }
   }
 }
 
 
 /**
+   @brief Predictions for a block of rows, scored as leaves are reached
+   unless validating.
+
+   @return void, with side-effected prediction vector.
  */
 void PredictReg::PredictAcross(const Forest *forest) {
   const BitMatrix *bag = leafReg->Bag();
+  if (!bag->Empty() || !FuseInit(leafReg, 0, 0))
+    LeavesInit();
+
   for (unsigned int rowStart = 0; rowStart < nRow; rowStart += PMPredict::rowBlock) {
     unsigned int rowEnd = std::min(rowStart + PMPredict::rowBlock, nRow);
-    pmPredict->BlockTranspose(rowStart, rowEnd);
-    forest->PredictAcross(rowStart, rowEnd, bag);
+    PredictBlock(forest, bag, rowStart, rowEnd);
     Score(rowStart, rowEnd);
   }
 }
@@ -341,10 +600,10 @@ void PredictReg::PredictAcross(const Forest *forest) {
  */
 void PredictReg::PredictAcross(const Forest *forest, Quant *quant, double qPred[], bool validate) {
   const BitMatrix *leafBag = validate ? leafReg->Bag() : new BitMatrix(0, 0);
+  LeavesInit(); // Quantiles read back the leaves reached.
   for (unsigned int rowStart = 0; rowStart < nRow; rowStart += PMPredict::rowBlock) {
     unsigned int rowEnd = std::min(rowStart + PMPredict::rowBlock, nRow);
-    pmPredict->BlockTranspose(rowStart, rowEnd);
-    forest->PredictAcross(rowStart, rowEnd, leafBag);
+    PredictBlock(forest, leafBag, rowStart, rowEnd);
     Score(rowStart, rowEnd);
     quant->PredictAcross(rowStart, rowEnd, qPred);
   }
@@ -354,6 +613,40 @@ void PredictReg::PredictAcross(const Forest *forest, Quant *quant, double qPred[
 }
 
 
+/**
+   @brief Predicts the rows of a source, block by block, passing each
+   block's outputs to the sink.
+
+   @param quant estimates quantiles, if nonnull.
+
+   @param qPred buffers a block's quantiles, if estimated.
+
+   @param numT is the numeric buffer filled by the source.
+
+   @param facT is the factor buffer filled by the source.
+
+   @return number of rows predicted.
+ */
+unsigned int PredictReg::PredictStream(const Forest *forest, Quant *quant, double qPred[], PredictSource *source, PredictSink *sink, double numT[], unsigned int facT[]) {
+  const BitMatrix *bag = new BitMatrix(0, 0); // Streamed rows are unseen.
+  if (quant != 0 || !FuseInit(leafReg, 0, 0))
+    LeavesInit();
+
+  unsigned int rowTot = 0;
+  for (unsigned int blockRows = source->Fill(numT, facT, PMPredict::rowBlock); blockRows > 0; blockRows = source->Fill(numT, facT, PMPredict::rowBlock)) {
+    PredictBlock(forest, bag, 0, blockRows);
+    Score(0, blockRows);
+    if (quant != 0)
+      quant->PredictAcross(0, blockRows, qPred);
+    sink->Regression(rowTot, blockRows, &yPred[0], quant != 0 ? qPred : 0);
+    rowTot += blockRows;
+  }
+  delete bag;
+
+  return rowTot;
+}
+
+
 
 /**
   @brief Sets regression scores from leaf predictions.
@@ -367,6 +660,10 @@ void PredictReg::Score(unsigned int rowStart, unsigned int rowEnd) {
   {
 #pragma omp for schedule(dynamic, 1)
   for (blockRow = 0; blockRow < int(rowEnd - rowStart); blockRow++) {
+      if (Fused()) {
+        yPred[rowStart + blockRow] = FuseRow(blockRow)[0] / nTree;
+        continue;
+      }
       double score = 0.0;
       int treesSeen = 0;
       for (unsigned int tc = 0; tc < nTree; tc++) {
@@ -16,28 +16,157 @@
 #ifndef ARBORIST_PREDICT_H
 #define ARBORIST_PREDICT_H
 
+#include "leaf.h"
+
 #include <vector>
 #include <algorithm>
 
+/**
+   @brief Caller-supplied observations, for streaming prediction.  Rows
+   are delivered a block at a time, laid out as the transposed
+   prediction blocks:  row-major, with numeric values by numeric index
+   and factor codes by factor index.
+ */
+class PredictSource {
+ public:
+  virtual ~PredictSource() {}
+
+
+  /**
+     @brief Fills the next block of rows.
+
+     @param numT outputs the block's numeric values.
+
+     @param facT outputs the block's factor codes.
+
+     @param rowMax is the capacity of the buffers, in rows.
+
+     @return number of rows filled, no more than 'rowMax', zero once
+     the observations are exhausted.
+   */
+  virtual unsigned int Fill(double numT[], unsigned int facT[], unsigned int rowMax) = 0;
+};
+
+
+/**
+   @brief Caller-supplied recipient of streamed predictions.  Outputs
+   are indexed from the first row of the block and are overwritten by
+   the following block, so must be consumed before returning.  Only the
+   method appropriate to the response need be overridden.
+ */
+class PredictSink {
+ public:
+  virtual ~PredictSink() {}
+
+
+  /**
+     @param rowStart is the stream position of the block's first row.
+
+     @param nRow is the number of rows in the block.
+
+     @param yPred are the predicted responses.
+
+     @param qPred are the quantiles, by row, if requested, else null.
+
+     @return void.
+   */
+  virtual void Regression(unsigned int /* rowStart */, unsigned int /* nRow */, const double /* yPred */[], const double /* qPred */[]) {}
+
+
+  /**
+     @param census are the vote counts, by row and category.
+
+     @param prob are the probabilities, by row and category, if
+     requested, else null.
+
+     @return void.
+   */
+  virtual void Classification(unsigned int /* rowStart */, unsigned int /* nRow */, const unsigned int /* yPred */[], const unsigned int /* census */[], const double /* prob */[]) {}
+};
+
+
+/**
+   @brief Leaves reached by a block of rows are either recorded, for
+   scoring in a subsequent pass, or scored as soon as they are reached.
+   Recording is required only by clients reading back the leaf indices,
+   such as quantile estimation and out-of-bag validation, or when a
+   row's scores are too wide to accumulate cheaply.  Otherwise, each
+   row accumulates its score directly, with the leaf-index matrix never
+   allocated.
+ */
 class Predict {
   const unsigned int noLeaf; // Inattainable leaf index value.
+  static const unsigned int fuseAlign = 8; // Accumulators per cache line.
+
+  const class LeafPerf *leafFuse; // Nonnull iff scoring as reached.
+  unsigned int ctgFuse; // Response cardinality, zero iff regression.
+  const double *weightFuse; // Category weights, iff fusing probabilities.
+  unsigned int fuseStride; // Accumulators per row, padded to a line.
+
+
+  /**
+     @brief Scores a leaf as it is reached, summing regression scores
+     or jittered votes and, if requested, category weights.  The
+     weights trail the votes.
+
+     @return void.
+   */
+  inline void Fuse(unsigned int blockRow, unsigned int tc, unsigned int leafIdx) {
+    double *acc = fuseAcc + fuseStride * blockRow;
+    double val = leafFuse->GetScore(tc, leafIdx);
+    if (ctgFuse == 0) {
+      acc[0] += val;
+      return;
+    }
+
+    unsigned int ctg = val; // Truncates jittered score for indexing.
+    acc[ctg] += 1 + val - ctg;
+    if (weightFuse != 0) {
+      const double *weight = weightFuse + ctgFuse * leafFuse->NodeIdx(tc, leafIdx);
+      double *probRow = acc + ctgFuse;
+      for (ctg = 0; ctg < ctgFuse; ctg++)
+        probRow[ctg] += weight[ctg];
+    }
+  }
+
  protected:
   class PMPredict *pmPredict;
   const unsigned int nTree;
   const unsigned int nRow;
-  unsigned int *predictLeaves;
+  unsigned int *predictLeaves; // Null iff fused.
+  double *fuseAcc; // Per-row accumulators, iff fused.
+
+  static class PMPredict *StreamMap(unsigned int nPredNum, unsigned int nPredFac, double *numT, unsigned int *facT);
+  void LeavesInit();
+  void PredictBlock(const class Forest *forest, const class BitMatrix *bag, unsigned int rowStart, unsigned int rowEnd);
+  bool FuseInit(const class LeafPerf *leafPerf, unsigned int ctgWidth, const double *weight);
+  void FuseClear(unsigned int rowStart, unsigned int rowEnd);
+
+
+  /**
+     @return accumulators of the row at block offset passed.
+   */
+  inline const double *FuseRow(unsigned int blockRow) const {
+    return fuseAcc + fuseStride * blockRow;
+  }
 
  public:  
   
   Predict(class PMPredict *_pmPredict, unsigned int _nTree, unsigned int _nRow, unsigned int _noLeaf);
   virtual ~Predict();
 
-  static void Regression(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred);
+  static void Regression(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred);
+
+
+  static void Quantiles(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, const class BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred, const std::vector<double> &quantVec, unsigned int qBin, std::vector<double> &qPred, bool validate);
 
+  static void Classification(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, const std::vector<unsigned int> &_valFac, const std::vector<unsigned int> &_rowStartFac, const std::vector<unsigned int> &_runLengthFac, const std::vector<unsigned int> &_predStartFac, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, std::vector<unsigned int> &_yPred, unsigned int *_census, const std::vector<unsigned int> &_yTest, unsigned int *_conf, std::vector<double> &_error, double *_prob);
 
-  static void Quantiles(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, const class BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, std::vector<double> &_yPred, const std::vector<double> &quantVec, unsigned int qBin, std::vector<double> &qPred, bool validate);
+  static unsigned int Regression(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, const std::vector<double> &yTrain);
 
-  static void Classification(const std::vector<double> &valNum, const std::vector<unsigned int> &rowStart, const std::vector<unsigned int> &runLength, const std::vector<unsigned int> &_predStart, double *_blockNumT, unsigned int *_blockFacT, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _bagBits[], unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, std::vector<unsigned int> &_yPred, unsigned int *_census, const std::vector<unsigned int> &_yTest, unsigned int *_conf, std::vector<double> &_error, double *_prob);
+  static unsigned int Quantiles(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, const class BagLeaf _bagLeaf[], unsigned int _bagLeafTot, unsigned int _bagBits[], const std::vector<double> &yTrain, const std::vector<double> &quantVec, unsigned int qBin);
+
+  static unsigned int Classification(PredictSource *source, PredictSink *sink, unsigned int _nPredNum, unsigned int _nPredFac, const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOff[], unsigned int _nFac, std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _rowTrain, const double _weight[], unsigned int _ctgWidth, bool doProb);
 
   const double *RowNum(unsigned int row) const;
   const unsigned int *RowFac(unsigned int row) const;
@@ -61,12 +190,16 @@ class Predict {
 
 
   /**
-     @brief Assigns a true leaf index at the prediction coordinates passed.
+     @brief Assigns a true leaf index at the prediction coordinates
+     passed or, if fused, scores the leaf.
 
      @return void.
    */
   inline void LeafIdx(unsigned int blockRow, unsigned int tc, unsigned int leafIdx) {
-    predictLeaves[nTree * blockRow + tc] = leafIdx;
+    if (leafFuse != 0)
+      Fuse(blockRow, tc, leafIdx);
+    else
+      predictLeaves[nTree * blockRow + tc] = leafIdx;
   }
 
   
@@ -80,6 +213,17 @@ class Predict {
   inline const class PMPredict *PredMap() const {
     return pmPredict;
   }
+
+
+  /**
+     @brief Fused rows accumulate in tree order, so a row's trees must
+     be walked by a single task.
+
+     @return true iff leaves are scored as reached.
+   */
+  inline bool Fused() const {
+    return leafFuse != 0;
+  }
 };
 
 
@@ -96,6 +240,7 @@ class PredictReg : public Predict {
 
   void PredictAcross(const class Forest *forest);
   void PredictAcross(const Forest *forest, class Quant *quant, double qPred[], bool validate);
+  unsigned int PredictStream(const Forest *forest, class Quant *quant, double qPred[], PredictSource *source, PredictSink *sink, double numT[], unsigned int facT[]);
 
   
   /**
@@ -110,15 +255,17 @@ class PredictReg : public Predict {
 
 
 class PredictCtg : public Predict {
+  static const unsigned int voteTile = 64; // Rows scored per task.
+
   const class LeafPerfCtg *leafCtg;
   const unsigned int ctgWidth;
   std::vector<unsigned int> &yPred;
   unsigned int defaultScore;
   std::vector<double> defaultWeight;
   void Validate(const std::vector<unsigned int> &yTest, unsigned int confusion[], std::vector<double> &error);
-  void Vote(double *votes, unsigned int census[]);
+  unsigned int ArgMax(const unsigned int count[], const double jitter[]) const;
   void Prob(double *prob, unsigned int rowStart, unsigned int rowEnd);
-  void Score(double *votes, unsigned int rowStart, unsigned int rowEnd);
+  void Score(unsigned int census[], unsigned int rowStart, unsigned int rowEnd);
   unsigned int DefaultScore();
   void DefaultInit();
   double DefaultWeight(double *weightPredict);
@@ -127,5 +274,6 @@ class PredictCtg : public Predict {
   ~PredictCtg();
 
   void PredictAcross(const class Forest *forest, unsigned int *census, const std::vector<unsigned int> &yTest, unsigned int *conf, std::vector<double> &error, double *prob);
+  unsigned int PredictStream(const class Forest *forest, unsigned int *census, double *prob, PredictSource *source, PredictSink *sink, double numT[], unsigned int facT[]);
 };
 #endif
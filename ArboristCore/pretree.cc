@@ -29,25 +29,23 @@
 // the need to revise dangling non-terminals from an earlier level.
 //
 
-unsigned int PreTree::heightEst = 0;
-
 /**
-   @brief Caches the row count and computes an initial estimate of node count.
+   @brief Computes an initial estimate of node count.
 
    @param _nSamp is the number of samples.
 
    @param _minH is the minimal splitable index node size.
 
-   @return void.
+   @return initial height estimate.
  */
-void PreTree::Immutables(unsigned int _nSamp, unsigned int _minH) {
-  // Static initial estimate of pre-tree heights employs a minimal enclosing
+unsigned int PreTree::HeightEst(unsigned int _nSamp, unsigned int _minH) {
+  // Initial estimate of pre-tree heights employs a minimal enclosing
   // balanced tree.  This is probably naive, given that decision trees
   // are not generally balanced.
   //
-  // In any case, 'heightEst' is re-estimated following construction of the
-  // first PreTree block.  Hence the value is not really immutable.  Nodes
-  // can also be reallocated during the interlevel pass as needed.
+  // In any case, the estimate is revised following construction of the
+  // first PreTree block.  Nodes can also be reallocated during the
+  // interlevel pass as needed.
   //
   unsigned twoL = 1; // 2^level, beginning from level zero (root).
   while (twoL * _minH < _nSamp) {
@@ -55,23 +53,18 @@ void PreTree::Immutables(unsigned int _nSamp, unsigned int _minH) {
   }
 
   // Terminals plus accumulated nonterminals.
-  heightEst = (twoL << 2); // - 1, for exact count.
-}
-
-
-void PreTree::DeImmutables() {
-  heightEst = 0;
+  return twoL << 2; // - 1, for exact count.
 }
 
 
 /**
    @brief Per-tree initializations.
 
-   @param _treeBlock is the number of PreTree initialize.
+   @param heightEst is the job's current estimate of tree height.
 
    @return void.
  */
-PreTree::PreTree(const PMTrain *_pmTrain, unsigned int _bagCount) : pmTrain(_pmTrain), height(1), leafCount(1), bitEnd(0), bagCount(_bagCount), info(std::vector<double>(pmTrain->NPred())) {
+PreTree::PreTree(const PMTrain *_pmTrain, unsigned int _bagCount, unsigned int heightEst) : pmTrain(_pmTrain), height(1), leafCount(1), bitEnd(0), bagCount(_bagCount), info(std::vector<double>(pmTrain->NPred())) {
   std::fill(info.begin(), info.end(), 0.0);
 
   nodeCount = heightEst;   // Initial height estimate.
@@ -104,20 +97,6 @@ void PreTree::LHBit(int idx, unsigned int pos) {
 }
 
 
-/**
-   @brief Refines the height estimate using the actual height of a
-   constructed PreTree.
-
-   @param height is an actual height value.
-
-   @return void.
- */
-void PreTree::Reserve(unsigned int height) {
-  while (heightEst <= height) // Assigns next power-of-two above 'height'.
-    heightEst <<= 1;
-}
-
-
 /**
    @brief Allocates a zero-valued bit string for the current (pre)tree.
 
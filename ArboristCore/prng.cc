@@ -0,0 +1,92 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file prng.cc
+
+   @brief Methods for counter-based generation of uniform variates.
+
+   @author Mark Seligman
+ */
+
+#include "prng.h"
+
+//#include <iostream>
+//using namespace std;
+
+/**
+   @brief Keys the generator for a training job.
+
+   @param _seed is the front end's seed.
+ */
+PRNG::PRNG(unsigned int _seed) {
+  key[0] = _seed;
+  key[1] = ~_seed ^ weyl1;
+}
+
+
+/**
+   @brief Applies the keyed Philox rounds to a counter block, in place.
+
+   @param ctr inputs the counter and outputs four random words.
+
+   @return void, with side-effected counter.
+ */
+void PRNG::Bijection(uint32_t ctr[4]) const {
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (unsigned int round = 0; round < nRound; round++) {
+    uint64_t prod0 = uint64_t(mult0) * ctr[0];
+    uint64_t prod1 = uint64_t(mult1) * ctr[2];
+    uint32_t hi0 = prod0 >> 32;
+    uint32_t hi1 = prod1 >> 32;
+    ctr[0] = hi1 ^ ctr[1] ^ k0;
+    ctr[1] = uint32_t(prod1);
+    ctr[2] = hi0 ^ ctr[3] ^ k1;
+    ctr[3] = uint32_t(prod0);
+    k0 += weyl0;
+    k1 += weyl1;
+  }
+}
+
+
+/**
+   @brief Fills a vector with uniform variates from the stream addressed
+   by tree, level and draw type.
+
+   @param tIdx is the absolute tree index.
+
+   @param level is the tree-relative level index.
+
+   @param draw distinguishes consumers within a single level.
+
+   @param len is the number of variates to generate.
+
+   @param out[] outputs the generated variates.
+
+   @param start is the stream position of the first variate, allowing a
+   stream to be drawn piecewise.  Positions beyond 2^33 fold their high
+   bits into the draw word, above the draw types, so that counters remain
+   distinct.
+
+   @return void, with output vector parameter.
+ */
+void PRNG::RUnif(unsigned int tIdx, unsigned int level, unsigned int draw, unsigned int len, double out[], uint64_t start) const {
+  for (unsigned int idx = 0; idx < len; ) {
+    uint64_t pos = start + idx;
+    uint32_t ctr[4] = { uint32_t(pos >> 1), level, draw | uint32_t(pos >> 33) << 8, tIdx };
+    Bijection(ctr);
+    if ((pos & 1) == 0) {
+      out[idx++] = Unit(ctr[0], ctr[1]);
+      if (idx < len)
+        out[idx++] = Unit(ctr[2], ctr[3]);
+    }
+    else {
+      out[idx++] = Unit(ctr[2], ctr[3]);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file prng.h
+
+   @brief Counter-based pseudo-random number generation, independent of
+   the front end.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_PRNG_H
+#define ARBORIST_PRNG_H
+
+#include <cstdint>
+
+/**
+   @brief Philox4x32-10 generator, after Salmon et al., "Parallel random
+   numbers:  as easy as 1, 2, 3".
+
+   Variates are a pure function of the seed and of a four-word counter,
+   so that streams addressed by distinct (tree, level, draw) triples are
+   independent of one another and of the order, or thread, in which they
+   are drawn.
+ */
+class PRNG {
+  static const uint32_t mult0 = 0xD2511F53;
+  static const uint32_t mult1 = 0xCD9E8D57;
+  static const uint32_t weyl0 = 0x9E3779B9;
+  static const uint32_t weyl1 = 0xBB67AE85;
+  static const unsigned int nRound = 10;
+  uint32_t key[2];
+
+  void Bijection(uint32_t ctr[4]) const;
+
+ public:
+  // Draw types:  enumerate the consumers of variates within a level.
+  static const unsigned int rowSample = 0;
+  static const unsigned int predSplit = 1;
+  static const unsigned int predMono = 2;
+  static const unsigned int runWide = 3;
+
+  PRNG(unsigned int _seed);
+  void RUnif(unsigned int tIdx, unsigned int level, unsigned int draw, unsigned int len, double out[], uint64_t start = 0) const;
+
+
+  /**
+     @brief Maps a pair of 32-bit words onto the open unit interval
+     using 53 bits of precision.
+
+     @return uniform variate strictly between zero and one.
+   */
+  static inline double Unit(uint32_t hi, uint32_t lo) {
+    uint64_t bits = (uint64_t(hi >> 5) << 26) | (lo >> 6);
+    return (bits + 0.5) * (1.0 / 9007199254740992.0); // 2^53.
+  }
+};
+
+#endif
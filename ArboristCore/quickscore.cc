@@ -0,0 +1,153 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file quickscore.cc
+
+   @brief Construction and evaluation of bitvector-scored forests.
+
+   @author Mark Seligman
+ */
+
+#include "quickscore.h"
+#include "forest.h"
+
+#include <algorithm>
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Split record gathered while numbering leaves, prior to sorting.
+ */
+class QuickCut {
+ public:
+  unsigned int pred;
+  double num;
+  unsigned int tIdx;
+  unsigned long long mask;
+
+  QuickCut(unsigned int _pred, double _num, unsigned int _tIdx, unsigned long long _mask) : pred(_pred), num(_num), tIdx(_tIdx), mask(_mask) {
+  }
+
+
+  inline bool operator<(const QuickCut &other) const {
+    return pred < other.pred || (pred == other.pred && num < other.num);
+  }
+};
+
+
+/**
+   @brief Constructor.  Vectors are filled by the factory.
+ */
+QuickScore::QuickScore(unsigned int _nTree, unsigned int nPred) : nTree(_nTree), predOrigin(std::vector<unsigned int>(nPred + 1)), leafIdx(std::vector<unsigned int>(_nTree * leafMax)) {
+}
+
+
+/**
+   @brief Reorganizes a forest of numeric splits by predictor.
+
+   @param _forestNode are the trained nodes, with numeric splits only.
+
+   @param _height is the total number of nodes.
+
+   @param _nPred is the number of (numeric) predictors.
+
+   @return new scorer, or null if some tree has too many leaves.
+ */
+QuickScore *QuickScore::Factory(const ForestNode _forestNode[], const unsigned int _treeOrigin[], unsigned int _nTree, unsigned int _height, unsigned int _nPred) {
+  for (unsigned int tIdx = 0; tIdx < _nTree; tIdx++) {
+    unsigned int treeSup = tIdx + 1 < _nTree ? _treeOrigin[tIdx + 1] : _height;
+    if (treeSup - _treeOrigin[tIdx] >= 2 * leafMax)
+      return 0;
+  }
+
+  QuickScore *quickScore = new QuickScore(_nTree, _nPred);
+  std::vector<QuickCut> cutTemp;
+  for (unsigned int tIdx = 0; tIdx < _nTree; tIdx++) {
+    if (quickScore->TreeLeaves(&_forestNode[_treeOrigin[tIdx]], tIdx, 0, 0, cutTemp) > leafMax) {
+      delete quickScore;
+      return 0;
+    }
+  }
+
+  std::sort(cutTemp.begin(), cutTemp.end());
+  quickScore->cut.reserve(cutTemp.size());
+  quickScore->cutTree.reserve(cutTemp.size());
+  quickScore->cutMask.reserve(cutTemp.size());
+  for (auto qc : cutTemp) {
+    quickScore->predOrigin[qc.pred + 1]++;
+    quickScore->cut.push_back(qc.num);
+    quickScore->cutTree.push_back(qc.tIdx);
+    quickScore->cutMask.push_back(qc.mask);
+  }
+  for (unsigned int predIdx = 0; predIdx < _nPred; predIdx++) {
+    quickScore->predOrigin[predIdx + 1] += quickScore->predOrigin[predIdx];
+  }
+
+  return quickScore;
+}
+
+
+/**
+   @brief Numbers the leaves beneath a node from left to right, recording
+   the splits encountered.
+
+   @param treeNode are the tree's nodes.
+
+   @param nodeIdx is the tree-relative index of the node.
+
+   @param leafStart is the position of the node's leftmost leaf.
+
+   @param cutTemp accumulates the splits.
+
+   @return position beyond the node's rightmost leaf, exceeding 'leafMax'
+   iff the tree has too many leaves.
+ */
+unsigned int QuickScore::TreeLeaves(const ForestNode *treeNode, unsigned int tIdx, unsigned int nodeIdx, unsigned int leafStart, std::vector<QuickCut> &cutTemp) {
+  unsigned int pred, bump;
+  double num;
+  treeNode[nodeIdx].Ref(pred, bump, num);
+  if (bump == 0) {
+    if (leafStart < leafMax)
+      leafIdx[tIdx * leafMax + leafStart] = pred;
+    return leafStart + 1;
+  }
+
+  unsigned int leftSup = TreeLeaves(treeNode, tIdx, nodeIdx + bump, leafStart, cutTemp);
+  if (leftSup >= leafMax)
+    return leafMax + 1;
+
+  unsigned long long leftBits = ((1ull << (leftSup - leafStart)) - 1) << leafStart;
+  cutTemp.emplace_back(pred, num, tIdx, ~leftBits);
+
+  return TreeLeaves(treeNode, tIdx, nodeIdx + bump + 1, leftSup, cutTemp);
+}
+
+
+/**
+   @brief Computes each tree's surviving leaves over a row.  Splits are
+   failed by arguments exceeding the threshold, or unordered, so the
+   scan of a predictor's splits ends at the first not failed.
+
+   @param rowT is a numeric data array section corresponding to the row.
+
+   @param exitBits outputs the surviving leaves, by tree.
+
+   @return void, with output parameter vector.
+ */
+void QuickScore::Exits(const double rowT[], unsigned long long exitBits[]) const {
+  std::fill(exitBits, exitBits + nTree, ~0ull);
+  unsigned int nPred = predOrigin.size() - 1;
+  for (unsigned int predIdx = 0; predIdx < nPred; predIdx++) {
+    double val = rowT[predIdx];
+    for (unsigned int cutIdx = predOrigin[predIdx]; cutIdx < predOrigin[predIdx + 1] && !(val <= cut[cutIdx]); cutIdx++) {
+      exitBits[cutTree[cutIdx]] &= cutMask[cutIdx];
+    }
+  }
+}
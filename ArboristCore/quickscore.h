@@ -0,0 +1,71 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file quickscore.h
+
+   @brief Bitvector evaluation of shallow numeric forests, after the
+   QuickScorer scheme.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_QUICKSCORE_H
+#define ARBORIST_QUICKSCORE_H
+
+#include <vector>
+
+
+/**
+   @brief Forest of numeric splits reorganized by predictor.  Leaves of
+   each tree are numbered left to right, so that a tree's exit leaf is
+   the leftmost not lying beneath the left branch of a split failing its
+   test.  Each split carries the mask of leaves its failure eliminates,
+   and splits of a predictor are sorted by threshold, so that those
+   failed by a row form a prefix.
+ */
+class QuickScore {
+  static const unsigned int leafMax = 64; // Leaves per tree.
+
+  const unsigned int nTree;
+  std::vector<unsigned int> predOrigin; // Per-predictor offsets into cuts.
+  std::vector<double> cut; // Split thresholds, ascending by predictor.
+  std::vector<unsigned int> cutTree; // Tree owning the split.
+  std::vector<unsigned long long> cutMask; // Leaves surviving failure.
+  std::vector<unsigned int> leafIdx; // Leaf indices, by tree and position.
+
+  QuickScore(unsigned int _nTree, unsigned int nPred);
+  unsigned int TreeLeaves(const class ForestNode *treeNode, unsigned int tIdx, unsigned int nodeIdx, unsigned int leafStart, std::vector<class QuickCut> &cutTemp);
+
+ public:
+  static QuickScore *Factory(const class ForestNode _forestNode[], const unsigned int _treeOrigin[], unsigned int _nTree, unsigned int _height, unsigned int _nPred);
+  void Exits(const double rowT[], unsigned long long exitBits[]) const;
+
+
+  /**
+     @brief Maps a tree's surviving leaves to its exit leaf.
+
+     @param exitBits are the tree's surviving leaves, as computed by Exits().
+
+     @return leaf index of the leftmost survivor.
+   */
+  inline unsigned int Leaf(unsigned int tIdx, unsigned long long exitBits) const {
+#if defined(__GNUC__)
+    unsigned int pos = __builtin_ctzll(exitBits);
+#else
+    unsigned int pos = 0;
+    while ((exitBits & 1ull) == 0) {
+      exitBits >>= 1;
+      pos++;
+    }
+#endif
+    return leafIdx[tIdx * leafMax + pos];
+  }
+};
+
+#endif
@@ -0,0 +1,326 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file regscan.cc
+
+   @brief Scalar and vector kernels for the regression splitting scan.
+   The vector kernels are compiled for their own instruction sets and
+   selected at run time, according to the capabilities of the host.
+
+   @author Mark Seligman
+ */
+
+#include "regscan.h"
+#include "samplepred.h"
+
+#ifdef ARBORIST_SIMD
+#include <immintrin.h>
+#include <cstring>
+#endif
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Constructor.  Accumulators reflect the samples to the right of
+   the first index scanned.
+ */
+RegScan::RegScan(double _sum, unsigned int _sCount, double _sumR, unsigned int _sCountL, unsigned int _rkRight, double _maxInfo) : sum(_sum), sCount(_sCount), sumR(_sumR), sCountL(_sCountL), rkRight(_rkRight), maxInfo(_maxInfo), lhSampCt(0), lhSup(-1), rankLH(0), rankRH(0) {
+}
+
+
+/**
+   @brief Walks indices backward from 'idxTop' through 'idxBot', so that
+   ties are not split, recording cuts whose information strictly exceeds
+   the best thus far.
+
+   @return void.
+ */
+void RegScan::Scan(const SPCol &spn, int idxTop, int idxBot) {
+  for (int i = ScanVector(spn, idxTop, idxBot); i >= idxBot; i--) {
+    double idxInfo = Info();
+    FltVal ySum;
+    unsigned int rkThis, sampleCount;
+    spn.RegFields(i, ySum, rkThis, sampleCount);
+    if (idxInfo > maxInfo && rkThis != rkRight) {
+      Argmax(idxInfo, i, rkThis, rkRight);
+    }
+    sCountL -= sampleCount;
+    sumR += ySum;
+    rkRight = rkThis;
+  }
+}
+
+
+/**
+   @brief Dispatches to the widest vector kernel supported by the host.
+
+   @return highest index remaining to be scanned.
+ */
+int RegScan::ScanVector(const SPCol &spn, int idxTop, int idxBot) {
+#ifdef ARBORIST_SIMD
+  switch (Simd::Level()) {
+  case Simd::avx512:
+    return ScanAVX512(spn, idxTop, idxBot);
+  case Simd::avx2:
+    return ScanAVX2(spn, idxTop, idxBot);
+  default:
+    break;
+  }
+#endif
+  (void) spn; (void) idxBot;
+  return idxTop;
+}
+
+
+/**
+   @brief Reduces the per-lane bests of a vector scan, lane 'j' having
+   recorded its cuts by block top.  Higher indices are preferred among
+   equals, as in the scalar walk.
+
+   @param rkTop is the rank to the right of 'idxTop'.
+
+   @return void.
+ */
+void RegScan::LaneArgmax(const SPCol &spn, int idxTop, unsigned int rkTop, int laneCount, const double infoLane[], const double supLane[], const double sampLane[]) {
+  int supBest = -1;
+  double infoBest = maxInfo;
+  unsigned int sampBest = 0;
+  for (int j = 0; j < laneCount; j++) {
+    int sup = supLane[j] < 0.0 ? -1 : int(supLane[j]) - j; // Block top, less lane.
+    if (sup >= 0 && (infoLane[j] > infoBest || (infoLane[j] == infoBest && sup > supBest))) {
+      supBest = sup;
+      infoBest = infoLane[j];
+      sampBest = sampLane[j];
+    }
+  }
+  if (supBest >= 0) {
+    maxInfo = infoBest;
+    lhSampCt = sampBest;
+    lhSup = supBest;
+    rankLH = spn.Rank(supBest);
+    rankRH = supBest == idxTop ? rkTop : spn.Rank(supBest + 1);
+  }
+}
+
+
+#ifdef ARBORIST_SIMD
+
+namespace avx512 {
+static const int laneCount = 8;
+
+/**
+   @brief Widens the ranks of a block to 32 bits, in index order.
+ */
+ARBORIST_AVX512 static inline __m256i RankLanes(const SPCol &spn, int low) {
+  switch (spn.RankWidth()) {
+  case 1:
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (spn.RankBase() + low)));
+  case 2:
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (spn.RankBase() + 2 * low)));
+  default:
+    return _mm256_loadu_si256((const __m256i *) (spn.RankBase() + 4 * low));
+  }
+}
+
+
+/**
+   @brief Sums the lanes, as does _mm512_reduce_add_pd(), but through
+   zero-masked extraction rather than undefined upper halves.
+ */
+ARBORIST_AVX512 static inline double ReduceAdd(__m512d v) {
+  __m256d quad = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xf, v, 0), _mm512_maskz_extractf64x4_pd(0xf, v, 1));
+  __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(quad), _mm256_extractf128_pd(quad, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+
+/**
+   @brief Block of successive indices, lane 'j' holding the index 'j'
+   below the block's top.  Columns are loaded contiguously, then reversed.
+   Widening conversions are zero-masked, so that no lane is read before
+   being defined.
+ */
+struct Lanes {
+  __m512d y;
+  __m512d sCount;
+  __mmask8 untied; // Lanes whose rank differs from that to the right.
+  double ySum;
+  unsigned int sCountSum;
+
+  ARBORIST_AVX512 inline Lanes(const SPCol &spn, int idx, unsigned int &rkRight) : y(_mm512_setzero_pd()), sCount(_mm512_setzero_pd()), untied(0), ySum(0.0), sCountSum(0) {
+    const int low = idx - (laneCount - 1);
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    y = _mm512_maskz_cvtps_pd(0xff, _mm256_permutevar8x32_ps(_mm256_loadu_ps(spn.YSumBase() + low), rev));
+    sCount = _mm512_maskz_cvtepi32_pd(0xff, _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) (spn.SCountBase() + low)), rev));
+    __m256i rk = _mm256_permutevar8x32_epi32(RankLanes(spn, low), rev);
+    untied = _mm256_cmpneq_epi32_mask(rk, _mm256_alignr_epi32(rk, _mm256_set1_epi32(rkRight), 7));
+    ySum = ReduceAdd(y);
+    sCountSum = ReduceAdd(sCount);
+    rkRight = spn.Rank(low);
+  }
+};
+
+
+/**
+   @brief Exclusive prefix sum across lanes.
+ */
+ARBORIST_AVX512 static inline __m512d PrefixExclusive(__m512d v) {
+  const __m512i sh1 = _mm512_setr_epi64(0, 0, 1, 2, 3, 4, 5, 6);
+  const __m512i sh2 = _mm512_setr_epi64(0, 0, 0, 1, 2, 3, 4, 5);
+  const __m512i sh4 = _mm512_setr_epi64(0, 0, 0, 0, 0, 1, 2, 3);
+  __m512d t = _mm512_maskz_permutexvar_pd(0xfe, sh1, v);
+  t = _mm512_add_pd(t, _mm512_maskz_permutexvar_pd(0xfe, sh1, t));
+  t = _mm512_add_pd(t, _mm512_maskz_permutexvar_pd(0xfc, sh2, t));
+  return _mm512_add_pd(t, _mm512_maskz_permutexvar_pd(0xf0, sh4, t));
+}
+}
+
+
+/**
+   @brief Scans whole blocks of eight indices, lane 'j' evaluating the cut
+   at the block's top index less 'j'.  Accumulators are advanced by prefix
+   sums across the lanes.  Each lane retains its own best cut, the lanes
+   being reduced on exit.
+
+   @return highest index remaining to be scanned.
+ */
+ARBORIST_AVX512 int RegScan::ScanAVX512(const SPCol &spn, int idxTop, int idxBot) {
+  using namespace avx512;
+  const __m512d sumV = _mm512_set1_pd(sum);
+  const __m512d sCountV = _mm512_set1_pd(sCount);
+  __m512d maxV = _mm512_set1_pd(maxInfo);
+  __m512d supV = _mm512_set1_pd(-1.0);
+  __m512d sampV = _mm512_setzero_pd();
+  const unsigned int rkTop = rkRight;
+  int idx = idxTop;
+  for (; idx - (laneCount - 1) >= idxBot; idx -= laneCount) {
+    Lanes lanes(spn, idx, rkRight);
+    __m512d sumRV = _mm512_add_pd(_mm512_set1_pd(sumR), PrefixExclusive(lanes.y));
+    __m512d sCountLV = _mm512_sub_pd(_mm512_set1_pd(sCountL), PrefixExclusive(lanes.sCount));
+    __m512d sumLV = _mm512_sub_pd(sumV, sumRV);
+    __m512d infoV = _mm512_add_pd(_mm512_div_pd(_mm512_mul_pd(sumLV, sumLV), sCountLV), _mm512_div_pd(_mm512_mul_pd(sumRV, sumRV), _mm512_sub_pd(sCountV, sCountLV)));
+    __mmask8 better = lanes.untied & _mm512_cmp_pd_mask(infoV, maxV, _CMP_GT_OQ);
+    maxV = _mm512_mask_blend_pd(better, maxV, infoV);
+    supV = _mm512_mask_blend_pd(better, supV, _mm512_set1_pd(idx));
+    sampV = _mm512_mask_blend_pd(better, sampV, sCountLV);
+    sumR += lanes.ySum;
+    sCountL -= lanes.sCountSum;
+  }
+
+  double infoLane[laneCount], supLane[laneCount], sampLane[laneCount];
+  _mm512_storeu_pd(infoLane, maxV);
+  _mm512_storeu_pd(supLane, supV);
+  _mm512_storeu_pd(sampLane, sampV);
+  LaneArgmax(spn, idxTop, rkTop, laneCount, infoLane, supLane, sampLane);
+
+  return idx;
+}
+
+
+namespace avx2 {
+static const int laneCount = 4;
+
+/**
+   @brief Widens the ranks of a block to 32 bits, in index order.
+ */
+ARBORIST_AVX2 static inline __m128i RankLanes(const SPCol &spn, int low) {
+  switch (spn.RankWidth()) {
+  case 1: {
+    int packed;
+    std::memcpy(&packed, spn.RankBase() + low, sizeof(packed));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+  }
+  case 2:
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *) (spn.RankBase() + 2 * low)));
+  default:
+    return _mm_loadu_si128((const __m128i *) (spn.RankBase() + 4 * low));
+  }
+}
+
+
+/**
+   @brief Block of successive indices, lane 'j' holding the index 'j'
+   below the block's top.  Columns are loaded contiguously, then reversed.
+ */
+struct Lanes {
+  __m256d y;
+  __m256d sCount;
+  __m256d tied; // Lanes whose rank equals that to the right.
+  double ySum;
+  unsigned int sCountSum;
+
+  ARBORIST_AVX2 inline Lanes(const SPCol &spn, int idx, unsigned int &rkRight) : y(_mm256_setzero_pd()), sCount(_mm256_setzero_pd()), tied(_mm256_setzero_pd()), ySum(0.0), sCountSum(0) {
+    const int low = idx - (laneCount - 1);
+    __m128 yLow = _mm_loadu_ps(spn.YSumBase() + low);
+    y = _mm256_cvtps_pd(_mm_shuffle_ps(yLow, yLow, 0x1b));
+    __m128i sc = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) (spn.SCountBase() + low)), 0x1b);
+    sCount = _mm256_cvtepi32_pd(sc);
+    __m128i rk = _mm_shuffle_epi32(RankLanes(spn, low), 0x1b);
+    __m128i tie = _mm_cmpeq_epi32(rk, _mm_alignr_epi8(rk, _mm_set1_epi32(rkRight), 12));
+    tied = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(tie));
+    __m256d pair = _mm256_hadd_pd(y, y);
+    ySum = _mm_cvtsd_f64(_mm_add_sd(_mm256_castpd256_pd128(pair), _mm256_extractf128_pd(pair, 1)));
+    sc = _mm_hadd_epi32(sc, sc);
+    sCountSum = _mm_cvtsi128_si32(_mm_hadd_epi32(sc, sc));
+    rkRight = spn.Rank(low);
+  }
+};
+
+
+/**
+   @brief Exclusive prefix sum across lanes.
+ */
+ARBORIST_AVX2 static inline __m256d PrefixExclusive(__m256d v) {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d t = _mm256_blend_pd(zero, _mm256_permute4x64_pd(v, 0x90), 0xe);
+  t = _mm256_add_pd(t, _mm256_blend_pd(zero, _mm256_permute4x64_pd(t, 0x90), 0xe));
+  return _mm256_add_pd(t, _mm256_blend_pd(zero, _mm256_permute4x64_pd(t, 0x40), 0xc));
+}
+}
+
+
+/**
+   @brief As above, over blocks of four indices.
+
+   @return highest index remaining to be scanned.
+ */
+ARBORIST_AVX2 int RegScan::ScanAVX2(const SPCol &spn, int idxTop, int idxBot) {
+  using namespace avx2;
+  const __m256d sumV = _mm256_set1_pd(sum);
+  const __m256d sCountV = _mm256_set1_pd(sCount);
+  __m256d maxV = _mm256_set1_pd(maxInfo);
+  __m256d supV = _mm256_set1_pd(-1.0);
+  __m256d sampV = _mm256_setzero_pd();
+  const unsigned int rkTop = rkRight;
+  int idx = idxTop;
+  for (; idx - (laneCount - 1) >= idxBot; idx -= laneCount) {
+    Lanes lanes(spn, idx, rkRight);
+    __m256d sumRV = _mm256_add_pd(_mm256_set1_pd(sumR), PrefixExclusive(lanes.y));
+    __m256d sCountLV = _mm256_sub_pd(_mm256_set1_pd(sCountL), PrefixExclusive(lanes.sCount));
+    __m256d sumLV = _mm256_sub_pd(sumV, sumRV);
+    __m256d infoV = _mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(sumLV, sumLV), sCountLV), _mm256_div_pd(_mm256_mul_pd(sumRV, sumRV), _mm256_sub_pd(sCountV, sCountLV)));
+    __m256d better = _mm256_andnot_pd(lanes.tied, _mm256_cmp_pd(infoV, maxV, _CMP_GT_OQ));
+    maxV = _mm256_blendv_pd(maxV, infoV, better);
+    supV = _mm256_blendv_pd(supV, _mm256_set1_pd(idx), better);
+    sampV = _mm256_blendv_pd(sampV, sCountLV, better);
+    sumR += lanes.ySum;
+    sCountL -= lanes.sCountSum;
+  }
+
+  double infoLane[laneCount], supLane[laneCount], sampLane[laneCount];
+  _mm256_storeu_pd(infoLane, maxV);
+  _mm256_storeu_pd(supLane, supV);
+  _mm256_storeu_pd(sampLane, sampV);
+  LaneArgmax(spn, idxTop, rkTop, laneCount, infoLane, supLane, sampLane);
+
+  return idx;
+}
+
+#endif
@@ -0,0 +1,80 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file regscan.h
+
+   @brief Weighted-variance scan over a run of rank-ordered regression
+   samples.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_REGSCAN_H
+#define ARBORIST_REGSCAN_H
+
+#include "simd.h"
+
+/**
+   @brief Running state of a backward scan for the maximal weighted
+   variance, sumL^2 / sCountL + sumR^2 / sCountR, over cuts which do not
+   separate tied ranks.  Successive runs may be scanned, with the caller
+   free to adjust the accumulators, or to offer cuts of its own, between
+   runs.
+ */
+class RegScan {
+  const double sum; // Sum of responses over the node.
+  const unsigned int sCount; // Sample count over the node.
+
+  int ScanVector(const class SPCol &spn, int idxTop, int idxBot);
+  void LaneArgmax(const class SPCol &spn, int idxTop, unsigned int rkTop, int laneCount, const double infoLane[], const double supLane[], const double sampLane[]);
+
+#ifdef ARBORIST_SIMD
+  ARBORIST_AVX2 int ScanAVX2(const class SPCol &spn, int idxTop, int idxBot);
+  ARBORIST_AVX512 int ScanAVX512(const class SPCol &spn, int idxTop, int idxBot);
+#endif
+
+ public:
+  double sumR; // Response sum to the right of the current index.
+  unsigned int sCountL; // Sample count up to and including current index.
+  unsigned int rkRight; // Rank of the index to the right.
+
+  double maxInfo; // Information of the best cut thus far.
+  unsigned int lhSampCt; // Left-hand sample count of the best cut.
+  int lhSup; // Left-hand supremum index of the best cut, if any, else -1.
+  unsigned int rankLH; // Greatest left-hand rank of the best cut.
+  unsigned int rankRH; // Least right-hand rank of the best cut.
+
+  RegScan(double _sum, unsigned int _sCount, double _sumR, unsigned int _sCountL, unsigned int _rkRight, double _maxInfo);
+  void Scan(const class SPCol &spn, int idxTop, int idxBot);
+
+
+  /**
+     @return information of a cut with 'sCountL' samples on the left.
+   */
+  inline double Info() const {
+    double sumL = sum - sumR;
+    return (sumL * sumL) / sCountL + (sumR * sumR) / (sCount - sCountL);
+  }
+
+
+  /**
+     @brief Records a cut as the best thus far.
+
+     @return void.
+   */
+  inline void Argmax(double info, int _lhSup, unsigned int _rankLH, unsigned int _rankRH) {
+    maxInfo = info;
+    lhSampCt = sCountL;
+    lhSup = _lhSup;
+    rankLH = _rankLH;
+    rankRH = _rankRH;
+  }
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include "rowrank.h"
 #include "index.h"
 #include "pretree.h"
+#include "context.h"
 
 //#include <iostream>
 using namespace std;
@@ -36,8 +37,8 @@ using namespace std;
 
    @return void.
 */
-ResponseCtg *Response::FactoryCtg(const std::vector<unsigned int> &feCtg, const std::vector<double> &feProxy, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) {
-  return new ResponseCtg(feCtg, feProxy, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits, weight, ctgWidth);
+ResponseCtg *Response::FactoryCtg(const TrainContext &_trainCtx, const std::vector<unsigned int> &feCtg, const std::vector<double> &feProxy, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) {
+  return new ResponseCtg(_trainCtx, feCtg, feProxy, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits, weight, ctgWidth);
 }
 
 
@@ -47,7 +48,7 @@ ResponseCtg *Response::FactoryCtg(const std::vector<unsigned int> &feCtg, const
  @param _proxy is the associated numerical proxy response.
 
 */
-ResponseCtg::ResponseCtg(const std::vector<unsigned int> &_yCtg, const std::vector<double> &_proxy, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) : Response(_proxy, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits, weight, ctgWidth), yCtg(_yCtg) {
+ResponseCtg::ResponseCtg(const TrainContext &_trainCtx, const std::vector<unsigned int> &_yCtg, const std::vector<double> &_proxy, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) : Response(_trainCtx, _proxy, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits, weight, ctgWidth), yCtg(_yCtg) {
 }
 
 
@@ -57,7 +58,7 @@ ResponseCtg::ResponseCtg(const std::vector<unsigned int> &_yCtg, const std::vect
    @param _y is the vector numerical/proxy response values.
 
  */
-Response::Response(const std::vector<double> &_y, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) : y(_y), leaf(new LeafCtg(leafOrigin, leafNode, bagLeaf, bagBits, y.size(), weight, ctgWidth)), pmTrain(_pmTrain) {
+Response::Response(const TrainContext &_trainCtx, const std::vector<double> &_y, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth) : y(_y), leaf(new LeafCtg(leafOrigin, leafNode, bagLeaf, bagBits, y.size(), weight, ctgWidth, _trainCtx.ThinLeaves())), trainCtx(_trainCtx), pmTrain(_pmTrain) {
 }
 
 
@@ -67,7 +68,7 @@ Response::Response(const std::vector<double> &_y, const PMTrain *_pmTrain, std::
    @param _y is the vector numerical/proxy response values.
 
  */
-Response::Response(const std::vector<double> &_y, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) : y(_y), leaf(new LeafReg(leafOrigin, leafNode, bagLeaf, bagBits, y.size())), pmTrain(_pmTrain) {
+Response::Response(const TrainContext &_trainCtx, const std::vector<double> &_y, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) : y(_y), leaf(new LeafReg(leafOrigin, leafNode, bagLeaf, bagBits, y.size(), _trainCtx.ThinLeaves())), trainCtx(_trainCtx), pmTrain(_pmTrain) {
 }
 
 
@@ -91,8 +92,8 @@ ResponseReg::~ResponseReg() {
 
    @return void, with output reference vector.
  */
-ResponseReg *Response::FactoryReg(const std::vector<double> &yNum, const std::vector<unsigned int> &_row2Rank, const PMTrain *_pmTrain, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) {
-  return new ResponseReg(yNum, _row2Rank, _pmTrain, _leafOrigin, _leafNode, bagLeaf, bagBits);
+ResponseReg *Response::FactoryReg(const TrainContext &_trainCtx, const std::vector<double> &yNum, const std::vector<unsigned int> &_row2Rank, const PMTrain *_pmTrain, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) {
+  return new ResponseReg(_trainCtx, yNum, _row2Rank, _pmTrain, _leafOrigin, _leafNode, bagLeaf, bagBits);
 }
 
 
@@ -102,7 +103,7 @@ ResponseReg *Response::FactoryReg(const std::vector<double> &yNum, const std::ve
    @param _y is the response vector.
 
  */
-ResponseReg::ResponseReg(const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) : Response(_y, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits), row2Rank(_row2Rank) {
+ResponseReg::ResponseReg(const TrainContext &_trainCtx, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits) : Response(_trainCtx, _y, _pmTrain, leafOrigin, leafNode, bagLeaf, bagBits), row2Rank(_row2Rank) {
 }
 
 
@@ -111,33 +112,37 @@ ResponseReg::ResponseReg(const std::vector<double> &_y, const std::vector<unsign
 
    @param rowRank is the predictor rank information.
 
+   @param tStart is the absolute index of the first tree in the block.
+
    @param blockSize is the number of trees in the block.
 
+   @param statBlock outputs the instrumentation of each tree.
+
    @return block of SampleCtg instances.
  */
-PreTree **Response::BlockTree(const RowRank *rowRank, unsigned int blockSize) {
+PreTree **Response::BlockTree(const RowRank *rowRank, unsigned int tStart, unsigned int blockSize, std::vector<TrainStat> &statBlock) {
   sampleBlock = new Sample*[blockSize];
   for (unsigned int i = 0; i < blockSize; i++) {
-    sampleBlock[i] = Sampler(rowRank);
+    sampleBlock[i] = Sampler(rowRank, tStart + i);
   }
 
-  return IndexLevel::BlockTrees(pmTrain, sampleBlock, blockSize);
+  return IndexLevel::BlockTrees(trainCtx, pmTrain, sampleBlock, blockSize, statBlock);
 }
 
 
 /**
    @return Regression-style Sample object.
  */
-Sample *ResponseReg::Sampler(const RowRank *rowRank) {
-  return Sample::FactoryReg(pmTrain, Y(), rowRank, row2Rank);
+Sample *ResponseReg::Sampler(const RowRank *rowRank, unsigned int tIdx) {
+  return Sample::FactoryReg(trainCtx, pmTrain, Y(), rowRank, row2Rank, tIdx);
 }
 
 
 /**
    @return Classification-style Sample object.
  */
-Sample *ResponseCtg::Sampler(const class RowRank *rowRank) {
-  return Sample::FactoryCtg(pmTrain, Y(), rowRank, yCtg);
+Sample *ResponseCtg::Sampler(const class RowRank *rowRank, unsigned int tIdx) {
+  return Sample::FactoryCtg(trainCtx, pmTrain, Y(), rowRank, yCtg, tIdx);
 }
 
 
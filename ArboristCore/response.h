@@ -28,25 +28,26 @@ class Response {
   class Leaf *leaf;
   class Sample** sampleBlock;
  protected:
+  const class TrainContext &trainCtx;
   const class PMTrain *pmTrain;
  public:
-  Response(const std::vector<double> &_y, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
-  Response(const std::vector<double> &_y, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
+  Response(const class TrainContext &_trainCtx, const std::vector<double> &_y, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
+  Response(const class TrainContext &_trainCtx, const std::vector<double> &_y, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
   virtual ~Response();
 
   const std::vector<double> &Y() {
     return y;
   }
-  static class ResponseReg *FactoryReg(const std::vector<double> &yNum, const std::vector<unsigned int> &_row2Rank, const class PMTrain *_pmTrain, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
-  static class ResponseCtg *FactoryCtg(const std::vector<unsigned int> &feCtg, const std::vector<double> &feProxy, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
+  static class ResponseReg *FactoryReg(const class TrainContext &_trainCtx, const std::vector<double> &yNum, const std::vector<unsigned int> &_row2Rank, const class PMTrain *_pmTrain, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
+  static class ResponseCtg *FactoryCtg(const class TrainContext &_trainCtx, const std::vector<unsigned int> &feCtg, const std::vector<double> &feProxy, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
 
-  class PreTree **BlockTree(const class RowRank *rowRank, unsigned int blockSize);
+  class PreTree **BlockTree(const class RowRank *rowRank, unsigned int tStart, unsigned int blockSize, std::vector<class TrainStat> &statBlock);
   const class BV *TreeBag(unsigned int blockIdx);
   void LeafReserve(unsigned int leafEst, unsigned int bagEst);
   void DeBlock(unsigned int blockSize);
   void Leaves(const std::vector<unsigned int> &leafMap, unsigned int blockIdx, unsigned int tIdx);
 
-  virtual class Sample* Sampler(const class RowRank *rowRank) = 0;
+  virtual class Sample* Sampler(const class RowRank *rowRank, unsigned int tIdx) = 0;
 };
 
 
@@ -57,9 +58,9 @@ class ResponseReg : public Response {
   const std::vector<unsigned int> &row2Rank; // Facilitates rank[] output.
  public:
 
-  ResponseReg(const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
+  ResponseReg(const class TrainContext &_trainCtx, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<class LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits);
   ~ResponseReg();
-  class Sample *Sampler(const class RowRank *rowRank);
+  class Sample *Sampler(const class RowRank *rowRank, unsigned int tIdx);
 };
 
 /**
@@ -69,9 +70,9 @@ class ResponseCtg : public Response {
   const std::vector<unsigned int> &yCtg; // 0-based factor-valued response.
  public:
 
-  ResponseCtg(const std::vector<unsigned int> &_yCtg, const std::vector<double> &_proxy, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
+  ResponseCtg(const class TrainContext &_trainCtx, const std::vector<unsigned int> &_yCtg, const std::vector<double> &_proxy, const class PMTrain *_pmTrain, std::vector<unsigned int> &leafOrigin, std::vector<LeafNode> &leafNode, std::vector<class BagLeaf> &bagLeaf, std::vector<unsigned int> &bagBits, std::vector<double> &weight, unsigned int ctgWidth);
   ~ResponseCtg();
-  class Sample *Sampler(const class RowRank *rowRank);
+  class Sample *Sampler(const class RowRank *rowRank, unsigned int tIdx);
 };
 
 #endif
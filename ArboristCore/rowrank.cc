@@ -15,6 +15,7 @@
 
 #include "rowrank.h"
 #include "predblock.h"
+#include "mapblock.h"
 
 #include <algorithm>
 
@@ -242,13 +243,63 @@ void RowRank::RankFac(const std::vector<ValRowI> &valRow, std::vector<unsigned i
 
    @param feRank is the vector of ranks allocated by the front end.
 
+   @param spillDir is a directory to back the rank orderings by file,
+   empty iff they are to reside on the heap.  Only the decompressed
+   orderings are mapped:  the front-end arrays are read from memory, and
+   the per-predictor tables remain on the heap.
  */
-RowRank::RowRank(const PMTrain *pmTrain, const unsigned int feRow[], const unsigned int feRank[], const unsigned int *_numOffset, const double *_numVal, const unsigned int feRLE[], unsigned int rleLength, double _autoCompress) : nRow(pmTrain->NRow()), nPred(pmTrain->NPred()), noRank(std::max(nRow, pmTrain->CardMax())), nPredDense(0), denseIdx(std::vector<unsigned int>(nPred)), numOffset(_numOffset), numVal(_numVal), nonCompact(0), accumCompact(0), denseRank(std::vector<unsigned int>(nPred)), rrCount(std::vector<unsigned int>(nPred)), rrStart(std::vector<unsigned int>(nPred)), safeOffset(std::vector<unsigned int>(nPred)), autoCompress(_autoCompress) {
+RowRank::RowRank(const PMTrain *pmTrain, const unsigned int feRow[], const unsigned int feRank[], const unsigned int *_numOffset, const double *_numVal, const unsigned int feRLE[], unsigned int rleLength, double _autoCompress, unsigned int binMax, const std::string &spillDir) : nRow(pmTrain->NRow()), nPred(pmTrain->NPred()), noRank(std::max(nRow, pmTrain->CardMax())), nPredDense(0), denseIdx(std::vector<unsigned int>(nPred)), numOffset(_numOffset), numVal(_numVal), nonCompact(0), accumCompact(0), denseRank(std::vector<unsigned int>(nPred)), rrCount(std::vector<unsigned int>(nPred)), rrStart(std::vector<unsigned int>(nPred)), safeOffset(std::vector<unsigned int>(nPred)), autoCompress(_autoCompress), binCount(std::vector<unsigned int>(nPred)), binOffset(std::vector<unsigned int>(nPred)), rankWidth(std::vector<unsigned int>(nPred)) {
   DenseBlock(feRank, feRLE, rleLength);
   unsigned int rrSlots = ModeOffsets();
-  rrNode = new RRNode[rrSlots];
+  rrBlock = new MapBlock((size_t) rrSlots * sizeof(RRNode), spillDir);
+  rrNode = reinterpret_cast<RRNode *>(rrBlock->Base());
 
   Decompress(feRow, feRank, feRLE, rleLength);
+  if (binMax > 0)
+    BinBlock(pmTrain->NPredNum(), feRank, feRLE, rleLength, binMax);
+}
+
+
+/**
+   @brief Quantizes the ranks of each sparsely-stored numeric predictor
+   into bins of roughly equal row count.  Tied rows share a rank, hence
+   a bin, so bin boundaries never separate ties.
+
+   @param nPredNum is the number of numeric predictors, which precede
+   factors in the RLE block.
+
+   @param binMax is the maximal number of bins per predictor.
+
+   @return void.
+ */
+void RowRank::BinBlock(unsigned int nPredNum, const unsigned int feRank[], const unsigned int feRLE[], unsigned int rleLength, unsigned int binMax) {
+  unsigned int rleIdx = 0;
+  for (unsigned int predIdx = 0; predIdx < nPredNum; predIdx++) {
+    bool binned = denseRank[predIdx] == noRank;
+    std::vector<unsigned int> sup(binned ? binMax : 0);
+    unsigned int binTop = 0; // Highest bin occupied.
+    unsigned int rowTot = 0; // Rows preceding current run.
+    unsigned int rank;
+    unsigned int runLength = RunSlot(feRLE, feRank, rleIdx, rank);
+    while (rowTot < nRow) {
+      if (binned) { // Ties may span runs, but first run fixes the bin.
+        unsigned int bin = rank + 1 > sup[binTop] ? ((unsigned long) rowTot * binMax) / nRow : binTop;
+        sup[bin] = rank + 1;
+        binTop = bin;
+      }
+      rowTot += runLength;
+      if (++rleIdx == rleLength)
+        break;
+      if (rowTot < nRow)
+        runLength = RunSlot(feRLE, feRank, rleIdx, rank);
+    }
+
+    binOffset[predIdx] = binSup.size();
+    binCount[predIdx] = binned ? binTop + 1 : 0;
+    for (unsigned int bin = 0; bin < binCount[predIdx]; bin++) {
+      binSup.push_back(bin > 0 ? std::max(sup[bin], binSup.back()) : sup[bin]);
+    }
+  }
 }
 
 
@@ -272,10 +323,12 @@ void RowRank::DenseBlock(const unsigned int feRank[], const unsigned int feRLE[]
     unsigned int argMax = noRank;
     unsigned int runCount = 0; // Runs across adjacent rle entries.
     unsigned int rankPrev = noRank;
+    unsigned int rankTop = 0;
     unsigned int rank;
     unsigned int runLength = RunSlot(feRLE, feRank, rleIdx, rank);
 
     for (unsigned int rowTot = runLength; rowTot <= nRow; rowTot += runLength) {
+      rankTop = std::max(rank, rankTop);
       if (rank == rankPrev) {
 	runCount += runLength;
       }
@@ -294,6 +347,7 @@ void RowRank::DenseBlock(const unsigned int feRank[], const unsigned int feRLE[]
     // Post condition:  rowTot == nRow.
 
     DenseMode(predIdx, denseMax, argMax);
+    rankWidth[predIdx] = rankTop <= 0xff ? 1 : (rankTop <= 0xffff ? 2 : 4);
   }
 }
 
@@ -394,5 +448,5 @@ void RowRank::Decompress(const unsigned int feRow[], const unsigned int feRank[]
    @return void.
  */
 RowRank::~RowRank() {
-  delete [] rrNode;
+  delete rrBlock;
 }
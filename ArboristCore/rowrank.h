@@ -19,8 +19,10 @@
 #include <vector>
 #include <tuple>
 #include <cmath>
+#include <algorithm>
 
 #include "param.h"
+#include <string>
 //#include <iostream>
 //using namespace std;
 
@@ -69,12 +71,21 @@ class RowRank {
   unsigned int nonCompact;  // Total count of uncompactified predictors.
   unsigned int accumCompact;  // Sum of compactified lengths.
   std::vector<unsigned int> denseRank;
+  class MapBlock *rrBlock; // Backing store for 'rrNode'.
   RRNode *rrNode;
   std::vector<unsigned int> rrCount;
   std::vector<unsigned int> rrStart;
   std::vector<unsigned int> safeOffset; // Either an index or an accumulated count.
   const double autoCompress; // Threshold percentage for autocompression.
 
+  // Histogram splitting:  quantizes numeric ranks to at most 'binMax' bins.
+  // Bins are recorded by their rank suprema, a table small enough to remain
+  // cache-resident while ranks are walked in order.
+  std::vector<unsigned int> binCount; // Per-predictor, zero iff not binned.
+  std::vector<unsigned int> binOffset; // Per-predictor offset into 'binSup'.
+  std::vector<unsigned int> binSup; // Least rank beyond each bin.
+  std::vector<unsigned int> rankWidth; // Per-predictor bytes sufficient to hold a rank.
+
   
   static void FacSort(const unsigned int predCol[], unsigned int _nRow, std::vector<unsigned int> &rowOut, std::vector<unsigned int> &rankOut, std::vector<unsigned int> &rle);
   static void NumSortRaw(const double predCol[], unsigned int _nRow, std::vector<unsigned int> &rowOut, std::vector<unsigned int> &rankOut, std::vector<unsigned int> &rleOut, std::vector<double> &numOut);
@@ -102,6 +113,7 @@ class RowRank {
   void DenseMode(unsigned int predIdx, unsigned int denseMax, unsigned int argMax);
   unsigned int ModeOffsets();
   void Decompress(const unsigned int feRow[], const unsigned int feRank[], const unsigned int feRLE[], unsigned int feRLELength);
+  void BinBlock(unsigned int nPredNum, const unsigned int feRank[], const unsigned int feRLE[], unsigned int feRLELength, unsigned int binMax);
 
   inline double NumVal(unsigned int predIdx, unsigned int rk) const {
     return numVal[numOffset[predIdx] + rk];
@@ -115,7 +127,7 @@ class RowRank {
   static void PreSortFac(const unsigned int _feFac[], unsigned int _nPredFac, unsigned int _nRow, std::vector<unsigned int> &rowOut, std::vector<unsigned int> &rankOut, std::vector<unsigned int> &runLength);
 
 
-  RowRank(const class PMTrain *pmTrain, const unsigned int feRow[], const unsigned int feRank[], const unsigned int _numOffset[], const double _numVal[], const unsigned int feRLE[], unsigned int feRLELength, double _autCompress);
+  RowRank(const class PMTrain *pmTrain, const unsigned int feRow[], const unsigned int feRank[], const unsigned int _numOffset[], const double _numVal[], const unsigned int feRLE[], unsigned int feRLELength, double _autCompress, unsigned int binMax = 0, const std::string &spillDir = std::string());
   ~RowRank();
 
   
@@ -182,6 +194,48 @@ class RowRank {
   }
 
 
+  /**
+     @brief Accessor for the number of bins quantizing a predictor.
+
+     @return bin count, zero iff predictor not split by histogram.
+   */
+  inline unsigned int BinCount(unsigned int predIdx) const {
+    return binCount[predIdx];
+  }
+
+
+  /**
+     @brief Accessor for the narrowest rank encoding of a predictor.
+
+     @return byte count:  1, 2 or 4.
+   */
+  inline unsigned int RankWidth(unsigned int predIdx) const {
+    return rankWidth[predIdx];
+  }
+
+
+  /**
+     @brief Accessor for a predictor's bin suprema.  Nondecreasing, with
+     empty bins repeating their predecessor's supremum.
+
+     @return base of the predictor's supremum vector.
+   */
+  inline const unsigned int *BinSup(unsigned int predIdx) const {
+    return &binSup[binOffset[predIdx]];
+  }
+
+
+  /**
+     @brief Looks up the bin containing a rank.  Bins preserve rank order.
+
+     @return bin index of rank.
+   */
+  inline unsigned int Bin(unsigned int predIdx, unsigned int rank) const {
+    const unsigned int *sup = BinSup(predIdx);
+    return std::upper_bound(sup, sup + binCount[predIdx], rank) - sup;
+  }
+
+
   inline unsigned int NPredDense() const {
     return nPredDense;
   }
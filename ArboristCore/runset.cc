@@ -14,15 +14,12 @@
  */
 
 #include "runset.h"
-#include "callback.h"
+#include "prng.h"
 
 // Testing only:
 //#include <iostream>
 //using namespace std;
 
-unsigned int RunSet::ctgWidth = 0;
-unsigned int RunSet::noStart = 0;
-
 
 /**
    Run objects are allocated per-tree, and live throughout training.
@@ -61,9 +58,7 @@ unsigned int RunSet::noStart = 0;
    @brief Constructor initializes predictor run length either to cardinality, 
    for factors, or to a nonsensical zero, for numerical.
  */
-Run::Run(unsigned int _ctgWidth, unsigned int nRow, unsigned int noCand) : noRun(noCand), ctgWidth(_ctgWidth) {
-  RunSet::ctgWidth = ctgWidth;
-  RunSet::noStart = nRow; // Inattainable start value, irrespective of tree.
+Run::Run(unsigned int _ctgWidth, unsigned int nRow, unsigned int noCand) : noRun(noCand), noStart(nRow), ctgWidth(_ctgWidth) {
   runSet = 0;
   facRun = 0;
   bHeap = 0;
@@ -85,6 +80,7 @@ void Run::RunSets(const std::vector<unsigned int> &safeCount) {
   if (setCount > 0) {
     runSet = new RunSet[setCount];
     for (unsigned int setIdx = 0; setIdx < setCount; setIdx++) {
+      runSet[setIdx].Init(ctgWidth, noStart);
       CountSafe(setIdx, safeCount[setIdx]);
     }
   }
@@ -117,10 +113,16 @@ void Run::OffsetsReg() {
 /**
    @brief Classification:  only wide run sets use the heap.
 
+   @param prng is the job's generator.
+
+   @param tIdx is the absolute tree index.
+
+   @param level is the tree-relative level index.
+
    @return void.
 
 */
-void Run::OffsetsCtg() {
+void Run::OffsetsCtg(const PRNG &prng, unsigned int tIdx, unsigned int level) {
   if (setCount == 0)
     return;
 
@@ -154,7 +156,7 @@ void Run::OffsetsCtg() {
 
   if (ctgWidth > 2 && heapRuns > 0) { // Wide non-binary:  w.o. replacement.
     rvWide = new double[heapRuns];
-    CallBack::RUnif(heapRuns, rvWide);
+    prng.RUnif(tIdx, level, PRNG::runWide, heapRuns, rvWide);
   }
 
   facRun = new FRNode[runCount];
@@ -293,17 +295,19 @@ void RunSet::WriteImplicit(unsigned int denseRank, unsigned int sCountTot, doubl
     }
   }
 
-  Write(denseRank, sCountTot, sumTot, denseCount);
+  Write(denseRank, sCountTot, sumTot, denseCount, noStart);
 }
 
 
 /**
    @brief Implicit runs are characterized by a start value of 'noStart'.
 
+   @param noStart is the tree's inattainable start value.
+
    @return Whether this run is dense.
  */
-bool FRNode::IsImplicit() {
-  return start == RunSet::noStart;
+bool FRNode::IsImplicit(unsigned int noStart) {
+  return start == noStart;
 }
 
 
@@ -330,7 +334,7 @@ bool RunSet::ImplicitLeft() {
 
   for (unsigned int runIdx = 0; runIdx < runsLH; runIdx++) {
     unsigned int outSlot = outZero[runIdx];
-    if (runZero[outSlot].IsImplicit()) {
+    if (runZero[outSlot].IsImplicit(noStart)) {
       return true;
     }
   }
@@ -37,7 +37,7 @@ class FRNode {
 
   FRNode() : start(0), extent(0), sCount(0), sum(0.0) {}
 
-  bool IsImplicit();
+  bool IsImplicit(unsigned int noStart);
 
   
   inline void Init(unsigned int _rank, unsigned int _sCount, double _sum, unsigned int _start, unsigned int _extent) {
@@ -97,11 +97,22 @@ class RunSet {
   unsigned int runsLH; // Count of LH runs.
  public:
   const static unsigned int maxWidth = 10;
-  static unsigned int ctgWidth;
-  static unsigned int noStart;
+  unsigned int ctgWidth; // Response cardinality, zero if regression.
+  unsigned int noStart; // Inattainable start value:  marks implicit run.
   unsigned int safeRunCount;
 
-  RunSet() : hasImplicit(false), runOff(0), heapOff(0), outOff(0), runZero(0), heapZero(0), outZero(0), ctgZero(0), rvZero(0), runCount(0), runsLH(0), safeRunCount(0) {}
+  RunSet() : hasImplicit(false), runOff(0), heapOff(0), outOff(0), runZero(0), heapZero(0), outZero(0), ctgZero(0), rvZero(0), runCount(0), runsLH(0), ctgWidth(0), noStart(0), safeRunCount(0) {}
+
+
+  /**
+     @brief Caches tree-invariant values from the owning Run.
+
+     @return void.
+   */
+  inline void Init(unsigned int _ctgWidth, unsigned int _noStart) {
+    ctgWidth = _ctgWidth;
+    noStart = _noStart;
+  }
 
   bool ImplicitLeft();
   void WriteImplicit(unsigned int denseRank, unsigned int sCountTot, double sumTot, unsigned int denseCount, const double nodeSum[] = 0);
@@ -161,7 +172,7 @@ class RunSet {
 
      @return void.
    */
-  inline void Write(unsigned int rank, unsigned int sCount, double sum, unsigned int extent, unsigned int start = noStart) {
+  inline void Write(unsigned int rank, unsigned int sCount, double sum, unsigned int extent, unsigned int start) {
     runZero[runCount++].Init(rank, sCount, sum, start, extent);
     hasImplicit = (start == noStart ? true : false);
   }
@@ -251,6 +262,7 @@ class RunSet {
 
 class Run {
   const unsigned int noRun;  // Inattainable run index for tree.
+  const unsigned int noStart; // Inattainable start value for tree.
   unsigned int setCount;
   RunSet *runSet;
   FRNode *facRun; // Workspace for FRNodes used along level.
@@ -266,7 +278,7 @@ class Run {
   Run(unsigned int _ctgWidth, unsigned int nRow, unsigned int noCand);
   void LevelClear();
   void OffsetsReg();
-  void OffsetsCtg();
+  void OffsetsCtg(const class PRNG &prng, unsigned int tIdx, unsigned int level);
   void RunSets(const std::vector<unsigned int> &safeCount);
 
 
@@ -15,67 +15,27 @@
 
 #include "sample.h"
 #include "bv.h"
-#include "callback.h"
+#include "context.h"
 #include "rowrank.h"
 #include "samplepred.h"
 #include "bottom.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
 //#include <iostream>
 //using namespace std;
 
-// Simulation-invariant values.
-//
-unsigned int Sample::nRow = 0;
-unsigned int Sample::nSamp = 0;
-
-unsigned int SampleCtg::ctgWidth = 0;
-
-/**
- @brief Lights off initializations needed for sampling.
-
- @param _nRow is the number of response/observation rows.
-
- @param _nSamp is the number of samples.
-
- @return void.
-*/
-void Sample::Immutables(unsigned int _nSamp, const std::vector<double> &_feSampleWeight, bool _withRepl, unsigned int _ctgWidth, unsigned int _nTree) {
-  nRow = _feSampleWeight.size();
-  nSamp = _nSamp;
-  CallBack::SampleInit(nRow, &_feSampleWeight[0], _withRepl);
-  if (_ctgWidth > 0)
-    SampleCtg::Immutables(_ctgWidth, _nTree);
-}
-
-
 /**
-   @return void.
- */
-void SampleCtg::Immutables(unsigned int _ctgWidth, unsigned int _nTree) {
-  ctgWidth = _ctgWidth;
-}
+   @brief Constructor.
 
+   @param _trainCtx supplies the row count, sample count and weighting.
 
-/**
+   @param _tIdx is the absolute tree index.
  */
-void SampleCtg::DeImmutables() {
-  ctgWidth = 0;
-}
-
-
-/**
-   @brief Finalizer.
-
-   @return void.
-*/
-void Sample::DeImmutables() {
-  nRow = 0;
-  nSamp = 0;
-  SampleCtg::DeImmutables();
-}
-
-
-Sample::Sample() : treeBag(new BV(nRow)), row2Sample(std::vector<unsigned int>(nRow)), noSample(nRow) {
+Sample::Sample(const TrainContext &_trainCtx, unsigned int _tIdx) : treeBag(new BV(_trainCtx.NRow())), row2Sample(std::vector<unsigned int>(_trainCtx.NRow())), trainCtx(_trainCtx), nRow(_trainCtx.NRow()), nSamp(_trainCtx.NSamp()), noSample(nRow), tIdx(_tIdx) {
   std::fill(row2Sample.begin(), row2Sample.end(), noSample);
   sampleNode.reserve(nSamp);
 }
@@ -92,27 +52,98 @@ Sample::~Sample() {
    @brief Samples and counts occurrences of each target 'row'
    of the sampling vector.
 
+   Variates are drawn from the tree's own stream, so trees may sample
+   in any order, or concurrently, with reproducible results.
+
    @param sCountRow outputs a vector of sample counts, by row.
 
    @return void.
 */
-void Sample::RowSample(std::vector<unsigned int> &sCountRow) {
-  int *rvRow = new int[nSamp];
-  CallBack::SampleRows(nSamp, rvRow);
+void Sample::RowSample(std::vector<unsigned int> &sCountRow) const {
+  // Weighted sampling without replacement keys every row.
+  bool withRepl = trainCtx.WithRepl();
+  unsigned int ruCount = (withRepl || trainCtx.RowWeight().empty()) ? nSamp : nRow;
+  double *ru = new double[ruCount];
+  trainCtx.Rand().RUnif(tIdx, 0, PRNG::rowSample, ruCount, ru);
+  if (withRepl) {
+    SampleWithRepl(ru, sCountRow);
+  }
+  else {
+    SampleWORepl(ru, sCountRow);
+  }
+
+  delete [] ru;
+}
+
+
+/**
+   @brief Samples with replacement, by inverting the cumulative weights
+   if nonuniform.
+
+   @param ru[] contains 'nSamp'-many uniform variates.
+
+   @param sCountRow outputs the sample counts, by row.
+
+   @return void, with output vector parameter.
+ */
+void Sample::SampleWithRepl(const double ru[], std::vector<unsigned int> &sCountRow) const {
+  const std::vector<double> &rowCum = trainCtx.RowCum();
   for (unsigned int i = 0; i < nSamp; i++) {
-    int row = rvRow[i];
-    sCountRow[row]++;
+    unsigned int row;
+    if (rowCum.empty()) {
+      row = ru[i] * nRow;
+    }
+    else {
+      row = std::upper_bound(rowCum.begin(), rowCum.end(), ru[i]) - rowCum.begin();
+    }
+    sCountRow[std::min(row, nRow - 1)]++; // Guards rounding at the top.
   }
+}
+
+
+/**
+   @brief Samples without replacement.  Uniform weighting employs a
+   partial Fisher-Yates shuffle; nonuniform weighting retains the rows
+   with the highest exponential keys, after Efraimidis and Spirakis.
 
-  delete [] rvRow;
+   @param ru[] contains the uniform variates:  one per sample, if uniform,
+   otherwise one per row.
+
+   @param sCountRow outputs the sample counts, by row.
+
+   @return void, with output vector parameter.
+ */
+void Sample::SampleWORepl(const double ru[], std::vector<unsigned int> &sCountRow) const {
+  const std::vector<double> &rowWeight = trainCtx.RowWeight();
+  unsigned int sampCount = std::min(nSamp, nRow);
+  if (rowWeight.empty()) {
+    std::vector<unsigned int> rowPerm(nRow);
+    std::iota(rowPerm.begin(), rowPerm.end(), 0);
+    for (unsigned int i = 0; i < sampCount; i++) {
+      unsigned int j = std::min(i + (unsigned int) (ru[i] * (nRow - i)), nRow - 1);
+      std::swap(rowPerm[i], rowPerm[j]);
+      sCountRow[rowPerm[i]] = 1;
+    }
+  }
+  else {
+    std::vector<std::pair<double, unsigned int> > rowKey(nRow);
+    for (unsigned int row = 0; row < nRow; row++) {
+      double weight = rowWeight[row];
+      rowKey[row] = std::make_pair(weight > 0.0 ? std::log(ru[row]) / weight : -HUGE_VAL, row);
+    }
+    std::nth_element(rowKey.begin(), rowKey.begin() + sampCount, rowKey.end(), std::greater<std::pair<double, unsigned int> >());
+    for (unsigned int i = 0; i < sampCount; i++) {
+      sCountRow[rowKey[i].second] = 1;
+    }
+  }
 }
 
 
 /**
    @brief Static entry for classification.
  */
-SampleCtg *Sample::FactoryCtg(const PMTrain *pmTrain, const std::vector<double> &y, const RowRank *rowRank,  const std::vector<unsigned int> &yCtg) {
-  SampleCtg *sampleCtg = new SampleCtg();
+SampleCtg *Sample::FactoryCtg(const TrainContext &_trainCtx, const PMTrain *pmTrain, const std::vector<double> &y, const RowRank *rowRank,  const std::vector<unsigned int> &yCtg, unsigned int _tIdx) {
+  SampleCtg *sampleCtg = new SampleCtg(_trainCtx, _tIdx);
   sampleCtg->Stage(pmTrain, yCtg, y, rowRank);
 
   return sampleCtg;
@@ -123,8 +154,8 @@ SampleCtg *Sample::FactoryCtg(const PMTrain *pmTrain, const std::vector<double>
    @brief Static entry for regression response.
 
  */
-SampleReg *Sample::FactoryReg(const PMTrain *pmTrain, const std::vector<double> &y, const RowRank *rowRank, const std::vector<unsigned int> &row2Rank) {
-  SampleReg *sampleReg = new SampleReg();
+SampleReg *Sample::FactoryReg(const TrainContext &_trainCtx, const PMTrain *pmTrain, const std::vector<double> &y, const RowRank *rowRank, const std::vector<unsigned int> &row2Rank, unsigned int _tIdx) {
+  SampleReg *sampleReg = new SampleReg(_trainCtx, _tIdx);
   sampleReg->Stage(pmTrain, y, row2Rank, rowRank);
 
   return sampleReg;
@@ -134,7 +165,7 @@ SampleReg *Sample::FactoryReg(const PMTrain *pmTrain, const std::vector<double>
 /**
    @brief Constructor.
  */
-SampleReg::SampleReg() : Sample() {
+SampleReg::SampleReg(const TrainContext &_trainCtx, unsigned int _tIdx) : Sample(_trainCtx, _tIdx) {
 }
 
 
@@ -156,7 +187,7 @@ void SampleReg::Stage(const PMTrain *pmTrain, const std::vector<double> &y, cons
   std::vector<unsigned int> ctgProxy(nRow);
   std::fill(ctgProxy.begin(), ctgProxy.end(), 0);
   bagCount = Sample::PreStage(y, ctgProxy, rowRank, samplePred);
-  bottom = Bottom::FactoryReg(pmTrain, rowRank, samplePred, bagCount);
+  bottom = Bottom::FactoryReg(trainCtx, pmTrain, rowRank, samplePred, bagCount, tIdx);
   Sample::Stage(rowRank);
   SetRank(row2Rank);
 }
@@ -184,7 +215,7 @@ void SampleReg::SetRank(const std::vector<unsigned int> &row2Rank) {
 /**
    @brief Constructor.
  */
-SampleCtg::SampleCtg() : Sample() {
+SampleCtg::SampleCtg(const TrainContext &_trainCtx, unsigned int _tIdx) : Sample(_trainCtx, _tIdx) {
 }
 
 
@@ -202,7 +233,7 @@ SampleCtg::SampleCtg() : Sample() {
 //
 void SampleCtg::Stage(const PMTrain *pmTrain, const std::vector<unsigned int> &yCtg, const std::vector<double> &y, const RowRank *rowRank) {
   bagCount = Sample::PreStage(y, yCtg, rowRank, samplePred);
-  bottom = Bottom::FactoryCtg(pmTrain, rowRank, samplePred, sampleNode, bagCount);
+  bottom = Bottom::FactoryCtg(trainCtx, pmTrain, rowRank, samplePred, sampleNode, bagCount, tIdx);
   Sample::Stage(rowRank);
 }
 
@@ -244,7 +275,7 @@ unsigned int Sample::PreStage(const std::vector<double> &y, const std::vector<un
   }
 
   unsigned int sIdx = sampleNode.size();
-  _samplePred = SamplePred::Factory(rowRank->NPred(), sIdx, rowRank->SafeSize(sIdx));
+  _samplePred = SamplePred::Factory(rowRank, sIdx, rowRank->SafeSize(sIdx), trainCtx.CtgShift(), trainCtx.SpillDir());
   return sIdx;
 }
 
@@ -88,9 +88,11 @@ class Sample {
   class BV *treeBag;
   std::vector<unsigned int> row2Sample;
  protected:
+  const class TrainContext &trainCtx;
+  const unsigned int nRow;
+  const unsigned int nSamp;
   const unsigned int noSample; // Inattainable sample index.
-  static unsigned int nRow;
-  static unsigned int nSamp;
+  const unsigned int tIdx; // Absolute tree index:  keys the row stream.
   std::vector<SampleNode> sampleNode;
   unsigned int bagCount;
   double bagSum;
@@ -101,22 +103,21 @@ class Sample {
   void Stage(const class RowRank *rowRank, unsigned int predIdx);
   void PackIndex(unsigned int row, unsigned int predRank, std::vector<class StagePack> &stagePack);
 
-  static void RowSample(std::vector<unsigned int> &sCountRow);
+  void RowSample(std::vector<unsigned int> &sCountRow) const;
+  void SampleWithRepl(const double ru[], std::vector<unsigned int> &sCountRow) const;
+  void SampleWORepl(const double ru[], std::vector<unsigned int> &sCountRow) const;
 
  public:
-  static class SampleCtg *FactoryCtg(const class PMTrain *pmTrain, const std::vector<double> &y, const class RowRank *rowRank, const std::vector<unsigned int> &yCtg);
-  static class SampleReg *FactoryReg(const class PMTrain *pmTrain, const std::vector<double> &y, const class RowRank *rowRank, const std::vector<unsigned int> &row2Rank);
+  static class SampleCtg *FactoryCtg(const class TrainContext &_trainCtx, const class PMTrain *pmTrain, const std::vector<double> &y, const class RowRank *rowRank, const std::vector<unsigned int> &yCtg, unsigned int _tIdx);
+  static class SampleReg *FactoryReg(const class TrainContext &_trainCtx, const class PMTrain *pmTrain, const std::vector<double> &y, const class RowRank *rowRank, const std::vector<unsigned int> &row2Rank, unsigned int _tIdx);
 
-  static void Immutables(unsigned int _nSamp, const std::vector<double> &_feSampleWeight, bool _withRepl, unsigned int _ctgWidth, unsigned int _nTree);
-  static void DeImmutables();
-
-  Sample();
+  Sample(const class TrainContext &_trainCtx, unsigned int _tIdx);
   void RowInvert(std::vector<unsigned int> &sample2Row) const;
   
   /**
      @brief Accessor for sample count.
    */
-  static inline unsigned int NSamp() {
+  inline unsigned int NSamp() const {
     return nSamp;
   }
 
@@ -191,7 +192,7 @@ class SampleReg : public Sample {
   unsigned int *sample2Rank; // Only client currently leaf-based methods.
   void SetRank(const std::vector<unsigned int> &row2Rank);
  public:
-  SampleReg();
+  SampleReg(const class TrainContext &_trainCtx, unsigned int _tIdx);
   ~SampleReg();
 
   inline unsigned int Rank(unsigned int sIdx) const {
@@ -207,12 +208,9 @@ class SampleReg : public Sample {
  @brief Classification-specific sampling.
 */
 class SampleCtg : public Sample {
-  static unsigned int ctgWidth;
  public:
-  SampleCtg();
+  SampleCtg(const class TrainContext &_trainCtx, unsigned int _tIdx);
   ~SampleCtg();
-  static void Immutables(unsigned int _ctgWidth, unsigned int _nTree);
-  static void DeImmutables();
 
   
   void Stage(const class PMTrain *pmTrain, const std::vector<unsigned int> &yCtg, const std::vector<double> &y, const class RowRank *rowRank);
@@ -14,49 +14,56 @@
  */
 
 #include "samplepred.h"
+#include "rowrank.h"
 #include "path.h"
 #include "bv.h"
+#include "mapblock.h"
 
 #include <numeric>
 
 //#include <iostream>
 //using namespace std;
 
-unsigned int SPNode::ctgShift = 0;
-
 /**
    @brief Computes a packing width sufficient to hold all (zero-based) response
    category values.
 
    @param ctgWidth is the response cardinality.
 
-   @return void.
+   @return packing width, in bits.
  */
-void SPNode::Immutables(unsigned int ctgWidth) {
+unsigned int SPCol::CtgShift(unsigned int ctgWidth) {
   unsigned int bits = 1;
-  ctgShift = 0;
+  unsigned int ctgShift = 0;
   // Ctg values are zero-based, so the first power of 2 greater than or
   // equal to 'ctgWidth' has sufficient bits to hold all response values.
   while (bits < ctgWidth) {
     bits <<= 1;
     ctgShift++;
   }
-}
 
-
-/*
-**/
-void SPNode::DeImmutables() {
-  ctgShift = 0;
+  return ctgShift;
 }
 
 
 /**
-   @brief Base class constructor.
+   @brief Base class constructor.  The four columns are carved from a
+   single block, widest element type first, so that each remains aligned.
+
+   @param spillDir is a directory to back the columns by file, empty iff
+   they are to reside on the heap.
  */
-SamplePred::SamplePred(unsigned int _nPred, unsigned int _bagCount, unsigned int _bufferSize) : bagCount(_bagCount), nPred(_nPred), bufferSize(_bufferSize), pitchSP(_bagCount * sizeof(SamplePred)), pitchSIdx(_bagCount * sizeof(unsigned int)), pathIdx(_bufferSize) {
-  indexBase = new unsigned int[2* bufferSize];
-  nodeVec = new SPNode[2 * bufferSize];
+SamplePred::SamplePred(const RowRank *rowRank, unsigned int _bagCount, unsigned int _bufferSize, unsigned int _ctgShift, const std::string &spillDir) : bagCount(_bagCount), nPred(rowRank->NPred()), ctgShift(_ctgShift), rankWidth(std::vector<unsigned int>(nPred)), bufferSize(_bufferSize), pathIdx(_bufferSize) {
+  for (unsigned int predIdx = 0; predIdx < nPred; predIdx++) {
+    rankWidth[predIdx] = rowRank->RankWidth(predIdx);
+  }
+  size_t slots = 2 * (size_t) bufferSize;
+  block = new MapBlock(slots * (sizeof(FltVal) + 3 * sizeof(unsigned int)), spillDir);
+  unsigned char *base = block->Base();
+  sCountBase = reinterpret_cast<unsigned int *>(base);
+  indexBase = sCountBase + slots;
+  ySumBase = reinterpret_cast<FltVal *>(indexBase + slots);
+  rankBase = reinterpret_cast<unsigned char *>(ySumBase + slots);
   
   stageOffset.reserve(nPred);
   stageExtent.reserve(nPred);
@@ -67,18 +74,19 @@ SamplePred::SamplePred(unsigned int _nPred, unsigned int _bagCount, unsigned int
   @brief Base class destructor.
  */
 SamplePred::~SamplePred() {
-  delete [] nodeVec;
-  delete [] indexBase;
+  delete block;
 }
 
 
 /**
    @brief Static entry for sample staging.
 
+   @param _ctgShift is the category packing width, zero for regression.
+
    @return SamplePred object for tree.
  */
-SamplePred *SamplePred::Factory(unsigned int _nPred, unsigned int _bagCount, unsigned int _bufferSize) {
-  SamplePred *samplePred = new SamplePred(_nPred, _bagCount, _bufferSize);
+SamplePred *SamplePred::Factory(const RowRank *rowRank, unsigned int _bagCount, unsigned int _bufferSize, unsigned int _ctgShift, const std::string &spillDir) {
+  SamplePred *samplePred = new SamplePred(rowRank, _bagCount, _bufferSize, _ctgShift, spillDir);
 
   return samplePred;
 }
@@ -100,10 +108,9 @@ bool SamplePred::Stage(const std::vector<StagePack> &stagePack, unsigned int pre
 
   const unsigned int bufIdx = 0;
   unsigned int *smpIdx;
-  SPNode *spn = Buffers(predIdx, bufIdx, smpIdx);
+  SPCol spn = Buffers(predIdx, bufIdx, smpIdx);
   for (unsigned int idx = 0; idx < stagePack.size(); idx++) {
-    unsigned int sIdx = spn++->Init(stagePack[idx]);
-    *smpIdx++ = sIdx;
+    smpIdx[idx] = spn.Init(idx, stagePack[idx], ctgShift);
   }
 
   // Singleton iff either:
@@ -116,14 +123,19 @@ bool SamplePred::Stage(const std::vector<StagePack> &stagePack, unsigned int pre
 /**
    @brief Initializes immutable field values with category packing.
 
+   @param idx is the position to initialize.
+
    @param stagePack holds packed staging values.
 
+   @param ctgShift is the category packing width.
+
    @return upacked sample index.
  */
-unsigned int SPNode::Init(const StagePack &stagePack) {
-  unsigned int sIdx, ctg;
-  stagePack.Ref(sIdx, rank, sCount, ctg, ySum);
-  sCount = (sCount << ctgShift) | ctg; // Packed representation.
+unsigned int SPCol::Init(unsigned int idx, const StagePack &stagePack, unsigned int ctgShift) {
+  unsigned int sIdx, ctg, _rank;
+  stagePack.Ref(sIdx, _rank, sCount[idx], ctg, ySum[idx]);
+  SetRank(idx, _rank);
+  sCount[idx] = (sCount[idx] << ctgShift) | ctg; // Packed representation.
   
   return sIdx;
 }
@@ -149,11 +161,11 @@ unsigned int SPNode::Init(const StagePack &stagePack) {
  */
 double SamplePred::BlockReplay(unsigned int predIdx, unsigned int sourceBit, unsigned int start, unsigned int extent, BV *replayExpl) {
   unsigned int *idx;
-  SPNode *spn = Buffers(predIdx, sourceBit, idx);
+  SPCol spn = Buffers(predIdx, sourceBit, idx);
 
   double sum = 0.0;
   for (unsigned int spIdx = start; spIdx < start + extent; spIdx++) {
-    sum += spn[spIdx].YSum();
+    sum += spn.YSum(spIdx);
     replayExpl->SetBit(idx[spIdx]);
   }
 
@@ -173,27 +185,48 @@ void SamplePred::Prepath(const IdxPath *idxPath, const unsigned int reachBase[],
 
 
 /**
-   @brief Restages and tabultates rank counts.
+   @brief Restages columns of a given rank encoding, tabulating rank counts.
 
    @return void.
  */
-void SamplePred::RestageRank(unsigned int predIdx, unsigned int bufIdx, unsigned int startIdx, unsigned int extent, unsigned int reachOffset[], unsigned int rankPrev[], unsigned int rankCount[]) {
-  SPNode *source, *targ;
-  unsigned int *idxSource, *idxTarg;
-  Buffers(predIdx, bufIdx, source, idxSource, targ, idxTarg);
-
-  PathT *pathBlock = &pathIdx[StageOffset(predIdx)];
+template<typename RankT> static void RestageCols(const PathT pathBlock[], unsigned int startIdx, unsigned int extent, const FltVal ySumSource[], const RankT rankSource[], const unsigned int sCountSource[], const unsigned int idxSource[], FltVal ySumTarg[], RankT rankTarg[], unsigned int sCountTarg[], unsigned int idxTarg[], unsigned int reachOffset[], unsigned int rankPrev[], unsigned int rankCount[]) {
   for (unsigned int idx = startIdx; idx < startIdx + extent; idx++) {
     unsigned int path = pathBlock[idx];
     if (path != NodePath::noPath) {
-      SPNode spNode = source[idx];
-      unsigned int rank = spNode.Rank();
+      unsigned int rank = rankSource[idx];
       rankCount[path] += (rank == rankPrev[path] ? 0 : 1);
       rankPrev[path] = rank;
       unsigned int destIdx = reachOffset[path]++;
-      targ[destIdx] = spNode;
+      ySumTarg[destIdx] = ySumSource[idx];
+      rankTarg[destIdx] = rank;
+      sCountTarg[destIdx] = sCountSource[idx];
       idxTarg[destIdx] = idxSource[idx];
     }
   }
 }
 
+
+/**
+   @brief Restages and tabultates rank counts.  Dispatches on rank
+   encoding once per cell, rather than per sample.
+
+   @return void.
+ */
+void SamplePred::RestageRank(unsigned int predIdx, unsigned int bufIdx, unsigned int startIdx, unsigned int extent, unsigned int reachOffset[], unsigned int rankPrev[], unsigned int rankCount[]) {
+  unsigned int offSource = BufferOff(predIdx, bufIdx);
+  unsigned int offTarg = BufferOff(predIdx, 1 - bufIdx);
+  const unsigned char *rankSource = rankBase + offSource * sizeof(unsigned int);
+  unsigned char *rankTarg = rankBase + offTarg * sizeof(unsigned int);
+  const PathT *pathBlock = &pathIdx[StageOffset(predIdx)];
+  switch (rankWidth[predIdx]) {
+  case 1:
+    RestageCols(pathBlock, startIdx, extent, ySumBase + offSource, rankSource, sCountBase + offSource, indexBase + offSource, ySumBase + offTarg, rankTarg, sCountBase + offTarg, indexBase + offTarg, reachOffset, rankPrev, rankCount);
+    break;
+  case 2:
+    RestageCols(pathBlock, startIdx, extent, ySumBase + offSource, (const unsigned short *) rankSource, sCountBase + offSource, indexBase + offSource, ySumBase + offTarg, (unsigned short *) rankTarg, sCountBase + offTarg, indexBase + offTarg, reachOffset, rankPrev, rankCount);
+    break;
+  default:
+    RestageCols(pathBlock, startIdx, extent, ySumBase + offSource, (const unsigned int *) rankSource, sCountBase + offSource, indexBase + offSource, ySumBase + offTarg, (unsigned int *) rankTarg, sCountBase + offTarg, indexBase + offTarg, reachOffset, rankPrev, rankCount);
+    break;
+  }
+}
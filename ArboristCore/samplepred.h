@@ -21,6 +21,7 @@
 #include "param.h"
 
 #include <vector>
+#include <string>
 
 /**
    @brief Container for staging initialization, viz. minimizing communication
@@ -52,26 +53,45 @@ class StagePack {
 
 
 /**
+   @brief Columnar view of the staged samples of a predictor, offset to
+   the predictor's position within a buffer.  Response, rank and sample
+   count occupy separate vectors, so that walks touching a single field,
+   such as rank tabulation, move only that field, and so that splitting
+   kernels may load contiguous lanes.  Ranks are encoded in the fewest
+   bytes accommodating the predictor's cardinality.
  */
-class SPNode {
-  static unsigned int ctgShift; // Pack:  nonzero iff categorical response.
+class SPCol {
+  FltVal *ySum; // sum of response values associated with sample.
+  unsigned char *rank; // Rank, up to tie, or factor group.
+  unsigned int rankWidth; // Bytes per rank:  1, 2 or 4.
+  unsigned int *sCount; // # occurrences of row sampled:  << # rows.
 
+ public:
+  static unsigned int CtgShift(unsigned int ctgWidth);
 
- protected:
-  FltVal ySum; // sum of response values associated with sample.
-  unsigned int rank; // Rank, up to tie, or factor group.
-  unsigned int sCount; // # occurrences of row sampled:  << # rows.
+  inline SPCol(FltVal *_ySum, unsigned char *_rank, unsigned int _rankWidth, unsigned int *_sCount) : ySum(_ySum), rank(_rank), rankWidth(_rankWidth), sCount(_sCount) {
+  }
 
+  unsigned int Init(unsigned int idx, const StagePack &stagePack, unsigned int ctgShift);
 
- public:
-  static void Immutables(unsigned int ctgWidth);
-  static void DeImmutables();
-  unsigned int Init(const StagePack &stagePack);
-  
-  inline void Init(FltVal _ySum, unsigned int _sCount, unsigned int _rank) {
-    ySum = _ySum;
-    sCount = _sCount;
-    rank = _rank;
+
+  /**
+     @brief Encodes a rank at the predictor's width.
+
+     @return void.
+   */
+  inline void SetRank(unsigned int idx, unsigned int _rank) {
+    switch (rankWidth) {
+    case 1:
+      rank[idx] = _rank;
+      break;
+    case 2:
+      ((unsigned short *) rank)[idx] = _rank;
+      break;
+    default:
+      ((unsigned int *) rank)[idx] = _rank;
+      break;
+    }
   }
 
 
@@ -85,6 +105,8 @@ class SPNode {
      be used with categorical response, as 'sCount' value reported here
      is unshifted.
 
+     @param idx is the buffer-relative sample position.
+
      @param _ySum outputs the response value.
 
      @param _rank outputs the predictor rank.
@@ -93,10 +115,10 @@ class SPNode {
 
      @return void.
    */
-  inline void RegFields(FltVal &_ySum, unsigned int &_rank, unsigned int &_sCount) const {
-    _ySum = ySum;
-    _rank = rank;
-    _sCount = sCount;
+  inline void RegFields(unsigned int idx, FltVal &_ySum, unsigned int &_rank, unsigned int &_sCount) const {
+    _ySum = ySum[idx];
+    _rank = Rank(idx);
+    _sCount = sCount[idx];
   }
 
   // These methods should only be called when the response is known
@@ -108,6 +130,8 @@ class SPNode {
      @brief Reports SamplePred contents for categorical response.  Can
      be called with regression response if '_yCtg' value ignored.
 
+     @param ctgShift is the job's category packing width.
+
      @param _ySum outputs the proxy response value.
 
      @param _rank outputs the predictor rank.
@@ -116,22 +140,30 @@ class SPNode {
 
      @return sample count, with output reference parameters.
    */
-  inline unsigned int CtgFields(FltVal &_ySum, unsigned int &_rank, unsigned int &_yCtg) const {
-    _ySum = ySum;
-    _rank = rank;
-    _yCtg = sCount & ((1 << ctgShift) - 1);
+  inline unsigned int CtgFields(unsigned int idx, unsigned int ctgShift, FltVal &_ySum, unsigned int &_rank, unsigned int &_yCtg) const {
+    _ySum = ySum[idx];
+    _rank = Rank(idx);
+    _yCtg = sCount[idx] & ((1 << ctgShift) - 1);
 
-    return sCount >> ctgShift;
+    return sCount[idx] >> ctgShift;
   }
 
 
   /**
-     @brief Accessor for 'rank' field
+     @brief Accessor for 'rank' field.  Width is invariant over a walk,
+     so the branch predicts well.
 
      @return rank value.
    */
-  inline unsigned int Rank() const {
-    return rank;
+  inline unsigned int Rank(unsigned int idx) const {
+    switch (rankWidth) {
+    case 1:
+      return rank[idx];
+    case 2:
+      return ((const unsigned short *) rank)[idx];
+    default:
+      return ((const unsigned int *) rank)[idx];
+    }
   }
 
 
@@ -140,10 +172,29 @@ class SPNode {
 
      @return sum of y-values for sample.
    */
-  inline FltVal YSum() {
+  inline FltVal YSum(unsigned int idx) const {
+    return ySum[idx];
+  }
+
+
+  /**
+     @brief Column bases, for vector kernels.
+   */
+  inline const FltVal *YSumBase() const {
     return ySum;
   }
 
+  inline const unsigned char *RankBase() const {
+    return rank;
+  }
+
+  inline unsigned int RankWidth() const {
+    return rankWidth;
+  }
+
+  inline const unsigned int *SCountBase() const {
+    return sCount;
+  }
 };
 
 
@@ -157,29 +208,31 @@ class SamplePred {
 
   const unsigned int bagCount;
   const unsigned int nPred;
+  const unsigned int ctgShift; // Pack:  nonzero iff categorical response.
+  std::vector<unsigned int> rankWidth; // Per-predictor rank encoding, in bytes.
 
   // Predictor-based sample orderings, double-buffered by level value.
   //
   const unsigned int bufferSize; // <= nRow * nPred.
-  const unsigned int pitchSP; // Pitch of SPNode vector, in bytes.
-  const unsigned int pitchSIdx; // Pitch of SIdx vector, in bytes.
 
   std::vector<PathT> pathIdx;
   std::vector<unsigned int> stageOffset;
   std::vector<unsigned int> stageExtent; // Client:  debugging only.
-  SPNode* nodeVec;
 
-  // 'indexBase' could be boxed with SPNode.  While it is used in both
-  // replaying and restaging, though, it plays no role in splitting.  Maintaining
-  // a separate vector permits a 16-byte stride to be used for splitting.  More
-  // significantly, it reduces memory traffic incurred by transposition on the
-  // coprocessor.
+  // Sample fields are held column-wise, sharing offsets.  Rank slots are
+  // allotted four bytes apiece, of which narrow encodings use a prefix,
+  // so that offsets remain shared.  'indexBase' plays no role in
+  // splitting, but is used in both replaying and restaging.
   //
+  class MapBlock *block; // Backs all four columns.
+  FltVal *ySumBase;
+  unsigned char *rankBase;
+  unsigned int *sCountBase;
   unsigned int *indexBase; // RV index for this row.  Used by CTG as well as on replay.
  public:
-  SamplePred(unsigned int _nPred, unsigned int _bagCount, unsigned int _bufferSize);
+  SamplePred(const class RowRank *rowRank, unsigned int _bagCount, unsigned int _bufferSize, unsigned int _ctgShift, const std::string &spillDir);
   ~SamplePred();
-  static SamplePred *Factory(unsigned int _nPred, unsigned int _bagCount, unsigned int _bufferSize);
+  static SamplePred *Factory(const class RowRank *rowRank, unsigned int _bagCount, unsigned int _bufferSize, unsigned int _ctgShift, const std::string &spillDir = std::string());
 
   bool Stage(const std::vector<StagePack> &stagePack, unsigned int predIdx, unsigned int safeOffset, unsigned int extent);
   double BlockReplay(unsigned int predIdx, unsigned int sourceBit, unsigned int start, unsigned int end, class BV *replayExpl);
@@ -188,15 +241,6 @@ class SamplePred {
   void Prepath(const class IdxPath *idxPath, const unsigned int reachBase[], unsigned int predIdx, unsigned int bufIdx, unsigned int startIdx, unsigned int extent, unsigned int pathMask, bool idxUpdate, unsigned int pathCount[]);
   void RestageRank(unsigned int predIdx, unsigned int bufIdx, unsigned int start, unsigned int extent, unsigned int reachOffset[], unsigned int rankPrev[], unsigned int rankCount[]);
 
-  
-  inline unsigned int PitchSP() {
-    return pitchSP;
-  }
-
-  inline unsigned int PitchSIdx() {
-    return pitchSIdx;
-  }
-
 
   /**
      @brief Returns the staging position for a dense predictor.
@@ -245,41 +289,33 @@ class SamplePred {
 
 
   /**
-     @return base of node buffer.
+     @return column view of a predictor's buffer section.
    */
-  inline SPNode *BufferNode(unsigned int predIdx, unsigned int bufBit) {
-    return nodeVec + BufferOff(predIdx, bufBit);
+  inline SPCol Column(unsigned int predIdx, unsigned int offset) const {
+    return SPCol(ySumBase + offset, rankBase + offset * sizeof(unsigned int), rankWidth[predIdx], sCountBase + offset);
   }
-  
-  
+
+
   /**
    */
-  inline SPNode* Buffers(unsigned int predIdx, unsigned int bufBit, unsigned int*& sIdx) {
+  inline SPCol Buffers(unsigned int predIdx, unsigned int bufBit, unsigned int*& sIdx) {
     unsigned int offset = BufferOff(predIdx, bufBit);
     sIdx = indexBase + offset;
-    return nodeVec + offset;
+    return Column(predIdx, offset);
   }
 
 
   /**
-     @brief Allows lightweight lookup of predictor's SPNode vector.
+     @brief Allows lightweight lookup of predictor's sample columns.
 
      @param bufBit is the containing buffer, currently 0/1.
  
      @param predIdx is the predictor index.
 
-     @return node vector section for this predictor.
-   */
-  SPNode* PredBase(unsigned int predIdx, unsigned int bufBit) const {
-    return nodeVec + BufferOff(predIdx, bufBit);
-  }
-  
-
-  /**
-     @brief Returns buffer containing splitting information.
+     @return column view of the section for this predictor.
    */
-  inline SPNode* SplitBuffer(unsigned int predIdx, unsigned int bufBit) {
-    return nodeVec + BufferOff(predIdx, bufBit);
+  inline SPCol PredBase(unsigned int predIdx, unsigned int bufBit) const {
+    return Column(predIdx, BufferOff(predIdx, bufBit));
   }
 
 
@@ -292,7 +328,7 @@ class SamplePred {
 
    @return void, with output parameter vectors.
  */
-  inline void Buffers(int predIdx, unsigned int bufBit, SPNode *&source, unsigned int *&sIdxSource, SPNode *&targ, unsigned int *&sIdxTarg) {
+  inline void Buffers(int predIdx, unsigned int bufBit, SPCol &source, unsigned int *&sIdxSource, SPCol &targ, unsigned int *&sIdxTarg) {
     source = Buffers(predIdx, bufBit, sIdxSource);
     targ = Buffers(predIdx, 1 - bufBit, sIdxTarg);
   }
@@ -328,8 +364,8 @@ class SamplePred {
      @return true iff cell consists of a single rank.
    */
   inline bool SingleRank(unsigned int predIdx, unsigned int bufIdx, unsigned int idxStart, unsigned int extent) {
-    SPNode *spNode = BufferNode(predIdx, bufIdx);
-    return extent > 0 ? (spNode[idxStart].Rank() == spNode[extent - 1].Rank()) : false;
+    SPCol spn = PredBase(predIdx, bufIdx);
+    return extent > 0 ? (spn.Rank(idxStart) == spn.Rank(extent - 1)) : false;
   }
 };
 
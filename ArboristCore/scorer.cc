@@ -0,0 +1,197 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file scorer.cc
+
+   @brief Methods for single-row prediction.
+
+   @author Mark Seligman
+ */
+
+#include "scorer.h"
+#include "forest.h"
+#include "leaf.h"
+#include "bv.h"
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Constructor.  Leaf scores are copied into a dense vector, so
+   that scoring touches only nodes and scores.
+
+   @param _nPredNum is the number of numeric predictors, which precede
+   the factors in predictor numbering.
+
+   @param _ctgWidth is the response cardinality, zero iff regression.
+
+   @param _weight are the per-leaf category weights, required only for
+   class probabilities.
+ */
+Scorer::Scorer(const ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOrigin[], unsigned int _nFac, const std::vector<unsigned int> &_leafOrigin, const LeafNode _leafNode[], unsigned int _leafCount, unsigned int _nPredNum, unsigned int _ctgWidth, const double _weight[]) : forestNode(_forestNode), treeOrigin(_origin), nTree(_nTree), facSplit(new BVJagged(_facSplit, _facLen, _facOrigin, _nFac)), nPredNum(_nPredNum), ctgWidth(_ctgWidth), leafOrigin(_leafOrigin), leafScore(std::vector<double>(_leafCount)), weight(_weight) {
+  for (unsigned int leafIdx = 0; leafIdx < _leafCount; leafIdx++) {
+    leafScore[leafIdx] = _leafNode[leafIdx].GetScore();
+  }
+}
+
+
+Scorer::~Scorer() {
+  delete facSplit;
+}
+
+
+/**
+   @brief Walks a tree from its root to the leaf receiving a row.
+
+   @return tree-relative leaf index.
+ */
+unsigned int Scorer::Leaf(unsigned int tIdx, const double rowNum[], const unsigned int rowFac[]) const {
+  unsigned int idx = treeOrigin[tIdx];
+  unsigned int bump;
+  unsigned int pred;
+  double num;
+  forestNode[idx].Ref(pred, bump, num);
+  while (bump != 0) {
+    if (pred < nPredNum)
+      idx += rowNum[pred] <= num ? bump : bump + 1;
+    else
+      idx += facSplit->TestBit(tIdx, (unsigned int) num + rowFac[pred - nPredNum]) ? bump : bump + 1;
+    forestNode[idx].Ref(pred, bump, num);
+  }
+
+  return pred;
+}
+
+
+/**
+   @brief Walks a group of consecutive trees in lockstep, overlapping
+   their node fetches.
+
+   @param leaf outputs the tree-relative leaf indices.
+
+   @return void, with output parameter vector.
+ */
+void Scorer::Leaves(unsigned int tStart, const double rowNum[], const unsigned int rowFac[], unsigned int leaf[]) const {
+  unsigned int idx[treeGroup];
+  for (unsigned int i = 0; i < treeGroup; i++) {
+    idx[i] = treeOrigin[tStart + i];
+  }
+
+  bool live;
+  do {
+    live = false;
+    for (unsigned int i = 0; i < treeGroup; i++) {
+      unsigned int bump, pred;
+      double num;
+      forestNode[idx[i]].Ref(pred, bump, num);
+      if (bump == 0) {
+        leaf[i] = pred;
+        continue;
+      }
+      live = true;
+      if (pred < nPredNum)
+        idx[i] += rowNum[pred] <= num ? bump : bump + 1;
+      else
+        idx[i] += facSplit->TestBit(tStart + i, (unsigned int) num + rowFac[pred - nPredNum]) ? bump : bump + 1;
+    }
+  } while (live);
+}
+
+
+/**
+   @brief Predicts a single row of a regression forest.
+
+   @return mean of the trees' leaf scores.
+ */
+double Scorer::Regression(const double rowNum[], const unsigned int rowFac[]) const {
+  double score = 0.0;
+  unsigned int tIdx = 0;
+  unsigned int leaf[treeGroup];
+  for (; tIdx + treeGroup <= nTree; tIdx += treeGroup) {
+    Leaves(tIdx, rowNum, rowFac, leaf);
+    for (unsigned int i = 0; i < treeGroup; i++)
+      score += leafScore[leafOrigin[tIdx + i] + leaf[i]];
+  }
+  for (; tIdx < nTree; tIdx++) {
+    score += leafScore[leafOrigin[tIdx] + Leaf(tIdx, rowNum, rowFac)];
+  }
+
+  return score / nTree;
+}
+
+
+/**
+   @brief Accumulates a leaf's vote and, if requested, its category
+   weights.
+
+   @param nodeIdx is the forest-wide leaf index.
+
+   @return void, with output parameters.
+ */
+void Scorer::Tally(unsigned int nodeIdx, double votes[], double prob[]) const {
+  double val = leafScore[nodeIdx];
+  unsigned int ctg = val; // Truncates jittered score for indexing.
+  votes[ctg] += 1 + val - ctg;
+  if (prob != 0) {
+    const double *leafWeight = weight + ctgWidth * nodeIdx;
+    for (ctg = 0; ctg < ctgWidth; ctg++)
+      prob[ctg] += leafWeight[ctg];
+  }
+}
+
+
+/**
+   @brief Predicts a single row of a classification forest.
+
+   @param votes outputs the jittered vote counts, by category.
+
+   @param prob outputs the class probabilities, by category, if nonnull.
+
+   @return predicted category.
+ */
+unsigned int Scorer::Classification(const double rowNum[], const unsigned int rowFac[], double votes[], double prob[]) const {
+  for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
+    votes[ctg] = 0.0;
+  }
+  if (prob != 0) {
+    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+      prob[ctg] = 0.0;
+  }
+
+  unsigned int tIdx = 0;
+  unsigned int leaf[treeGroup];
+  for (; tIdx + treeGroup <= nTree; tIdx += treeGroup) {
+    Leaves(tIdx, rowNum, rowFac, leaf);
+    for (unsigned int i = 0; i < treeGroup; i++)
+      Tally(leafOrigin[tIdx + i] + leaf[i], votes, prob);
+  }
+  for (; tIdx < nTree; tIdx++) {
+    Tally(leafOrigin[tIdx] + Leaf(tIdx, rowNum, rowFac), votes, prob);
+  }
+
+  if (prob != 0) {
+    double rowSum = 0.0;
+    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+      rowSum += prob[ctg];
+    double recipSum = 1.0 / rowSum;
+    for (unsigned int ctg = 0; ctg < ctgWidth; ctg++)
+      prob[ctg] *= recipSum;
+  }
+
+  int argMax = -1;
+  double scoreMax = 0.0;
+  for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
+    if (votes[ctg] > scoreMax) {
+      scoreMax = votes[ctg];
+      argMax = ctg;
+    }
+  }
+
+  return argMax;
+}
@@ -0,0 +1,66 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file scorer.h
+
+   @brief Persistent single-row prediction, for low-latency serving.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_SCORER_H
+#define ARBORIST_SCORER_H
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+   @brief Forest prepared once for repeated prediction of single rows.
+   Unlike the Predict entries, scoring builds no blocks and allocates
+   nothing:  rows are read in place and results are written to caller
+   storage.  Scoring methods are const and so may be invoked
+   concurrently.  Trees are walked in small groups, so that the
+   latencies of their node fetches overlap.
+
+   Rows are laid out as for the transposed prediction blocks:  numeric
+   values by numeric index and factor codes by factor index.  Out-of-bag
+   validation is not supported, as a single row has no training index.
+ */
+class Scorer {
+  static const unsigned int treeGroup = 4; // Trees walked in lockstep.
+
+  const class ForestNode *forestNode;
+  const unsigned int *treeOrigin;
+  const unsigned int nTree;
+  class BVJagged *facSplit;
+  const unsigned int nPredNum;
+  const unsigned int ctgWidth; // Zero iff regression.
+  std::vector<unsigned int> leafOrigin;
+  std::vector<double> leafScore; // Leaf scores, forest-wide.
+  const double *weight; // Per-leaf category weights, iff classification.
+
+  unsigned int Leaf(unsigned int tIdx, const double rowNum[], const unsigned int rowFac[]) const;
+  void Leaves(unsigned int tStart, const double rowNum[], const unsigned int rowFac[], unsigned int leaf[]) const;
+  void Tally(unsigned int nodeIdx, double votes[], double prob[]) const;
+
+ public:
+  Scorer(const class ForestNode _forestNode[], const unsigned int _origin[], unsigned int _nTree, unsigned int _facSplit[], size_t _facLen, const unsigned int _facOrigin[], unsigned int _nFac, const std::vector<unsigned int> &_leafOrigin, const class LeafNode _leafNode[], unsigned int _leafCount, unsigned int _nPredNum, unsigned int _ctgWidth = 0, const double _weight[] = 0);
+  ~Scorer();
+
+  double Regression(const double rowNum[], const unsigned int rowFac[]) const;
+  unsigned int Classification(const double rowNum[], const unsigned int rowFac[], double votes[], double prob[] = 0) const;
+
+
+  inline unsigned int CtgWidth() const {
+    return ctgWidth;
+  }
+};
+
+#endif
@@ -0,0 +1,69 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file simd.cc
+
+   @brief Methods probing the host's vector capabilities.
+
+   @author Mark Seligman
+ */
+
+#include "simd.h"
+
+#include <cstdlib>
+#include <cstring>
+
+//#include <iostream>
+//using namespace std;
+
+
+/**
+   @brief Caches the probe on first call.  Initialization of the local
+   static is thread-safe.
+
+   @return widest instruction-set level available.
+ */
+int Simd::Level() {
+  static const int level = Probe();
+  return level;
+}
+
+
+/**
+   @brief Queries the processor, then applies any cap requested through
+   the environment variable ARBORIST_SIMD, as "scalar", "avx2" or
+   "avx512".  Caps are useful for exercising the narrower kernels on a
+   wider host.
+
+   @return widest instruction-set level both available and permitted.
+ */
+int Simd::Probe() {
+  int level = scalar;
+#ifdef ARBORIST_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    level = avx2;
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"))
+      level = avx512;
+  }
+#endif
+
+  const char *cap = std::getenv("ARBORIST_SIMD");
+  if (cap != 0) {
+    int capLevel = level;
+    if (std::strcmp(cap, "scalar") == 0)
+      capLevel = scalar;
+    else if (std::strcmp(cap, "avx2") == 0)
+      capLevel = avx2;
+    else if (std::strcmp(cap, "avx512") == 0)
+      capLevel = avx512;
+    level = capLevel < level ? capLevel : level;
+  }
+
+  return level;
+}
@@ -0,0 +1,44 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file simd.h
+
+   @brief Run-time selection of vector instruction sets.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_SIMD_H
+#define ARBORIST_SIMD_H
+
+// Vector kernels are compiled for their own targets, by attribute, so
+// that a portable build may still dispatch to them on capable hosts.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ARBORIST_SIMD
+#define ARBORIST_AVX2 __attribute__((target("avx2")))
+#define ARBORIST_AVX512 __attribute__((target("avx2,avx512f,avx512vl")))
+#endif
+
+/**
+   @brief Probes the host, once, for the widest instruction set having a
+   kernel.
+ */
+class Simd {
+  static int Probe();
+
+ public:
+  // Instruction-set levels, in increasing width.
+  static const int scalar = 0;
+  static const int avx2 = 1;
+  static const int avx512 = 2;
+
+  static int Level();
+};
+
+#endif
@@ -22,23 +22,18 @@
 #include "bottom.h"
 #include "runset.h"
 #include "samplepred.h"
-#include "callback.h"
+#include "context.h"
 #include "sample.h"
 #include "predblock.h"
 #include "rowrank.h"
+#include "regscan.h"
 
-unsigned int SplitPred::nPred = 0;
-unsigned int SplitPred::predFixed = 0;
-const double *SplitPred::predProb = 0;
-
-const double *SPReg::feMono = 0;
-unsigned int SPReg::predMono = 0;
-unsigned int SPCtg::ctgWidth = 0;
+#include <map>
 
 /**
   @brief Constructor.  Initializes 'runFlags' to zero for the single-split root.
  */
-SplitPred::SplitPred(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount) : rowRank(_rowRank), pmTrain(_pmTrain), bagCount(_bagCount), noSet(bagCount * pmTrain->NPredFac()), samplePred(_samplePred), splitSig(new SplitSig(pmTrain->NPred())) {
+SplitPred::SplitPred(const TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount, unsigned int _tIdx) : rowRank(_rowRank), predFixed(_trainCtx.PredFixed()), predProb(_trainCtx.PredProb()), trainCtx(_trainCtx), pmTrain(_pmTrain), nPred(_trainCtx.NPred()), bagCount(_bagCount), noSet(bagCount * pmTrain->NPredFac()), tIdx(_tIdx), level(0), samplePred(_samplePred), splitSig(new SplitSig()) {
 }
 
 
@@ -52,67 +47,12 @@ SplitPred::~SplitPred() {
 }
 
 
-void SplitPred::Immutables(unsigned int _nPred, unsigned int _ctgWidth, unsigned int _predFixed, const double _predProb[], const double _regMono[]) {
-  nPred = _nPred; // TODO:  Derive from predProb.size(), when changed to be vector.
-  predFixed = _predFixed;
-  predProb = _predProb;
-
-  if (_ctgWidth > 0) {
-    SPCtg::Immutables(_ctgWidth);
-  }
-  else {
-    SPReg::Immutables(nPred, _regMono);
-  }
-}
-
-
-void SplitPred::DeImmutables() {
-  nPred = 0;
-  predFixed = 0;
-
-  // 'ctgWidth' distinguishes regression from classification.
-  if (SPCtg::CtgWidth() > 0)
-    SPCtg::DeImmutables();
-  else
-    SPReg::DeImmutables();
-}
-
-
-/**
-   @brief Caches a local copy of the mono[] vector.
- */
-
-void SPReg::Immutables(unsigned int _nPred, const double _mono[]) {
-  predMono = 0;
-  feMono = _mono;
-  for (unsigned int i = 0; i < _nPred; i++) {
-    double monoProb = feMono[i];
-    predMono += monoProb != 0.0;
-  }
-}
-
-
-void SPReg::DeImmutables() {
-  predMono = 0;
-}
-
-
-void SPCtg::Immutables(unsigned int _ctgWidth) {
-  ctgWidth = _ctgWidth;
-}
-
-
-void SPCtg::DeImmutables() {
-  ctgWidth = 0;
-}
-
-
 /**
    @brief Constructor.
 
    @param samplePred holds (re)staged node contents.
  */
-SPReg::SPReg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount) : SplitPred(_pmTrain, _rowRank, _samplePred, _bagCount), ruMono(0) {
+SPReg::SPReg(const TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, unsigned int _bagCount, unsigned int _tIdx) : SplitPred(_trainCtx, _pmTrain, _rowRank, _samplePred, _bagCount, _tIdx), predMono(_trainCtx.PredMono()), feMono(_trainCtx.RegMono()), ruMono(0), histogram(_trainCtx.BinMax() > 0 ? new Histogram(_rowRank, nPred) : 0) {
   run = new Run(0, pmTrain->NRow(), noSet);
 }
 
@@ -124,7 +64,7 @@ SPReg::SPReg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samp
 
    @param sampleCtg is the sample vector for the tree, included for category lookup.
  */
-SPCtg::SPCtg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, const std::vector<SampleNode> &_sampleCtg, unsigned int _bagCount): SplitPred(_pmTrain, _rowRank, _samplePred, _bagCount), sampleCtg(_sampleCtg) {
+SPCtg::SPCtg(const TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samplePred, const std::vector<SampleNode> &_sampleCtg, unsigned int _bagCount, unsigned int _tIdx): SplitPred(_trainCtx, _pmTrain, _rowRank, _samplePred, _bagCount, _tIdx), ctgWidth(_trainCtx.CtgWidth()), ctgShift(_trainCtx.CtgShift()), sampleCtg(_sampleCtg) {
   run = new Run(ctgWidth, pmTrain->NRow(), noSet);
 }
 
@@ -140,7 +80,6 @@ SPCtg::SPCtg(const PMTrain *_pmTrain, const RowRank *_rowRank, SamplePred *_samp
 */
 void SplitPred::LevelInit(IndexLevel &index) {
   levelCount = index.LevelCount();
-  splitSig->LevelInit(levelCount);
   std::vector<bool> unsplitable(levelCount);
   std::fill(unsplitable.begin(), unsplitable.end(), false);
   LevelPreset(index, unsplitable);
@@ -174,20 +113,15 @@ unsigned int SplitPred::DenseRank(unsigned int predIdx) const {
 
 
 /**
-   @brief Needs a dense numbering of pred-mono split candidates.
-
-   @return void.
+   @return number of bins quantizing the predictor, zero iff not binned.
  */
-void SPReg::LevelInit(IndexLevel &index) {
-  SplitPred::LevelInit(index);
-  if (predMono > 0) {
-    unsigned int monoCount = levelCount * nPred; // Clearly too big.
-    ruMono = new double[monoCount];
-    CallBack::RUnif(monoCount, ruMono);
-  }
-  else {
-    ruMono = 0;
-  }
+unsigned int SplitPred::BinCount(unsigned int predIdx) const {
+  return rowRank->BinCount(predIdx);
+}
+
+
+unsigned int SplitPred::Bin(unsigned int predIdx, unsigned int rank) const {
+  return rowRank->Bin(predIdx, rank);
 }
 
 
@@ -207,45 +141,33 @@ void SPReg::RunOffsets(const std::vector<unsigned int> &runCount) {
  */
 void SPCtg::RunOffsets(const std::vector<unsigned int> &runCount) {
   run->RunSets(runCount);
-  run->OffsetsCtg();
+  run->OffsetsCtg(trainCtx.Rand(), tIdx, level);
 }
 
 
 /**
-   @brief Signals Bottom to schedule splitable pairs.
+   @brief Signals Bottom to schedule splitable pairs.  Variates are
+   drawn node by node, so that workspace scales with the predictor
+   count rather than with the level's width.
 
    @param unsplitable lists unsplitable nodes.
 
    @return void.
 */
 void SplitPred::Splitable(const std::vector<bool> &unsplitable) {
-    // TODO:  Pre-empt overflow by walking wide subtrees depth-first.
-  int cellCount = levelCount * nPred;
-
-  double *ruPred = new double[cellCount];
-  CallBack::RUnif(cellCount, ruPred);
-
-  BHPair *heap;
-  if (predFixed > 0)
-    heap = new BHPair[cellCount];
-  else
-    heap = 0;
-
+  std::vector<double> ruPred(nPred);
+  std::vector<BHPair> heap(predFixed > 0 ? nPred : 0);
   for (unsigned int levelIdx = 0; levelIdx < levelCount; levelIdx++) {
     if (unsplitable[levelIdx])
       continue; // No predictor splitable
-    unsigned int splitOff = levelIdx * nPred;
+    trainCtx.Rand().RUnif(tIdx, level, PRNG::predSplit, nPred, &ruPred[0], uint64_t(levelIdx) * nPred);
     if (predFixed == 0) { // Probability of predictor splitable.
-      PrescheduleProb(levelIdx, &ruPred[splitOff]);
+      PrescheduleProb(levelIdx, &ruPred[0]);
     }
     else { // Fixed number of predictors splitable.
-      PrescheduleFixed(levelIdx, &ruPred[splitOff], &heap[splitOff]);
+      PrescheduleFixed(levelIdx, &ruPred[0], &heap[0]);
     }
   }
-
-  if (heap != 0)
-    delete [] heap;
-  delete [] ruPred;
 }
 
 
@@ -334,6 +256,16 @@ void SplitPred::ScheduleSplits(const IndexLevel &index) {
     sg.Schedule(bottom, index, noSet, runCount, sc2);
   }
   splitCoord = std::move(sc2);
+  splitSig->LevelInit(splitCoord.size());
+
+  LevelCount &census = bottom->Stat().Front();
+  census.splitCoord += splitCoord.size();
+  for (auto & sg : splitCoord) {
+    if (sg.Implicit() > 0)
+      census.cellDense++;
+    else
+      census.cellSparse++;
+  }
 
   RunOffsets(runCount);
 }
@@ -376,6 +308,8 @@ void SplitCoord::InitLate(const Bottom *bottom, const IndexLevel &index, unsigne
   preBias = index.SplitFields(levelIdx, idxStart, extent, sCount, sum);
   implicit = bottom->AdjustDense(levelIdx, predIdx, idxStart, extent);
   idxEnd = idxStart + extent - 1; // May overflow if singleton:  invalid.
+  histCell = parCell = sibCell = Histogram::noCell;
+  binScan = false;
 }
 
 
@@ -385,8 +319,8 @@ void SplitCoord::InitLate(const Bottom *bottom, const IndexLevel &index, unsigne
 
    @return void.
 */
-void SplitPred::SSWrite(unsigned int levelIdx, unsigned int predIdx, unsigned int setPos, unsigned int bufIdx, const NuxLH &nux) const {
-  splitSig->Write(levelIdx, predIdx, setPos, bufIdx, nux);
+void SplitPred::SSWrite(unsigned int splitPos, unsigned int predIdx, unsigned int setPos, unsigned int bufIdx, const NuxLH &nux) const {
+  splitSig->Write(splitPos, predIdx, setPos, bufIdx, nux);
 }
 
 
@@ -398,6 +332,7 @@ void SplitPred::SSWrite(unsigned int levelIdx, unsigned int predIdx, unsigned in
 void SplitPred::LevelClear() {
   run->LevelClear();
   splitSig->LevelClear();
+  level++;
 }
 
 
@@ -424,6 +359,8 @@ void SPReg::LevelClear() {
 
 
 SPReg::~SPReg() {
+  if (histogram != 0)
+    delete histogram;
 }
 
 
@@ -477,11 +414,8 @@ wells as FacRun vectors.
    @return vector of unsplitable indices.
 */
 void SPCtg::LevelPreset(const IndexLevel &index, std::vector<bool> &unsplitable) {
-  LevelInitSumR(pmTrain->NPredNum());
-  sumSquares = std::move(std::vector<double>(levelCount));
-  ctgSum = std::move(std::vector<double>(levelCount * ctgWidth));
-  std::fill(sumSquares.begin(), sumSquares.end(), 0.0);
-  std::fill(ctgSum.begin(), ctgSum.end(), 0.0);
+  sumSquares.assign(levelCount, 0.0);
+  ctgSum.assign(levelCount * ctgWidth, 0.0);
   index.SumsAndSquares(ctgWidth, sumSquares, ctgSum, unsplitable);
 }
 
@@ -506,14 +440,13 @@ double SPCtg::Prebias(const IndexLevel &index, unsigned int levelIdx) {
 
 
 /**
-   @brief Initializes the accumulated-sum checkerboard.
+   @brief Initializes the accumulated-sum checkerboard, by scheduled pair.
 
    @return void.
  */
 void SPCtg::LevelInitSumR(unsigned int nPredNum) {
   if (nPredNum > 0) {
-    ctgSumAccum = std::move(std::vector<double>(nPredNum * ctgWidth * levelCount));
-    std::fill(ctgSumAccum.begin(), ctgSumAccum.end(), 0.0);
+    ctgSumAccum.assign(splitCoord.size() * ctgWidth, 0.0);
   }
 }
 
@@ -534,14 +467,22 @@ int SPReg::MonoMode(unsigned int levelIdx, unsigned int predIdx) const {
 
 
 void SplitPred::Split(std::vector<SSNode> &argMax) {
+  TrainStat &trainStat = bottom->Stat();
+  TrainStat::Clock start = TrainStat::Now();
   Split();
+  trainStat.Accum(TrainStat::split, start);
+
+  start = TrainStat::Now();
   ArgMax(argMax);
+  trainStat.Accum(TrainStat::argMax, start);
 
   splitCoord.clear();
 }
 
 
 void SPCtg::Split() {
+  LevelInitSumR(pmTrain->NPredNum());
+
   // Guards cast to int for OpenMP 2.0 back-compatibility.
   int splitPos;
 #pragma omp parallel default(shared) private(splitPos)
@@ -554,7 +495,21 @@ void SPCtg::Split() {
 }
 
 
+/**
+   @brief Splits the scheduled pairs.  Histograms derived by subtraction
+   are deferred to a second pass, as they depend on their siblings'.
+
+   @return void.
+ */
 void SPReg::Split() {
+  // Variates for constrained splitting are drawn by node.
+  if (predMono > 0 && !splitCoord.empty()) {
+    ruMono = new double[levelCount];
+    trainCtx.Rand().RUnif(tIdx, level, PRNG::predMono, levelCount, ruMono);
+  }
+  if (histogram != 0)
+    HistSchedule();
+
   // Guards cast to int for OpenMP 2.0 back-compatibility.
   int splitPos;
 #pragma omp parallel default(shared) private(splitPos)
@@ -564,16 +519,118 @@ void SPReg::Split() {
       splitCoord[splitPos].Split(this, samplePred);
     }
   }
+
+  if (histogram != 0) {
+#pragma omp parallel default(shared) private(splitPos)
+    {
+#pragma omp for schedule(dynamic, 1)
+      for (splitPos = 0; splitPos < int(splitCoord.size()); splitPos++) {
+	splitCoord[splitPos].SplitDerived(this, samplePred);
+      }
+    }
+  }
+}
+
+
+/**
+   @brief Selects the pairs to be split by histogram and reserves their
+   bins.  Binnable pairs are unconstrained, numeric and fully explicit.
+   Of these, bins are scanned only by pairs wider than the bin count whose
+   ranks span enough bins to offer a reasonable choice of cuts; others
+   walk their samples, as a coarse scan would stunt the tree.  When a
+   parent retains bins for the predictor, the larger of two binnable
+   siblings derives its bins by subtraction, provided it would scan them.
+
+   Binned pairs are restaged as any other:  accumulation reads the
+   staged cell, and the chosen cut replays its samples from it.  Only the
+   argmax, then, is bounded by the bin count; cost remains linear in the
+   node, through restaging and accumulation alike.
+
+   @return void.
+ */
+void SPReg::HistSchedule() {
+  const unsigned int noPos = splitCoord.size();
+  histogram->LevelInit();
+  std::vector<unsigned int> parCell(splitCoord.size());
+  std::vector<unsigned int> sibPos(splitCoord.size());
+  std::fill(parCell.begin(), parCell.end(), Histogram::noCell);
+  std::fill(sibPos.begin(), sibPos.end(), noPos);
+  std::vector<bool> binnable(splitCoord.size());
+  std::vector<bool> binScan(splitCoord.size());
+  std::map<unsigned int, unsigned int> firstChild; // Parent cell to position.
+  for (unsigned int splitPos = 0; splitPos < splitCoord.size(); splitPos++) {
+    const SplitCoord &sg = splitCoord[splitPos];
+    unsigned int predIdx = sg.PredIdx();
+    unsigned int binCount = BinCount(predIdx);
+    binnable[splitPos] = binCount > 0 && sg.Implicit() == 0 && MonoMode(sg.LevelIdx(), predIdx) == 0;
+    if (!binnable[splitPos])
+      continue;
+    binScan[splitPos] = sg.Extent() > binCount && sg.BinSpan(this, samplePred) >= std::min(binCount, Histogram::spanMin);
+    unsigned int parIdx;
+    if (bottom->Parent(sg.LevelIdx(), parIdx)) {
+      parCell[splitPos] = histogram->Parent(parIdx, predIdx);
+      if (parCell[splitPos] != Histogram::noCell) {
+        auto first = firstChild.find(parCell[splitPos]);
+        if (first == firstChild.end()) {
+          firstChild[parCell[splitPos]] = splitPos;
+        }
+        else {
+          sibPos[splitPos] = first->second;
+          sibPos[first->second] = splitPos;
+        }
+      }
+    }
+  }
+
+  // Derives iff scanning and the larger sibling, ties broken by position.
+  std::vector<bool> derived(splitCoord.size());
+  for (unsigned int splitPos = 0; splitPos < splitCoord.size(); splitPos++) {
+    unsigned int sib = sibPos[splitPos];
+    derived[splitPos] = binScan[splitPos] && sib != noPos && (splitCoord[splitPos].Extent() > splitCoord[sib].Extent() || (splitCoord[splitPos].Extent() == splitCoord[sib].Extent() && splitPos > sib));
+  }
+
+  // Direct accumulators reserve bins ahead of derived pairs.
+  for (unsigned int splitPos = 0; splitPos < splitCoord.size(); splitPos++) {
+    SplitCoord &sg = splitCoord[splitPos];
+    unsigned int sib = sibPos[splitPos];
+    if (!derived[splitPos] && (binScan[splitPos] || (sib != noPos && derived[sib]))) {
+      sg.HistInit(histogram->Reserve(sg.LevelIdx(), sg.PredIdx(), BinCount(sg.PredIdx())), binScan[splitPos]);
+    }
+  }
+  for (unsigned int splitPos = 0; splitPos < splitCoord.size(); splitPos++) {
+    SplitCoord &sg = splitCoord[splitPos];
+    if (derived[splitPos]) {
+      sg.HistInit(histogram->Reserve(sg.LevelIdx(), sg.PredIdx(), BinCount(sg.PredIdx())), true, parCell[splitPos]);
+      sg.SibCell(splitCoord[sibPos[splitPos]].HistCell());
+    }
+  }
+  histogram->LevelSeal();
 }
 
 
+/**
+   @brief Selects the most informative pair of each node.  Pairs are
+   scheduled in node order, so each node's pairs occupy a contiguous
+   range of schedule positions.
+
+   @return void, with output vector.
+ */
 void SplitPred::ArgMax(std::vector<SSNode> &argMax) {
+  std::vector<unsigned int> posStart(levelCount + 1);
+  std::fill(posStart.begin(), posStart.end(), 0);
+  for (auto & sg : splitCoord) {
+    posStart[sg.LevelIdx() + 1]++;
+  }
+  for (unsigned int levelIdx = 0; levelIdx < levelCount; levelIdx++) {
+    posStart[levelIdx + 1] += posStart[levelIdx];
+  }
+
   unsigned int levelIdx;
 #pragma omp parallel default(shared) private(levelIdx)
   {
 #pragma omp for schedule(dynamic, 1)
     for (levelIdx = 0; levelIdx < levelCount; levelIdx++) {
-      argMax[levelIdx].ArgMax(splitSig, levelIdx);
+      argMax[levelIdx].ArgMax(splitSig, posStart[levelIdx], posStart[levelIdx + 1]);
     }
   }
 }
@@ -586,9 +643,106 @@ void SplitCoord::Split(const SPReg *spReg, const SamplePred *samplePred) {
   if (spReg->IsFactor(predIdx)) {
     SplitFac(spReg, samplePred->PredBase(predIdx, bufIdx));
   }
-  else {
+  else if (histCell == Histogram::noCell) {
     SplitNum(spReg, samplePred->PredBase(predIdx, bufIdx));
   }
+  else if (parCell == Histogram::noCell) {
+    SPCol spn = samplePred->PredBase(predIdx, bufIdx);
+    spReg->Hist()->Accum(histCell, predIdx, spn, idxStart, idxEnd);
+    if (binScan) {
+      SplitHist(spReg, spn);
+    }
+    else { // Accumulated only to seed sibling's derivation.
+      SplitNum(spReg, spn);
+    }
+  }
+  // Otherwise derived:  deferred until sibling accumulated.
+}
+
+
+/**
+   @brief Counts the bins spanned by the pair's ranks, valid post restage.
+
+   @return count of bins from lowest to highest rank, inclusive.
+ */
+unsigned int SplitCoord::BinSpan(const SPReg *spReg, const SamplePred *samplePred) const {
+  SPCol spn = samplePred->PredBase(predIdx, bufIdx);
+  return spReg->Bin(predIdx, spn.Rank(idxEnd)) + 1 - spReg->Bin(predIdx, spn.Rank(idxStart));
+}
+
+
+/**
+   @brief Derives bins from those of parent and sibling, then splits.
+   Falls back to direct accumulation should derivation fail.
+
+   @return void.
+ */
+void SplitCoord::SplitDerived(const SPReg *spReg, const SamplePred *samplePred) {
+  if (histCell == Histogram::noCell || parCell == Histogram::noCell)
+    return;
+
+  SPCol spn = samplePred->PredBase(predIdx, bufIdx);
+  Histogram *histogram = spReg->Hist();
+  if (!histogram->Derive(histCell, parCell, sibCell, spReg->BinCount(predIdx), Extent())) {
+    histogram->Accum(histCell, predIdx, spn, idxStart, idxEnd);
+  }
+  SplitHist(spReg, spn);
+}
+
+
+void SplitCoord::SplitHist(const SPReg *spReg, const SPCol &spn) {
+  NuxLH nux;
+  if (SplitHist(spn, spReg->Hist()->Cell(histCell), spReg->BinCount(predIdx), nux)) {
+    spReg->SSWrite(splitPos, predIdx, setIdx, bufIdx, nux);
+  }
+}
+
+
+/**
+   @brief Weighted-variance splitting over bins.  Candidate cuts lie at
+   bin boundaries, which respect ties, so the left-hand extent locates
+   the cut within the restaged samples.
+
+   @param binCell are the pair's bins.
+
+   @param nux outputs split nucleus.
+
+   @return true iff pair splits.
+ */
+bool SplitCoord::SplitHist(const SPCol &spn, const BinCell binCell[], unsigned int binCount, NuxLH &nux) {
+  double sumR = 0.0;
+  unsigned int sCountR = 0;
+  unsigned int extentR = 0;
+  unsigned int lhSampCt = 0;
+  unsigned int lhExtent = 0;
+  double maxInfo = preBias;
+  for (int bin = int(binCount) - 1; bin >= 0; bin--) {
+    const BinCell &bc = binCell[bin];
+    if (bc.extent == 0)
+      continue;
+    if (extentR > 0) { // Cut lies between this bin and its successor.
+      unsigned int sCountL = sCount - sCountR;
+      double sumL = sum - sumR;
+      double binGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
+      if (binGini > maxInfo) {
+	lhSampCt = sCountL;
+	lhExtent = Extent() - extentR;
+	maxInfo = binGini;
+      }
+    }
+    sumR += bc.sum;
+    sCountR += bc.sCount;
+    extentR += bc.extent;
+  }
+
+  if (maxInfo > preBias) {
+    unsigned int lhSup = idxStart + lhExtent - 1;
+    nux.InitNum(idxStart, lhExtent, lhSampCt, maxInfo - preBias, spn.Rank(lhSup), spn.Rank(lhSup + 1));
+    return true;
+  }
+  else {
+    return false;
+  }
 }
 
 
@@ -605,10 +759,10 @@ void SplitCoord::Split(SPCtg *spCtg, const SamplePred *samplePred) {
 }
 
 
-void SplitCoord::SplitNum(const SPReg *spReg, const SPNode spn[]) {
+void SplitCoord::SplitNum(const SPReg *spReg, const SPCol &spn) {
   NuxLH nux;
   if (SplitNum(spReg, spn, nux)) {
-    spReg->SSWrite(levelIdx, predIdx, setIdx, bufIdx, nux);
+    spReg->SSWrite(splitPos, predIdx, setIdx, bufIdx, nux);
   }
 }
 
@@ -618,31 +772,31 @@ void SplitCoord::SplitNum(const SPReg *spReg, const SPNode spn[]) {
 
    @return void.
 */
-void SplitCoord::SplitNum(SPCtg *spCtg, const SPNode spn[]) {
+void SplitCoord::SplitNum(SPCtg *spCtg, const SPCol &spn) {
   NuxLH nux;
   if (SplitNum(spCtg, spn, nux)) {
-    spCtg->SSWrite(levelIdx, predIdx, setIdx, bufIdx, nux);
+    spCtg->SSWrite(splitPos, predIdx, setIdx, bufIdx, nux);
   }
 }
 
 
-void SplitCoord::SplitFac(const SPReg *spReg, const SPNode spn[]) {
+void SplitCoord::SplitFac(const SPReg *spReg, const SPCol &spn) {
   NuxLH nux;
   if (SplitFac(spReg, spn, nux)) {
-    spReg->SSWrite(levelIdx, predIdx, setIdx, bufIdx, nux);
+    spReg->SSWrite(splitPos, predIdx, setIdx, bufIdx, nux);
   }
 }
 
 
-void SplitCoord::SplitFac(const SPCtg *spCtg, const SPNode spn[]) {
+void SplitCoord::SplitFac(const SPCtg *spCtg, const SPCol &spn) {
   NuxLH nux;
   if (SplitFac(spCtg, spn, nux)) {
-    spCtg->SSWrite(levelIdx, predIdx, setIdx, bufIdx, nux);
+    spCtg->SSWrite(splitPos, predIdx, setIdx, bufIdx, nux);
   }
 }
 
 
-bool SplitCoord::SplitFac(const SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::SplitFac(const SPCtg *spCtg, const SPCol &spn, NuxLH &nux) {
   RunSet *runSet = spCtg->RSet(setIdx);
   RunsCtg(spCtg, runSet, spn);
 
@@ -667,7 +821,7 @@ bool SplitCoord::SplitFac(const SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
 
    @return true iff pair splits.
  */
-bool SplitCoord::SplitFac(const SPReg *spReg, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::SplitFac(const SPReg *spReg, const SPCol &spn, NuxLH &nux) {
   RunSet *runSet = spReg->RSet(setIdx);
   RunsReg(runSet, spn, spReg->DenseRank(predIdx));
   runSet->HeapMean();
@@ -686,8 +840,8 @@ bool SplitCoord::SplitFac(const SPReg *spReg, const SPNode spn[], NuxLH &nux) {
 
    @return void.
 */
-bool SplitCoord::SplitNum(const SPReg *spReg, const SPNode spn[], NuxLH &nux) {
-  int monoMode = spReg->MonoMode(splitPos, predIdx);
+bool SplitCoord::SplitNum(const SPReg *spReg, const SPCol &spn, NuxLH &nux) {
+  int monoMode = spReg->MonoMode(levelIdx, predIdx);
   if (monoMode != 0) {
     return implicit > 0 ? SplitNumDenseMono(monoMode > 0, spn, spReg, nux) : SplitNumMono(monoMode > 0, spn, nux);
   }
@@ -703,36 +857,16 @@ bool SplitCoord::SplitNum(const SPReg *spReg, const SPNode spn[], NuxLH &nux) {
 
    @return void.
 */
-bool SplitCoord::SplitNum(const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::SplitNum(const SPCol &spn, NuxLH &nux) {
   unsigned int rkRight, sampleCount;
   FltVal ySum;
-  spn[idxEnd].RegFields(ySum, rkRight, sampleCount);
-  double sumR = ySum;
-  unsigned int sCountL = sCount - sampleCount; // >= 1: counts up to, including, this index. 
-  unsigned int lhSampCt = 0;
-  unsigned int lhSup = idxEnd;
-  double maxInfo = preBias;
+  spn.RegFields(idxEnd, ySum, rkRight, sampleCount);
+  RegScan regScan(sum, sCount, ySum, sCount - sampleCount, rkRight, preBias);
+  regScan.Scan(spn, int(idxEnd) - 1, int(idxStart));
 
-  // Walks samples backward from the end of nodes so that ties are not split.
-  // Signing values avoids decrementing below zero.
-  for (int i = int(idxEnd) - 1; i >= int(idxStart); i--) {
-    unsigned int sCountR = sCount - sCountL;
-    double sumL = sum - sumR;
-    double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
-    unsigned int rkThis;
-    spn[i].RegFields(ySum, rkThis, sampleCount);
-    if (idxGini > maxInfo && rkThis != rkRight) {
-      lhSampCt = sCountL;
-      lhSup = i;
-      maxInfo = idxGini;
-    }
-    sCountL -= sampleCount;
-    sumR += ySum;
-    rkRight = rkThis;
-  }
-
-  if (maxInfo > preBias) {
-    nux.InitNum(idxStart, lhSup + 1 - idxStart, lhSampCt, maxInfo - preBias, spn[lhSup].Rank(), spn[lhSup+1].Rank());
+  if (regScan.maxInfo > preBias) {
+    unsigned int lhSup = regScan.lhSup;
+    nux.InitNum(idxStart, lhSup + 1 - idxStart, regScan.lhSampCt, regScan.maxInfo - preBias, regScan.rankLH, regScan.rankRH);
     return true;
   }
   else {
@@ -746,7 +880,7 @@ bool SplitCoord::SplitNum(const SPNode spn[], NuxLH &nux) {
 
    @return void.
 */
-bool SplitCoord::SplitNumDense(const SPNode spn[], const SPReg *spReg, NuxLH &nux) {
+bool SplitCoord::SplitNumDense(const SPCol &spn, const SPReg *spReg, NuxLH &nux) {
   unsigned int denseRank = spReg->DenseRank(predIdx);
   double sumDense = sum;
   unsigned int sCountDense = sCount;
@@ -764,77 +898,33 @@ bool SplitCoord::SplitNumDense(const SPNode spn[], const SPReg *spReg, NuxLH &nu
     idxFinal = idxStart;
   }
   else {
-    spn[idxEnd].RegFields(ySum, rkRight, sampleCount);
+    spn.RegFields(idxEnd, ySum, rkRight, sampleCount);
     idxNext = idxEnd - 1;
     idxFinal = denseLeft ? idxStart : denseCut;
   }
-  double sumR = ySum;
-  unsigned int sCountL = sCount - sampleCount;
-  unsigned int lhSampCt = 0;
-  double maxInfo = preBias;
-
-  unsigned int rankLH = 0;
-  unsigned int rankRH = 0; // Splitting rank bounds.
-  unsigned int rhInf = idxEnd + 1;  // Always non-negative.
-  for (int i = int(idxNext); i >= int(idxFinal); i--) {
-    unsigned int sCountR = sCount - sCountL;
-    double sumL = sum - sumR;
-    double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
-    unsigned int rkThis;
-    spn[i].RegFields(ySum, rkThis, sampleCount);
-    if (idxGini > maxInfo && rkThis != rkRight) {
-      lhSampCt = sCountL;
-      rankLH = rkThis;
-      rankRH = rkRight;
-      rhInf = i + 1;
-      maxInfo = idxGini;
-    }
-    sCountL -= sampleCount;
-    sumR += ySum;
-    rkRight = rkThis;
-  }
+  RegScan regScan(sum, sCount, ySum, sCount - sampleCount, rkRight, preBias);
+  regScan.Scan(spn, int(idxNext), int(idxFinal));
 
   // Evaluates the dense component, if not of highest rank.
   if (denseCut != idxEnd) {
-    unsigned int sCountR = sCount - sCountL;
-    double sumL = sum - sumR;
-    double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
-    if (idxGini > maxInfo) {
-      lhSampCt = sCountL;
-      rhInf = idxFinal;
-      rankLH = denseRank;
-      rankRH = rkRight;
-      maxInfo = idxGini;
+    double idxInfo = regScan.Info();
+    if (idxInfo > regScan.maxInfo) {
+      regScan.Argmax(idxInfo, int(idxFinal) - 1, denseRank, regScan.rkRight);
     }
   
     if (!denseLeft) { // Walks remaining indices, if any, with rank below dense.
-      sCountL -= sCountDense;
-      sumR += sumDense;
-      rkRight = denseRank;
-      for (int i = idxFinal - 1; i >= int(idxStart); i--) {
-	unsigned int sCountR = sCount - sCountL;
-	double sumL = sum - sumR;
-	double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
-	unsigned int rkThis;
-	spn[i].RegFields(ySum, rkThis, sampleCount);
-	if (idxGini > maxInfo && rkThis != rkRight) {
-	  lhSampCt = sCountL;
-	  rhInf = i + 1;
-	  rankLH = rkThis;
-	  rankRH = rkRight;
-	  maxInfo = idxGini;
-	}
-	sCountL -= sampleCount;
-	sumR += ySum;
-	rkRight = rkThis;
-      }
+      regScan.sCountL -= sCountDense;
+      regScan.sumR += sumDense;
+      regScan.rkRight = denseRank;
+      regScan.Scan(spn, int(idxFinal) - 1, int(idxStart));
     }
   }
 
-  if (maxInfo > preBias) {
+  if (regScan.maxInfo > preBias) {
+    unsigned int rankLH = regScan.rankLH;
     unsigned int lhDense = rankLH >= denseRank ? implicit : 0;
-    unsigned int lhIdxTot = rhInf - idxStart + lhDense;
-    nux.InitNum(idxStart, lhIdxTot, lhSampCt, maxInfo - preBias, rankLH, rankRH, lhDense);
+    unsigned int lhIdxTot = regScan.lhSup + 1 - idxStart + lhDense;
+    nux.InitNum(idxStart, lhIdxTot, regScan.lhSampCt, regScan.maxInfo - preBias, rankLH, regScan.rankRH, lhDense);
     return true;
   }
   else {
@@ -848,7 +938,7 @@ bool SplitCoord::SplitNumDense(const SPNode spn[], const SPReg *spReg, NuxLH &nu
 
    @return void.
 */
-bool SplitCoord::SplitNumDenseMono(bool increasing, const SPNode spn[], const SPReg *spReg, NuxLH &nux) {
+bool SplitCoord::SplitNumDenseMono(bool increasing, const SPCol &spn, const SPReg *spReg, NuxLH &nux) {
   unsigned int denseRank = spReg->DenseRank(predIdx);
   double sumDense = sum;
   unsigned int sCountDense = sCount;
@@ -866,7 +956,7 @@ bool SplitCoord::SplitNumDenseMono(bool increasing, const SPNode spn[], const SP
     idxFinal = idxStart;
   }
   else {
-    spn[idxEnd].RegFields(ySum, rkRight, sampleCount);
+    spn.RegFields(idxEnd, ySum, rkRight, sampleCount);
     idxNext = idxEnd - 1;
     idxFinal = denseLeft ? idxStart : denseCut;
   }
@@ -883,7 +973,7 @@ bool SplitCoord::SplitNumDenseMono(bool increasing, const SPNode spn[], const SP
     double sumL = sum - sumR;
     double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
     unsigned int rkThis;
-    spn[i].RegFields(ySum, rkThis, sampleCount);
+    spn.RegFields(i, ySum, rkThis, sampleCount);
     if (idxGini > maxInfo && rkThis != rkRight) {
       bool up = (sumL * sCountR <= sumR * sCountL);
       if (increasing ? up : !up) {
@@ -921,7 +1011,7 @@ bool SplitCoord::SplitNumDenseMono(bool increasing, const SPNode spn[], const SP
 	double sumL = sum - sumR;
 	double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
 	unsigned int rkThis;
-	spn[i].RegFields(ySum, rkThis, sampleCount);
+	spn.RegFields(i, ySum, rkThis, sampleCount);
 	if (idxGini > maxInfo && rkThis != rkRight) {
 	  bool up = (sumL * sCountR <= sumR * sCountL);
 	  if (increasing ? up : !up) {
@@ -956,10 +1046,10 @@ bool SplitCoord::SplitNumDenseMono(bool increasing, const SPNode spn[], const SP
 
    @return void.
 */
-bool SplitCoord::SplitNumMono(bool increasing, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::SplitNumMono(bool increasing, const SPCol &spn, NuxLH &nux) {
   unsigned int rkRight, sampleCount;
   FltVal ySum;
-  spn[idxEnd].RegFields(ySum, rkRight, sampleCount);
+  spn.RegFields(idxEnd, ySum, rkRight, sampleCount);
   double sumR = ySum;
   unsigned int sCountL = sCount - sampleCount; // >= 1: counts up to, including, this index. 
   unsigned int lhSampCt = 0;
@@ -973,7 +1063,7 @@ bool SplitCoord::SplitNumMono(bool increasing, const SPNode spn[], NuxLH &nux) {
     double sumL = sum - sumR;
     double idxGini = (sumL * sumL) / sCountL + (sumR * sumR) / sCountR;
     unsigned int rkThis;
-    spn[i].RegFields(ySum, rkThis, sampleCount);
+    spn.RegFields(i, ySum, rkThis, sampleCount);
     if (idxGini > maxInfo && rkThis != rkRight) {
       bool up = (sumL * sCountR <= sumR * sCountL);
       if (increasing ? up : !up) {
@@ -987,7 +1077,7 @@ bool SplitCoord::SplitNumMono(bool increasing, const SPNode spn[], NuxLH &nux) {
     rkRight = rkThis;
   }
   if (maxInfo > preBias) {
-    nux.InitNum(idxStart, lhSup + 1 - idxStart, lhSampCt, maxInfo - preBias, spn[lhSup].Rank(), spn[lhSup + 1].Rank());
+    nux.InitNum(idxStart, lhSup + 1 - idxStart, lhSampCt, maxInfo - preBias, spn.Rank(lhSup), spn.Rank(lhSup + 1));
     return true;
   }
   else {
@@ -1010,14 +1100,14 @@ bool SplitCoord::SplitNumMono(bool increasing, const SPNode spn[], NuxLH &nux) {
 
    @return supremum of indices to the left ot the dense rank.
 */
-unsigned int SPReg::Residuals(const SPNode spn[], unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, unsigned int &denseLeft, unsigned int &denseRight, double &sumDense, unsigned int &sCountDense) const {
+unsigned int SPReg::Residuals(const SPCol &spn, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, unsigned int &denseLeft, unsigned int &denseRight, double &sumDense, unsigned int &sCountDense) const {
   unsigned int denseCut = idxEnd; // Defaults to highest index.
   double sumTot = 0.0;
   unsigned int sCountTot = 0;
   for (int idx = int(idxEnd); idx >= int(idxStart); idx--) {
     unsigned int sampleCount, rkThis;
     FltVal ySum;
-    spn[idx].RegFields(ySum, rkThis, sampleCount);
+    spn.RegFields(idx, ySum, rkThis, sampleCount);
     denseCut = rkThis > denseRank ? idx : denseCut;
     sCountTot += sampleCount;
     sumTot += ySum;
@@ -1026,8 +1116,8 @@ unsigned int SPReg::Residuals(const SPNode spn[], unsigned int idxStart, unsigne
   sCountDense -= sCountTot;
 
   // Dense blob is either left, right or neither.
-  denseRight = (denseCut == idxEnd && spn[denseCut].Rank() < denseRank);  
-  denseLeft = (denseCut == idxStart && spn[denseCut].Rank() > denseRank);
+  denseRight = (denseCut == idxEnd && spn.Rank(denseCut) < denseRank);  
+  denseLeft = (denseCut == idxStart && spn.Rank(denseCut) > denseRank);
   
   return denseCut;
 }
@@ -1041,7 +1131,7 @@ unsigned int SPReg::Residuals(const SPNode spn[], unsigned int idxStart, unsigne
 
    @return true iff left bound has rank less than dense rank.
 */
-unsigned int SPCtg::Residuals(const SPNode spn[], unsigned int levelIdx, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, bool &denseLeft, bool &denseRight, double &sumDense, unsigned int &sCountDense, std::vector<double> &ctgSumDense) const {
+unsigned int SPCtg::Residuals(const SPCol &spn, unsigned int levelIdx, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, bool &denseLeft, bool &denseRight, double &sumDense, unsigned int &sCountDense, std::vector<double> &ctgSumDense) const {
   std::vector<double> ctgAccum;
   ctgSumDense.reserve(ctgWidth);
   ctgAccum.reserve(ctgWidth);
@@ -1056,7 +1146,7 @@ unsigned int SPCtg::Residuals(const SPNode spn[], unsigned int levelIdx, unsigne
     // Accumulates statistics over explicit range.
     unsigned int yCtg, rkThis;
     FltVal ySum;
-    unsigned int sampleCount = spn[idx].CtgFields(ySum, rkThis, yCtg);
+    unsigned int sampleCount = spn.CtgFields(idx, ctgShift, ySum, rkThis, yCtg);
     ctgAccum[yCtg] += ySum;
     denseCut = rkThis >= denseRank ? idx : denseCut;
     sCountTot += sampleCount;
@@ -1069,18 +1159,17 @@ unsigned int SPCtg::Residuals(const SPNode spn[], unsigned int levelIdx, unsigne
   }
 
   // Dense blob is either left, right or neither.
-  denseRight = (denseCut == idxEnd && spn[idxEnd].Rank() < denseRank);  
-  denseLeft = (denseCut == idxStart && spn[idxStart].Rank() > denseRank);
+  denseRight = (denseCut == idxEnd && spn.Rank(idxEnd) < denseRank);  
+  denseLeft = (denseCut == idxStart && spn.Rank(idxStart) > denseRank);
   
   return denseCut;
 }
 
 
-void SPCtg::ApplyResiduals(unsigned int levelIdx, unsigned int predIdx, double &ssL, double &ssR, std::vector<double> &sumDenseCtg) {
-  unsigned int numIdx = NumIdx(predIdx);
+void SPCtg::ApplyResiduals(unsigned int levelIdx, unsigned int splitPos, double &ssL, double &ssR, std::vector<double> &sumDenseCtg) {
   for (unsigned int ctg = 0; ctg < ctgWidth; ctg++) {
     double ySum = sumDenseCtg[ctg];
-    double sumRCtg = CtgSumAccum(levelIdx, numIdx, ctg, ySum);
+    double sumRCtg = CtgSumAccum(splitPos, ctg, ySum);
     ssR += ySum * (ySum + 2.0 * sumRCtg);
     double sumLCtg = CtgSum(levelIdx, ctg) - sumRCtg;
     ssL += ySum * (ySum - 2.0 * sumLCtg);
@@ -1088,7 +1177,7 @@ void SPCtg::ApplyResiduals(unsigned int levelIdx, unsigned int predIdx, double &
 }
 
 
-bool SplitCoord::SplitNum(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::SplitNum(SPCtg *spCtg, const SPCol &spn, NuxLH &nux) {
   if (implicit > 0) {
     return NumCtgDense(spCtg, spn, nux);
   }
@@ -1098,9 +1187,9 @@ bool SplitCoord::SplitNum(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
 }
 
 
-bool SplitCoord::NumCtg(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::NumCtg(SPCtg *spCtg, const SPCol &spn, NuxLH &nux) {
   unsigned int sCountL = sCount;
-  unsigned int rkRight = spn[idxEnd].Rank();
+  unsigned int rkRight = spn.Rank(idxEnd);
   double sumL = sum;
   double ssL = spCtg->SumSquares(levelIdx);
   double ssR = 0.0;
@@ -1122,14 +1211,13 @@ bool SplitCoord::NumCtg(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
 }
 
 
-unsigned int SplitCoord::NumCtgGini(SPCtg *spCtg, const SPNode spn[], unsigned int idxNext, unsigned int idxFinal, unsigned int &sCountL, unsigned int &rkRight, double &sumL, double &ssL, double &ssR, double &maxGini, unsigned int &rankLH, unsigned int &rankRH, unsigned int &rhInf) {
+unsigned int SplitCoord::NumCtgGini(SPCtg *spCtg, const SPCol &spn, unsigned int idxNext, unsigned int idxFinal, unsigned int &sCountL, unsigned int &rkRight, double &sumL, double &ssL, double &ssR, double &maxGini, unsigned int &rankLH, unsigned int &rankRH, unsigned int &rhInf) {
   unsigned int lhSampCt = 0;
-  unsigned int numIdx = spCtg->NumIdx(predIdx);
   // Signing values avoids decrementing below zero.
   for (int idx = int(idxNext); idx >= int(idxFinal); idx--) {
     FltVal ySum;    
     unsigned int yCtg, rkThis;
-    unsigned int sampleCount = spn[idx].CtgFields(ySum, rkThis, yCtg);
+    unsigned int sampleCount = spn.CtgFields(idx, spCtg->CtgShift(), ySum, rkThis, yCtg);
     FltVal sumR = sum - sumL;
     if (rkThis != rkRight && spCtg->StableDenoms(sumL, sumR)) {
       FltVal cutGini = ssL / sumL + ssR / sumR;
@@ -1146,7 +1234,7 @@ unsigned int SplitCoord::NumCtgGini(SPCtg *spCtg, const SPNode spn[], unsigned i
     sCountL -= sampleCount;
     sumL -= ySum;
 
-    double sumRCtg = spCtg->CtgSumAccum(levelIdx, numIdx, yCtg, ySum);
+    double sumRCtg = spCtg->CtgSumAccum(splitPos, yCtg, ySum);
     ssR += ySum * (ySum + 2.0 * sumRCtg);
     double sumLCtg = spCtg->CtgSum(levelIdx, yCtg) - sumRCtg;
     ssL += ySum * (ySum - 2.0 * sumLCtg);
@@ -1156,7 +1244,7 @@ unsigned int SplitCoord::NumCtgGini(SPCtg *spCtg, const SPNode spn[], unsigned i
 }
 
 
-bool SplitCoord::NumCtgDense(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
+bool SplitCoord::NumCtgDense(SPCtg *spCtg, const SPCol &spn, NuxLH &nux) {
   unsigned int denseRank = spCtg->DenseRank(predIdx);
   double sumDense = sum;
   unsigned int sCountDense = sCount;
@@ -1173,13 +1261,13 @@ bool SplitCoord::NumCtgDense(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
   if (denseRight) { // Implicit values to the far right.
     idxFinal = idxStart;
     rkRight = denseRank;
-    spCtg->ApplyResiduals(levelIdx, predIdx, ssL, ssR, sumDenseCtg);
+    spCtg->ApplyResiduals(levelIdx, splitPos, ssL, ssR, sumDenseCtg);
     sCountL -= sCountDense;
     sumL -= sumDense;
   }
   else {
     idxFinal = denseLeft ? idxStart : denseCut + 1;
-    rkRight = spn[idxEnd].Rank();
+    rkRight = spn.Rank(idxEnd);
   }
 
   double maxInfo = preBias;
@@ -1203,7 +1291,7 @@ bool SplitCoord::NumCtgDense(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
     }
 
     if (!denseLeft) {  // Walks remaining indices, if any with ranks below dense.
-      spCtg->ApplyResiduals(levelIdx, predIdx, ssR, ssL, sumDenseCtg);
+      spCtg->ApplyResiduals(levelIdx, splitPos, ssR, ssL, sumDenseCtg);
       sCountL -= sCountDense;
       sumL -= sumDense;
       lhSampCt = NumCtgGini(spCtg, spn, denseCut, idxStart, sCountL, rkRight, sumL, ssL, ssR, maxInfo, rankLH, rankRH, rhInf);
@@ -1225,10 +1313,10 @@ bool SplitCoord::NumCtgDense(SPCtg *spCtg, const SPNode spn[], NuxLH &nux) {
 /**
    Regression runs always maintained by heap.
 */
-void SplitCoord::RunsReg(RunSet *runSet, const SPNode spn[], unsigned int denseRank) const {
+void SplitCoord::RunsReg(RunSet *runSet, const SPCol &spn, unsigned int denseRank) const {
   double sumHeap = 0.0;
   unsigned int sCountHeap = 0;
-  unsigned int rkThis = spn[idxEnd].Rank();
+  unsigned int rkThis = spn.Rank(idxEnd);
   unsigned int frEnd = idxEnd;
 
   // Signing values avoids decrementing below zero.
@@ -1237,7 +1325,7 @@ void SplitCoord::RunsReg(RunSet *runSet, const SPNode spn[], unsigned int denseR
     unsigned int rkRight = rkThis;
     unsigned int sampleCount;
     FltVal ySum;
-    spn[i].RegFields(ySum, rkThis, sampleCount);
+    spn.RegFields(i, ySum, rkThis, sampleCount);
 
     if (rkThis == rkRight) { // Same run:  counters accumulate.
       sumHeap += ySum;
@@ -1305,10 +1393,10 @@ bool SplitCoord::HeapSplit(RunSet *runSet, NuxLH &nux) const {
    when run count has been estimated to be wide:
 
 */
-void SplitCoord::RunsCtg(const SPCtg *spCtg, RunSet *runSet, const SPNode spn[]) const {
+void SplitCoord::RunsCtg(const SPCtg *spCtg, RunSet *runSet, const SPCol &spn) const {
   double sumLoc = 0.0;
   unsigned int sCountLoc = 0;
-  unsigned int rkThis = spn[idxEnd].Rank();
+  unsigned int rkThis = spn.Rank(idxEnd);
 
   // Signing values avoids decrementing below zero.
   unsigned int frEnd = idxEnd;
@@ -1316,7 +1404,7 @@ void SplitCoord::RunsCtg(const SPCtg *spCtg, RunSet *runSet, const SPNode spn[])
     unsigned int rkRight = rkThis;
     unsigned int yCtg;
     FltVal ySum;
-    unsigned int sampleCount = spn[i].CtgFields(ySum, rkThis, yCtg);
+    unsigned int sampleCount = spn.CtgFields(i, spCtg->CtgShift(), ySum, rkThis, yCtg);
 
     if (rkThis == rkRight) { // Current run's counters accumulate.
       sumLoc += ySum;
@@ -18,6 +18,7 @@
  */
 
 #include "param.h"
+#include "histogram.h"
 #include <vector>
 
 
@@ -35,36 +36,104 @@ class SplitCoord {
   unsigned int setIdx;  // Per pair.
   unsigned int implicit;  // Per pair:  post restage.
   unsigned int idxEnd; // Per pair:  post restage.
+  unsigned int histCell; // Per pair:  bins, if split by histogram.
+  unsigned int parCell; // Per pair:  parent's bins, if derived.
+  unsigned int sibCell; // Per pair:  sibling's bins, if derived.
+  bool binScan; // Per pair:  whether split by scanning bins.
   unsigned char bufIdx; // Per pair.
  public:
 
+  /**
+     @brief Accessor for the implicit (dense) index count.
+   */
+  inline unsigned int Implicit() const {
+    return implicit;
+  }
+
+
+  inline unsigned int LevelIdx() const {
+    return levelIdx;
+  }
+
+
+  inline unsigned int PredIdx() const {
+    return predIdx;
+  }
+
+
+  inline unsigned int SplitPos() const {
+    return splitPos;
+  }
+
+
+  /**
+     @return count of explicit indices, valid post restage.
+   */
+  inline unsigned int Extent() const {
+    return idxEnd + 1 - idxStart;
+  }
+
+
+  /**
+     @brief Selects histogram splitting for the pair.
+
+     @param _histCell is the starting cell of the pair's bins.
+
+     @param _binScan is true iff the bins are scanned for splitting,
+     rather than merely accumulated for a sibling's use.
+
+     @param _parCell is the parent's starting cell, if derived by
+     subtraction, else 'noCell'.
+
+     @return void.
+   */
+  inline void HistInit(unsigned int _histCell, bool _binScan, unsigned int _parCell = Histogram::noCell) {
+    histCell = _histCell;
+    binScan = _binScan;
+    parCell = _parCell;
+  }
+
+
+  inline unsigned int HistCell() const {
+    return histCell;
+  }
+
+
+  inline void SibCell(unsigned int _sibCell) {
+    sibCell = _sibCell;
+  }
+
   bool Preschedule(class Bottom *bottom, unsigned int _levelIdx, unsigned int _predIdx, std::vector<SplitCoord> &splitCoord);
   void Schedule(const class Bottom *bottom, const class IndexLevel &indexLevel, unsigned int noSet, std::vector<unsigned int> &runCount, std::vector<SplitCoord> &sc2);
   void InitLate(const class Bottom *bottom, const class IndexLevel &index, unsigned int _splitPos, unsigned int _setIdx);
 
   void Split(const class SPReg *spReg, const class SamplePred *samplePred);
+  void SplitDerived(const class SPReg *spReg, const class SamplePred *samplePred);
+  unsigned int BinSpan(const class SPReg *spReg, const class SamplePred *samplePred) const;
+  void SplitHist(const class SPReg *spReg, const class SPCol &spn);
+  bool SplitHist(const class SPCol &spn, const class BinCell binCell[], unsigned int binCount, class NuxLH &nux);
   void Split(class SPCtg *spCtg, const class SamplePred *samplePred);
-  void SplitNum(const class SPReg *splitReg, const class SPNode spn[]);
-  void SplitNum(class SPCtg *splitCtg, const class SPNode spn[]);
-  bool SplitNum(const class SPReg *spReg, const class SPNode spn[], class NuxLH &nux);
-  bool SplitNum(const class SPNode spn[], class NuxLH &nux);
-  bool SplitNumDense(const class SPNode spn[], const class SPReg *spReg, class NuxLH &nux);
-  bool SplitNumDenseMono(bool increasing, const class SPNode spn[], const class SPReg *spReg, class NuxLH &nux);
-  bool SplitNumMono(bool increasing, const class SPNode spn[], class NuxLH &nux);
-  bool SplitNum(class SPCtg *spCtg, const class SPNode spn[], class NuxLH &nux);
-  bool NumCtgDense(class SPCtg *spCtg, const class SPNode spn[], class NuxLH &nux);
-  bool NumCtg(class SPCtg *spCtg, const class SPNode spn[], class NuxLH &nux);
-  unsigned int NumCtgGini(SPCtg *spCtg, const class SPNode spn[], unsigned int idxNext, unsigned int idxFinal, unsigned int &sCountL, unsigned int &rkRight, double &sumL, double &ssL, double &ssR, double &maxGini, unsigned int &rankLH, unsigned int &rankRH, unsigned int &rhInf);
-  void SplitFac(const class SPReg *splitReg, const class SPNode spn[]);
-  void SplitFac(const class SPCtg *splitCtg, const class SPNode spn[]);
-  bool SplitFac(const class SPReg *spReg, const class SPNode spn[], class NuxLH &nux);
-  bool SplitFac(const class SPCtg *spCtg, const class SPNode spn[], class NuxLH &nux);
+  void SplitNum(const class SPReg *splitReg, const class SPCol &spn);
+  void SplitNum(class SPCtg *splitCtg, const class SPCol &spn);
+  bool SplitNum(const class SPReg *spReg, const class SPCol &spn, class NuxLH &nux);
+  bool SplitNum(const class SPCol &spn, class NuxLH &nux);
+  bool SplitNumDense(const class SPCol &spn, const class SPReg *spReg, class NuxLH &nux);
+  bool SplitNumDenseMono(bool increasing, const class SPCol &spn, const class SPReg *spReg, class NuxLH &nux);
+  bool SplitNumMono(bool increasing, const class SPCol &spn, class NuxLH &nux);
+  bool SplitNum(class SPCtg *spCtg, const class SPCol &spn, class NuxLH &nux);
+  bool NumCtgDense(class SPCtg *spCtg, const class SPCol &spn, class NuxLH &nux);
+  bool NumCtg(class SPCtg *spCtg, const class SPCol &spn, class NuxLH &nux);
+  unsigned int NumCtgGini(SPCtg *spCtg, const class SPCol &spn, unsigned int idxNext, unsigned int idxFinal, unsigned int &sCountL, unsigned int &rkRight, double &sumL, double &ssL, double &ssR, double &maxGini, unsigned int &rankLH, unsigned int &rankRH, unsigned int &rhInf);
+  void SplitFac(const class SPReg *splitReg, const class SPCol &spn);
+  void SplitFac(const class SPCtg *splitCtg, const class SPCol &spn);
+  bool SplitFac(const class SPReg *spReg, const class SPCol &spn, class NuxLH &nux);
+  bool SplitFac(const class SPCtg *spCtg, const class SPCol &spn, class NuxLH &nux);
   bool SplitBinary(const class SPCtg *spCtg, class RunSet *runSet, class NuxLH &nux);
   bool SplitRuns(const class SPCtg *spCtg, class RunSet *runSet, class NuxLH &nux);
 
-  void RunsReg(class RunSet *runSet, const class SPNode spn[], unsigned int denseRank) const;
+  void RunsReg(class RunSet *runSet, const class SPCol &spn, unsigned int denseRank) const;
   bool HeapSplit(class RunSet *runSet, class NuxLH &nux) const;
-  void RunsCtg(const class SPCtg *spCtg, class RunSet *runSet, const SPNode spn[]) const;
+  void RunsCtg(const class SPCtg *spCtg, class RunSet *runSet, const SPCol &spn) const;
 };
 
 
@@ -77,8 +146,8 @@ class SplitCoord {
 //
 class SplitPred {
   const class RowRank *rowRank;
-  static unsigned int predFixed;
-  static const double *predProb;
+  const unsigned int predFixed;
+  const double *predProb;
 
   void SetPrebias(class IndexLevel &level);
   void SplitFlags(bool unsplitable[]);
@@ -87,10 +156,13 @@ class SplitPred {
   bool Preschedule(unsigned int levelIdx, unsigned int predIdx);
   
  protected:
+  const class TrainContext &trainCtx;
   const class PMTrain *pmTrain;
-  static unsigned int nPred;
+  const unsigned int nPred;
   const unsigned int bagCount;
   const unsigned int noSet; // Unreachable setIdx for SplitCoord.
+  const unsigned int tIdx; // Absolute tree index:  keys variate streams.
+  unsigned int level; // Tree-relative level index.
   class Bottom *bottom;
   unsigned int levelCount; // # subtree nodes at current level.
   class Run *run;
@@ -102,14 +174,14 @@ public:
   class SamplePred *samplePred;
   class SplitSig *splitSig;
 
-  SplitPred(const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int bagCount);
-  static void Immutables(unsigned int _nPred, unsigned int _ctgWidth, unsigned int _predFixed, const double _predProb[], const double _regMono[]);
-  static void DeImmutables();
+  SplitPred(const class TrainContext &_trainCtx, const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int bagCount, unsigned int _tIdx);
   void ScheduleSplits(const class IndexLevel &index);
   unsigned int DenseRank(unsigned int predIdx) const;
+  unsigned int BinCount(unsigned int predIdx) const;
+  unsigned int Bin(unsigned int predIdx, unsigned int rank) const;
   bool IsFactor(unsigned int predIdx) const;
   unsigned int NumIdx(unsigned int predIdx) const;
-  void SSWrite(unsigned int levelIdx, unsigned int predIdx, unsigned int setPos, unsigned int bufIdx, const class NuxLH &nux) const;
+  void SSWrite(unsigned int splitPos, unsigned int predIdx, unsigned int setPos, unsigned int bufIdx, const class NuxLH &nux) const;
 
   class Run *Runs() {
     return run;
@@ -137,23 +209,28 @@ public:
    @brief Splitting facilities specific regression trees.
  */
 class SPReg : public SplitPred {
-  static unsigned int predMono;
-  static const double *feMono;
+  const unsigned int predMono;
+  const double *feMono; // Null iff unconstrained.
   double *ruMono;
+  class Histogram *histogram; // Null iff splitting walks every sample.
 
   void Split();
+  void HistSchedule();
 
  public:
-  unsigned int Residuals(const SPNode spn[], unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, unsigned int &denseLeft, unsigned int &denseRight, double &sumDense, unsigned int &sCountDense) const;
-  static void Immutables(unsigned int _nPred, const double *_mono);
-  static void DeImmutables();
-  SPReg(const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int bagCount);
+  /**
+     @brief Accessor for the histogram, if any.
+   */
+  inline class Histogram *Hist() const {
+    return histogram;
+  }
+  unsigned int Residuals(const SPCol &spn, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, unsigned int &denseLeft, unsigned int &denseRight, double &sumDense, unsigned int &sCountDense) const;
+  SPReg(const class TrainContext &_trainCtx, const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, unsigned int bagCount, unsigned int _tIdx);
   ~SPReg();
-  int MonoMode(unsigned int splitIdx, unsigned int predIdx) const;
+  int MonoMode(unsigned int levelIdx, unsigned int predIdx) const;
   void RunOffsets(const std::vector<unsigned int> &safeCount);
   void LevelPreset(const class IndexLevel &index, std::vector<bool> &unsplitable);
   double Prebias(const class IndexLevel &index, unsigned int spiltIdx);
-  void LevelInit(class IndexLevel &index);
   void LevelClear();
 };
 
@@ -167,10 +244,11 @@ class SPCtg : public SplitPred {
   static constexpr double minSumL = 1.0e-8;
   static constexpr double minSumR = 1.0e-5;
 
-  static unsigned int ctgWidth;
+  const unsigned int ctgWidth;
+  const unsigned int ctgShift; // Category packing width.
   std::vector<double> sumSquares; // Per-level sum of squares, by split.
   std::vector<double> ctgSum; // Per-level sum, by split/category pair.
-  std::vector<double> ctgSumAccum; // Numeric predictors:  accumulate sums.
+  std::vector<double> ctgSumAccum; // Accumulated sums, by scheduled pair/category.
   const std::vector<class SampleNode> &sampleCtg;
   void LevelPreset(const class IndexLevel &index, std::vector<bool> &unsplitable);
   double Prebias(const class IndexLevel &index, unsigned int levelIdx);
@@ -182,12 +260,10 @@ class SPCtg : public SplitPred {
 
 
  public:
-  SPCtg(const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, const std::vector<class SampleNode> &_sampleCtg, unsigned int bagCount);
+  SPCtg(const class TrainContext &_trainCtx, const class PMTrain *_pmTrain, const class RowRank *_rowRank, class SamplePred *_samplePred, const std::vector<class SampleNode> &_sampleCtg, unsigned int bagCount, unsigned int _tIdx);
   ~SPCtg();
-  static void Immutables(unsigned int _ctgWidth);
-  static void DeImmutables();
-  unsigned int Residuals(const SPNode spn[], unsigned int levelIdx, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, bool &denseLeft, bool &denseRight, double &sumDense, unsigned int &sCountDense, std::vector<double> &ctgSumDense) const;
-  void ApplyResiduals(unsigned int levelIdx, unsigned int predIdx, double &ssL, double &ssr, std::vector<double> &sumDenseCtg);
+  unsigned int Residuals(const SPCol &spn, unsigned int levelIdx, unsigned int idxStart, unsigned int idxEnd, unsigned int denseRank, bool &denseLeft, bool &denseRight, double &sumDense, unsigned int &sCountDense, std::vector<double> &ctgSumDense) const;
+  void ApplyResiduals(unsigned int levelIdx, unsigned int splitPos, double &ssL, double &ssr, std::vector<double> &sumDenseCtg);
   /**
      @brief Determine whether a pair of square-sums is acceptably stable
      for a gain computation.
@@ -234,9 +310,7 @@ class SPCtg : public SplitPred {
      in a given direction and updates the subaccumulator by the current
      proxy value.
 
-     @param levelIdx is the level-relative node index.
-
-     @param numIdx is contiguouly-numbered numerical index of the predictor.
+     @param splitPos is the pair's position in the splitting schedule.
 
      @param yCtg is the categorical response value.
 
@@ -244,8 +318,8 @@ class SPCtg : public SplitPred {
 
      @return current partial sum.
   */
-  inline double CtgSumAccum(unsigned int levelIdx, unsigned int numIdx, unsigned int yCtg, double ySum) {
-    int off = numIdx * levelCount * ctgWidth + levelIdx * ctgWidth + yCtg;
+  inline double CtgSumAccum(unsigned int splitPos, unsigned int yCtg, double ySum) {
+    unsigned int off = splitPos * ctgWidth + yCtg;
     double val = ctgSumAccum[off];
     ctgSumAccum[off] = val + ySum;
 
@@ -253,10 +327,15 @@ class SPCtg : public SplitPred {
   }
 
 
-  static inline unsigned int CtgWidth() {
+  inline unsigned int CtgWidth() const {
     return ctgWidth;
   }
 
+
+  inline unsigned int CtgShift() const {
+    return ctgShift;
+  }
+
   
   double SumSquares(unsigned int levelIdx) {
     return sumSquares[levelIdx];
@@ -28,31 +28,6 @@
 /* Split signature values only live during a single level.
 */
 
-double SSNode::minRatio = 0.0;
-
-// TODO:  Economize on width (nPred) here et seq.
-//
-
-/**
-   @brief Sets immutable static values.
-
-   @param _minRatio is an inf information content for splitting.  Must
-   be non-negative, as otherwise ArgMax cannot distinguish splitting
-   candidates from unset SSNodes, which have initial 'info' == 0.
-
-   @return void.
- */
-void SplitSig::Immutables(double _minRatio) {
-  SSNode::minRatio = _minRatio;
-}
-
-
-/**
-   @brief Finalizer.
-*/  
-void SplitSig::DeImmutables() {
-  SSNode::minRatio = 0.0;
-}
 
 
 /**
@@ -66,14 +41,14 @@ void SplitSig::DeImmutables() {
 
    @return void.
  */
-void SplitSig::Write(unsigned int _levelIdx, unsigned int _predIdx, unsigned int _setIdx, unsigned int _bufIdx, const NuxLH &nux) {
+void SplitSig::Write(unsigned int _splitPos, unsigned int _predIdx, unsigned int _setIdx, unsigned int _bufIdx, const NuxLH &nux) {
   SSNode ssn;
   ssn.predIdx = _predIdx;
   ssn.setIdx = _setIdx;
   ssn.bufIdx = _bufIdx;
   nux.Ref(ssn.idxStart, ssn.lhExtent, ssn.sCount, ssn.info, ssn.rankRange, ssn.lhImplicit);
 
-  Lookup(_levelIdx, ssn.predIdx) = ssn;
+  Lookup(_splitPos) = ssn;
 }
 
 
@@ -179,31 +154,34 @@ double SSNode::ReplayNum(Bottom *bottom, unsigned int extent) const {
 
    @return void.
  */
-void SSNode::ArgMax(const SplitSig *splitSig, unsigned int splitIdx) {
-  Update(splitSig->ArgMax(splitIdx, info));
+void SSNode::ArgMax(const SplitSig *splitSig, unsigned int posStart, unsigned int posEnd) {
+  Update(splitSig->ArgMax(posStart, posEnd, info));
 }
 
 
 /**
-   @brief Walks predictors associated with a given split index to find which,
+   @brief Walks the pairs scheduled for a given split index to find which,
    if any, maximizes information gain above split's threshold.
 
-   @param levelIdx is the current split index.
+   @param posStart is the schedule position of the node's first pair.
+
+   @param posEnd is the position beyond the node's last pair.
 
    @param gainMax begins as the minimal information gain suitable for spltting this
    index node.
 
    @return node containing arg-max, if any.
  */
-SSNode *SplitSig::ArgMax(unsigned int levelIdx, double gainMax) const {
+SSNode *SplitSig::ArgMax(unsigned int posStart, unsigned int posEnd, double gainMax) const {
   SSNode *argMax = 0;
 
   // TODO: Break ties nondeterministically.
   //
-  unsigned int predOff = levelIdx;
-  for (unsigned int predIdx = 0; predIdx < nPred; predIdx++, predOff += splitCount) {
-    SSNode *candSS = &levelSS[predOff];
-    if (candSS->Info() > gainMax) {
+  // Pairs need not be scheduled in predictor order, so ties resolve
+  // explicitly to the lowest predictor.
+  for (unsigned int splitPos = posStart; splitPos < posEnd; splitPos++) {
+    SSNode *candSS = &levelSS[splitPos];
+    if (candSS->Info() > gainMax || (argMax != 0 && candSS->Info() == gainMax && candSS->predIdx < argMax->predIdx)) {
       argMax = candSS;
       gainMax = candSS->Info();
     }
@@ -217,13 +195,13 @@ SSNode *SplitSig::ArgMax(unsigned int levelIdx, double gainMax) const {
  @brief Allocates level's splitting signatures and initializes 'info'
  content to zero.
 
- @param _splitCount is the number of splits in the current level.
+ @param _pairCount is the number of pairs scheduled for splitting.
 
  @return void.
 */
-void SplitSig::LevelInit(unsigned int _splitCount) {
-  splitCount = _splitCount;
-  levelSS = new SSNode[nPred * splitCount];
+void SplitSig::LevelInit(unsigned int _pairCount) {
+  pairCount = _pairCount;
+  levelSS = new SSNode[pairCount];
 }
 
 
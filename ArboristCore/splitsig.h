@@ -84,10 +84,8 @@ class SSNode {
   RankRange rankRange; // Numeric only.
   unsigned int lhImplicit; // LHS implicit index count:  numeric only.
   unsigned char bufIdx;
-  
-  static double minRatio;
 
-  void ArgMax(const class SplitSig *splitSig, unsigned int splitIdx);
+  void ArgMax(const class SplitSig *splitSig, unsigned int posStart, unsigned int posEnd);
   
   // Ideally, there would be SplitSigFac and SplitSigNum subclasses, with
   // Replay() and NonTerminal() methods implemented virtually.  Coprocessor
@@ -112,9 +110,11 @@ class SSNode {
   /**
    @brief Derives an information threshold.
 
+   @param minRatio is the job's threshold ratio.
+
    @return information threshold
   */
-  double inline MinInfo() const {
+  double inline MinInfo(double minRatio) const {
     return minRatio * info;
   }
 
@@ -151,44 +151,38 @@ class SSNode {
 
 /**
   @brief SplitSigs manage the SSNodes for a given level instantation.
+  Only scheduled pairs are represented, so that the workspace scales
+  with the splitting schedule rather than with the level's width times
+  the predictor count.
 */
 class SplitSig {
-  const unsigned int nPred;
-  unsigned int splitCount;
+  unsigned int pairCount;
   SSNode *levelSS; // Workspace records for the current level.
 
   
   /**
      @brief Looks up the SplitSig associated with a given pair.
 
-     SplitSigs are stored with split number as the fastest-varying
-     index.  The likelihood of false sharing during splitting is
-     fairly low, given that predictor selection is probabalistic
-     and splitting workloads themselves are nonuniform.  Nonetheless,
-     predictor-specific references are kept fairly far apart.
+     SplitSigs are stored in schedule order, so that a node's pairs are
+     contiguous.
 
-     @param splitIdx is the split index.
-
-     @param predIdx is the predictor index.
+     @param splitPos is the pair's position in the splitting schedule.
 
      @return pointer to looked-up SplitSig.
    */
-  inline SSNode &Lookup(unsigned int splitIdx, unsigned int predIdx = 0) {
-    return levelSS[predIdx * splitCount + splitIdx];
+  inline SSNode &Lookup(unsigned int splitPos) {
+    return levelSS[splitPos];
   }
 
 
  public:
- SplitSig(unsigned int _nPred) : nPred(_nPred), splitCount(0), levelSS(0) {
+ SplitSig() : pairCount(0), levelSS(0) {
   }
 
-  static void Immutables(double _minRatio);
-  static void DeImmutables();
-
-  SSNode *ArgMax(unsigned int levelIdx, double gainMax) const;
-  void LevelInit(unsigned int _splitCount);
+  SSNode *ArgMax(unsigned int posStart, unsigned int posEnd, double gainMax) const;
+  void LevelInit(unsigned int _pairCount);
   void LevelClear();
-  void Write(unsigned int _splitIdx, unsigned int _predIdx, unsigned int _setPos, unsigned int _bufIdx, const NuxLH &nux);
+  void Write(unsigned int _splitPos, unsigned int _predIdx, unsigned int _setPos, unsigned int _bufIdx, const NuxLH &nux);
 };
 
 #endif
@@ -26,115 +26,93 @@
 #include "response.h"
 #include "splitpred.h"
 #include "leaf.h"
+#include "context.h"
 
 #include <algorithm>
 // Testing only:
 //#include <iostream>
 //using namespace std;
 
-unsigned int Train::trainBlock = 0;
-
-
 /**
-   @brief Initializes immutable values for "top-level" classes directly,
-   for those instances in which static initialization seems to make
-   more sense.  These may, in turn, initialize subclasses or classes
-   with objects strictly local to them.
+   @brief Regression constructor.
+ */
+Train::Train(TrainContext &_trainCtx, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const PMTrain *pmTrain, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits) : trainCtx(_trainCtx), trainBlock(trainCtx.TrainBlock()), nTree(_origin.size()), forest(new ForestTrain(_forestNode, _origin, _facOrigin, _facSplit)), predInfo(_predInfo), response(Response::FactoryReg(trainCtx, _y, _row2Rank, pmTrain, _leafOrigin, _leafNode, _bagRow, _bagBits)) {
+}
 
-   @param minNode is the minimal index node size on which to split.
 
-   @param minRatio is a threshold ratio for determining whether to split.
+/**
+   @brief Static entry for regression training.
 
-   @param totLevels, if positive, limits the number of levels to build.
+   @param trainCtx is the job's configuration.  Jobs with distinct
+   contexts may train concurrently.
 
-   @return void.
+   @return forest height, with output reference parameter.
 */
-void Train::Init(unsigned int _nPred, unsigned int _nTree, unsigned int _nSamp, const std::vector<double> &_feSampleWeight, bool _withRepl, unsigned int _trainBlock, unsigned int _minNode, double _minRatio, unsigned int _totLevels, unsigned int _ctgWidth, unsigned int _predFixed, const double _splitQuant[], const double _predProb[], bool _thinLeaves, const double _regMono[]) {
-  trainBlock = _trainBlock;
-  Sample::Immutables(_nSamp, _feSampleWeight, _withRepl, _ctgWidth, _nTree);
-  SPNode::Immutables(_ctgWidth);
-  SplitSig::Immutables(_minRatio);
-  IndexLevel::Immutables(_minNode, _totLevels);
-  Leaf::Immutables(_thinLeaves);
-  PreTree::Immutables(_nSamp, _minNode);
-  SplitPred::Immutables(_nPred, _ctgWidth, _predFixed, _predProb, _regMono);
-  ForestNode::Immutables(_splitQuant);
+void Train::Regression(TrainContext &_trainCtx, const unsigned int _feRow[], const unsigned int _feRank[], const unsigned int _numOff[], const double _numVal[], const unsigned int _feRLE[], unsigned int _feRLELength, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, const std::vector<unsigned int> &_feCard, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, double _autoCompress, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits) {
+  PMTrain *pmTrain = new PMTrain(_feCard, _predInfo.size(), _y.size());
+  RowRank *rowRank = new RowRank(pmTrain, _feRow, _feRank, _numOff, _numVal, _feRLE, _feRLELength, _autoCompress, _trainCtx.BinMax(), _trainCtx.SpillDir());
+  Regression(_trainCtx, pmTrain, rowRank, _y, _row2Rank, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits);
+
+  delete rowRank;
+  delete pmTrain;
 }
 
 
 /**
-   @brief Unsets immutables.
+   @brief Regression entry over a RowRank built by the caller.  As
+   training only reads 'rowRank', jobs with distinct contexts may share
+   it, training concurrently.  Histogram binning is fixed when 'rowRank'
+   is built, irrespective of the context's bin limit.
 
-   @return void.
-*/
-void Train::DeImmutables() {
-  trainBlock = 0;
-  ForestNode::DeImmutables();
-  SplitSig::DeImmutables();
-  IndexLevel::DeImmutables();
-  Leaf::DeImmutables();
-  PreTree::DeImmutables();
-  Sample::DeImmutables();
-  SPNode::DeImmutables();
-  SplitPred::DeImmutables();
+   @param pmTrain describes the predictors ranked by 'rowRank'.
+
+   @return void, with output reference parameters.
+ */
+void Train::Regression(TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits) {
+  Train *train = new Train(_trainCtx, _y, _row2Rank, _pmTrain, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits);
+  train->TrainForest(_pmTrain, _rowRank);
+
+  delete train;
 }
 
 
 /**
-   @brief Regression constructor.
+   @brief Classification constructor.
  */
-Train::Train(const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, const PMTrain *pmTrain, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits) : nTree(_origin.size()), forest(new ForestTrain(_forestNode, _origin, _facOrigin, _facSplit)), predInfo(_predInfo), response(Response::FactoryReg(_y, _row2Rank, pmTrain, _leafOrigin, _leafNode, _bagRow, _bagBits)) {
+Train::Train(TrainContext &_trainCtx, const std::vector<unsigned int> &_yCtg, unsigned int _ctgWidth, const std::vector<double> &_yProxy, const PMTrain *pmTrain, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits, std::vector<double> &_weight) : trainCtx(_trainCtx), trainBlock(trainCtx.TrainBlock()), nTree(_origin.size()), forest(new ForestTrain(_forestNode, _origin, _facOrigin, _facSplit)), predInfo(_predInfo), response(Response::FactoryCtg(trainCtx, _yCtg, _yProxy, pmTrain, _leafOrigin, _leafNode, _bagRow, _bagBits, _weight, _ctgWidth)) {
 }
 
 
 /**
-   @brief Static entry for regression training.
+   @brief Static entry for classification training.
 
-   @param trainBlock is the maximum number of trees trainable simultaneously.
+   @param trainCtx is the job's configuration.
 
-   @param minNode is the mininal number of sample indices represented by a tree node.
-
-   @param minRatio is the minimum information ratio of a node to its parent.
-
-   @return forest height, with output reference parameter.
+   @return void.
 */
-void Train::Regression(const unsigned int _feRow[], const unsigned int _feRank[], const unsigned int _numOff[], const double _numVal[], const unsigned int _feRLE[], unsigned int _feRLELength, const std::vector<double> &_y, const std::vector<unsigned int> &_row2Rank, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, const std::vector<unsigned int> &_feCard, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, double _autoCompress, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits) {
-  PMTrain *pmTrain = new PMTrain(_feCard, _predInfo.size(), _y.size());
-  Train *train = new Train(_y, _row2Rank, pmTrain, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits);
-
-  RowRank *rowRank = new RowRank(pmTrain, _feRow, _feRank, _numOff, _numVal, _feRLE, _feRLELength, _autoCompress);
-  train->TrainForest(pmTrain, rowRank);
+void Train::Classification(TrainContext &_trainCtx, const unsigned int _feRow[], const unsigned int _feRank[], const unsigned int _numOff[], const double _numVal[], const unsigned int _feRLE[], unsigned int _rleLength, const std::vector<unsigned int>  &_yCtg, unsigned int _ctgWidth, const std::vector<double> &_yProxy, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, const std::vector<unsigned int> &_feCard, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, double _autoCompress, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits, std::vector<double> &_weight) {
+  PMTrain *pmTrain = new PMTrain(_feCard, _predInfo.size(), _yCtg.size());
+  RowRank *rowRank = new RowRank(pmTrain, _feRow, _feRank, _numOff, _numVal, _feRLE, _rleLength, _autoCompress, _trainCtx.BinMax(), _trainCtx.SpillDir());
+  Classification(_trainCtx, pmTrain, rowRank, _yCtg, _ctgWidth, _yProxy, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits, _weight);
 
   delete rowRank;
-  delete train;
   delete pmTrain;
-  DeImmutables();
-}
-
-
-/**
-   @brief Classification constructor.
- */
-Train::Train(const std::vector<unsigned int> &_yCtg, unsigned int _ctgWidth, const std::vector<double> &_yProxy, const PMTrain *pmTrain, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits, std::vector<double> &_weight) : nTree(_origin.size()), forest(new ForestTrain(_forestNode, _origin, _facOrigin, _facSplit)), predInfo(_predInfo), response(Response::FactoryCtg(_yCtg, _yProxy, pmTrain, _leafOrigin, _leafNode, _bagRow, _bagBits, _weight, _ctgWidth)) {
 }
 
 
 /**
-   @brief Static entry for regression training.
+   @brief Classification entry over a RowRank built, and possibly shared,
+   by the caller.
 
-   @return void.
-*/
-void Train::Classification(const unsigned int _feRow[], const unsigned int _feRank[], const unsigned int _numOff[], const double _numVal[], const unsigned int _feRLE[], unsigned int _rleLength, const std::vector<unsigned int>  &_yCtg, unsigned int _ctgWidth, const std::vector<double> &_yProxy, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, const std::vector<unsigned int> &_feCard, std::vector<class ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<class LeafNode> &_leafNode, double _autoCompress, std::vector<class BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits, std::vector<double> &_weight) {
-  PMTrain *pmTrain = new PMTrain(_feCard, _predInfo.size(), _yCtg.size());
-  Train *train = new Train(_yCtg, _ctgWidth, _yProxy, pmTrain, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits, _weight);
+   @param pmTrain describes the predictors ranked by 'rowRank'.
 
-  RowRank *rowRank = new RowRank(pmTrain, _feRow, _feRank, _numOff, _numVal, _feRLE, _rleLength, _autoCompress);
-  train->TrainForest(pmTrain, rowRank);
+   @return void, with output reference parameters.
+ */
+void Train::Classification(TrainContext &_trainCtx, const PMTrain *_pmTrain, const RowRank *_rowRank, const std::vector<unsigned int>  &_yCtg, unsigned int _ctgWidth, const std::vector<double> &_yProxy, std::vector<unsigned int> &_origin, std::vector<unsigned int> &_facOrigin, std::vector<double> &_predInfo, std::vector<ForestNode> &_forestNode, std::vector<unsigned int> &_facSplit, std::vector<unsigned int> &_leafOrigin, std::vector<LeafNode> &_leafNode, std::vector<BagLeaf> &_bagRow, std::vector<unsigned int> &_bagBits, std::vector<double> &_weight) {
+  Train *train = new Train(_trainCtx, _yCtg, _ctgWidth, _yProxy, _pmTrain, _origin, _facOrigin, _predInfo, _forestNode, _facSplit, _leafOrigin, _leafNode, _bagRow, _bagBits, _weight);
+  train->TrainForest(_pmTrain, _rowRank);
 
-  delete rowRank;
   delete train;
-  delete pmTrain;
-  DeImmutables();
 }
 
 
@@ -147,8 +125,6 @@ Train::~Train() {
 /**
   @brief Trains the requisite number of trees.
 
-  @param trainBlock is the maximum Count of trees to train en block.
-
   @return void.
 */
 void Train::TrainForest(const PMTrain *pmTrain, const RowRank *rowRank) {
@@ -163,7 +139,7 @@ void Train::TrainForest(const PMTrain *pmTrain, const RowRank *rowRank) {
     predInfo[i] *= recipNTree;
   }
 
-  forest->SplitUpdate(pmTrain, rowRank);
+  forest->SplitUpdate(pmTrain, rowRank, trainCtx.SplitQuant());
 }
 
 
@@ -172,7 +148,10 @@ void Train::TrainForest(const PMTrain *pmTrain, const RowRank *rowRank) {
    @param tEnd is one 
  */
 void Train::Block(const RowRank *rowRank, unsigned int tStart, unsigned int tCount) {
-  PreTree **ptBlock = response->BlockTree(rowRank, tCount);
+  std::vector<TrainStat> statBlock;
+  PreTree **ptBlock = response->BlockTree(rowRank, tStart, tCount, statBlock);
+  for (auto & treeStat : statBlock)
+    trainCtx.StatAccum(treeStat);
   if (tStart == 0)
     Reserve(ptBlock, tCount);
 
@@ -195,7 +174,7 @@ void Train::Reserve(PreTree **ptBlock, unsigned int tCount) {
   unsigned int blockFac, blockBag, blockLeaf;
   unsigned int maxHeight = 0;
   unsigned int blockHeight = BlockPeek(ptBlock, tCount, blockFac, blockBag, blockLeaf, maxHeight);
-  PreTree::Reserve(maxHeight);
+  trainCtx.HeightReserve(maxHeight);
 
   double slop = (slopFactor * nTree) / trainBlock;
   forest->Reserve(blockHeight, blockFac, slop);
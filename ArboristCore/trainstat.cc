@@ -0,0 +1,80 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file trainstat.cc
+
+   @brief Methods for accumulating level-loop instrumentation.
+
+   @author Mark Seligman
+ */
+
+#include "trainstat.h"
+
+//#include <iostream>
+//using namespace std;
+
+const char *TrainStat::phaseName[TrainStat::phaseCount] = {
+  "flushRear",
+  "backdate",
+  "restage",
+  "scheduleSplits",
+  "split",
+  "argMax",
+  "consume",
+  "reindex",
+  "produce"
+};
+
+
+/**
+   @brief Constructor.  Opens the root level.
+ */
+TrainStat::TrainStat() : levelCount(std::vector<LevelCount>(1)), levelIdx(0), phaseTime(std::vector<double>(phaseCount)), phaseCalls(std::vector<unsigned long>(phaseCount)) {
+}
+
+
+/**
+   @brief Advances to the next level, extending the census as needed.
+
+   @return void.
+ */
+void TrainStat::LevelNext() {
+  if (++levelIdx == levelCount.size())
+    levelCount.push_back(LevelCount());
+}
+
+
+/**
+   @brief Merges another accumulation into this one, level by level.
+
+   @param other is typically a completed tree's accumulation.
+
+   @return void.
+ */
+void TrainStat::Accum(const TrainStat &other) {
+  for (unsigned int phase = 0; phase < phaseCount; phase++) {
+    phaseTime[phase] += other.phaseTime[phase];
+    phaseCalls[phase] += other.phaseCalls[phase];
+  }
+
+  if (other.levelCount.size() > levelCount.size())
+    levelCount.resize(other.levelCount.size());
+  for (unsigned int level = 0; level < other.levelCount.size(); level++) {
+    levelCount[level].Accum(other.levelCount[level]);
+  }
+}
+
+
+void LevelCount::Accum(const LevelCount &other) {
+  splitCoord += other.splitCoord;
+  restaged += other.restaged;
+  cellDense += other.cellDense;
+  cellSparse += other.cellSparse;
+  nodeRel += other.nodeRel;
+  chunked += other.chunked;
+}
@@ -0,0 +1,109 @@
+// This file is part of ArboristCore.
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+   @file trainstat.h
+
+   @brief Timings and counters gathered by the level loop.
+
+   @author Mark Seligman
+
+ */
+
+#ifndef ARBORIST_TRAINSTAT_H
+#define ARBORIST_TRAINSTAT_H
+
+#include <chrono>
+#include <vector>
+
+/**
+   @brief Per-level census, summed over trees.
+ */
+class LevelCount {
+ public:
+  unsigned long splitCoord; // Pairs scheduled for splitting.
+  unsigned long restaged; // Pairs restaged.
+  unsigned long cellDense; // Scheduled pairs with an implicit component.
+  unsigned long cellSparse; // Scheduled pairs fully explicit.
+  unsigned long nodeRel; // Trees employing node-relative indexing.
+  unsigned long chunked; // Restaged pairs divided among threads.
+
+  LevelCount() : splitCoord(0), restaged(0), cellDense(0), cellSparse(0), nodeRel(0), chunked(0) {}
+
+  void Accum(const LevelCount &other);
+};
+
+
+/**
+   @brief Wall time and call counts, by phase, together with a per-level
+   census.  Accumulated separately by each tree, then merged into the
+   training context.
+ */
+class TrainStat {
+  std::vector<LevelCount> levelCount;
+  unsigned int levelIdx; // Current level, tree-relative.
+
+ public:
+  typedef std::chrono::steady_clock::time_point Clock;
+
+  enum Phase {
+    flushRear,
+    backdate,
+    restage,
+    scheduleSplits,
+    split,
+    argMax,
+    consume,
+    reindex,
+    produce,
+    phaseCount
+  };
+
+  static const char *phaseName[phaseCount];
+
+  std::vector<double> phaseTime; // Seconds, by phase.
+  std::vector<unsigned long> phaseCalls;
+
+  TrainStat();
+
+  void Accum(const TrainStat &other);
+  void LevelNext();
+
+
+  /**
+     @brief Stamps the start of a timed phase.
+   */
+  static inline Clock Now() {
+    return std::chrono::steady_clock::now();
+  }
+
+
+  /**
+     @brief Charges time elapsed since 'start' to a phase.
+
+     @return void.
+   */
+  inline void Accum(Phase phase, const Clock &start) {
+    phaseTime[phase] += std::chrono::duration<double>(Now() - start).count();
+    phaseCalls[phase]++;
+  }
+
+
+  /**
+     @return census for the level currently under construction.
+   */
+  inline LevelCount &Front() {
+    return levelCount[levelIdx];
+  }
+
+
+  inline const std::vector<LevelCount> &Levels() const {
+    return levelCount;
+  }
+};
+
+#endif